@@ -11,24 +11,122 @@
 #include "Bitmap.h"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace Util {
 
+static uint8_t * allocateData(size_t size) {
+	return static_cast<uint8_t *>(::operator new(size, std::align_val_t(Bitmap::DATA_ALIGNMENT)));
+}
+
+static void freeData(uint8_t * data) {
+	::operator delete(data, std::align_val_t(Bitmap::DATA_ALIGNMENT));
+}
+
+//! Owner of the pixel data of a bitmap.
+struct Bitmap::Storage {
+	uint8_t * data = nullptr;
+	std::vector<uint8_t> vector;	//!< Holds the data if it was taken over by swapData
+	ReleaseFn_t release;
+
+	Storage(uint8_t * _data, ReleaseFn_t _release) : data(_data), release(std::move(_release)) {}
+	~Storage() {
+		if(release)
+			release(data);
+	}
+};
+
+//! Return the pitch for the given pitch (0: packed rows), or throw if it is invalid.
+static uint64_t checkPitch(uint32_t width, const AttributeFormat & pixelFormat, uint64_t pitch) {
+	const uint64_t rowSize = static_cast<uint64_t>(width) * pixelFormat.getDataSize();
+	if(pitch == 0)
+		return rowSize;
+	if(pitch < rowSize || (pixelFormat.getDataSize() > 0 && pitch % pixelFormat.getDataSize() != 0))
+		throw std::invalid_argument("Bitmap: Invalid pitch " + std::to_string(pitch) + " for rows of " + std::to_string(rowSize) + " bytes.");
+	return pitch;
+}
+
+//! Return the number of bytes from the first to the last pixel.
+static size_t getDataSpan(uint32_t width, uint32_t height, const AttributeFormat & pixelFormat, uint64_t pitch) {
+	return height == 0 ? 0 : static_cast<size_t>((height - 1) * pitch + static_cast<uint64_t>(width) * pixelFormat.getDataSize());
+}
+
 Bitmap::Bitmap(const uint32_t _width,const uint32_t _height,AttributeFormat _pixelFormat) :
-		pixelFormat(std::move(_pixelFormat)), width(_width), height(_height), pixelData(pixelFormat.getDataSize() * width * height) {
+		pixelFormat(std::move(_pixelFormat)), width(_width), height(_height), pitch(static_cast<uint64_t>(width) * pixelFormat.getDataSize()),
+		pixelData(nullptr), dataSize(0) {
+	const size_t size = getDataSpan(width, height, pixelFormat, pitch);
+	setStorage(allocateData(size), size, freeData);
+	std::fill_n(pixelData, dataSize, 0);
 }
 
 Bitmap::Bitmap(const uint32_t _width,const uint32_t _height,size_t rawDataSize) :
-		pixelFormat(PixelFormat::UNKNOWN), width(_width), height(_height), pixelData(rawDataSize) {
+		pixelFormat(PixelFormat::UNKNOWN), width(_width), height(_height), pitch(0), pixelData(nullptr), dataSize(0) {
+	setStorage(allocateData(rawDataSize), rawDataSize, freeData);
+	std::fill_n(pixelData, dataSize, 0);
 }
 
 Bitmap::Bitmap(const Bitmap & source) :
 		ReferenceCounter_t(),
-		pixelFormat(source.pixelFormat), width(source.width), height(source.height),
-		pixelData(source.pixelData) {
+		pixelFormat(source.pixelFormat), width(source.width), height(source.height), pitch(source.pitch),
+		pixelData(nullptr), dataSize(0) {
+	if(source.pixelFormat.getDataSize() == 0) { // raw data
+		setStorage(allocateData(source.dataSize), source.dataSize, freeData);
+		std::copy_n(source.pixelData, dataSize, pixelData);
+		return;
+	}
+	pitch = static_cast<uint64_t>(width) * pixelFormat.getDataSize();
+	const size_t size = getDataSpan(width, height, pixelFormat, pitch);
+	setStorage(allocateData(size), size, freeData);
+	if(source.isPacked()) {
+		std::copy_n(source.pixelData, dataSize, pixelData);
+	} else {
+		for(uint32_t y = 0; y < height; ++y)
+			std::copy_n(source.pixelData + y * source.pitch, pitch, pixelData + y * pitch);
+	}
+}
+
+Bitmap::Bitmap(const uint32_t _width,const uint32_t _height,AttributeFormat _pixelFormat,uint64_t _pitch,uint8_t * data,std::shared_ptr<Storage> _storage) :
+		pixelFormat(std::move(_pixelFormat)), width(_width), height(_height), pitch(_pitch),
+		pixelData(data), dataSize(getDataSpan(width, height, pixelFormat, pitch)), storage(std::move(_storage)) {
+}
+
+Bitmap::~Bitmap() = default;
+
+Reference<Bitmap> Bitmap::createUninitialized(uint32_t width, uint32_t height, const AttributeFormat & pixelFormat, uint64_t pitch) {
+	pitch = checkPitch(width, pixelFormat, pitch);
+	// the padding of the last row is allocated as well, so that all rows can be processed alike
+	uint8_t * data = allocateData(pitch * height);
+	return new Bitmap(width, height, pixelFormat, pitch, data, std::make_shared<Storage>(data, freeData));
+}
+
+Reference<Bitmap> Bitmap::createFromData(uint32_t width, uint32_t height, const AttributeFormat & pixelFormat,
+										 uint8_t * data, uint64_t pitch, ReleaseFn_t release) {
+	return new Bitmap(width, height, pixelFormat, checkPitch(width, pixelFormat, pitch), data, std::make_shared<Storage>(data, std::move(release)));
+}
+
+Reference<Bitmap> Bitmap::createView(uint32_t x, uint32_t y, uint32_t viewWidth, uint32_t viewHeight) {
+	const uint64_t pixelSize = pixelFormat.getDataSize();
+	if(pixelSize == 0)
+		throw std::invalid_argument("Bitmap::createView: Bitmap contains only raw data.");
+	if(static_cast<uint64_t>(x) + viewWidth > width || static_cast<uint64_t>(y) + viewHeight > height)
+		throw std::range_error("Bitmap::createView: Rectangle (" + std::to_string(x) + ", " + std::to_string(y) + ", " +
+				std::to_string(viewWidth) + ", " + std::to_string(viewHeight) + ") exceeds bitmap of size " +
+				std::to_string(width) + "x" + std::to_string(height) + ".");
+	Reference<Bitmap> view = new Bitmap(viewWidth, viewHeight, pixelFormat, pitch, pixelData + y * pitch + x * pixelSize, storage);
+	view->parent = this;
+	return view;
+}
+
+void Bitmap::setStorage(uint8_t * newData,size_t newDataSize,ReleaseFn_t newRelease) {
+	storage = std::make_shared<Storage>(newData, std::move(newRelease));
+	pixelData = newData;
+	dataSize = newDataSize;
 }
 
 void Bitmap::swap(Bitmap & other){
@@ -36,37 +134,52 @@ void Bitmap::swap(Bitmap & other){
 	swap(pixelFormat, other.pixelFormat);
 	swap(width, other.width);
 	swap(height, other.height);
+	swap(pitch, other.pitch);
 	swap(pixelData, other.pixelData);
+	swap(dataSize, other.dataSize);
+	swap(storage, other.storage);
+	swap(parent, other.parent);
 }
 
 void Bitmap::setData(const std::vector<uint8_t> & newData) {
-	if(newData.size() != pixelData.size()) 
+	if(newData.size() != dataSize) 
 		throw std::invalid_argument("Bitmap::setData: Sizes differ.");
-	pixelData = newData;
+	if(isPacked()) {
+		std::copy(newData.begin(), newData.end(), pixelData);
+	} else {
+		const uint64_t rowDataSize = static_cast<uint64_t>(width) * pixelFormat.getDataSize();
+		for(uint32_t y = 0; y < height; ++y)
+			std::copy_n(newData.data() + y * pitch, rowDataSize, pixelData + y * pitch);
+	}
 }
 void Bitmap::swapData(std::vector<uint8_t> & other) {
-	if(other.size() != pixelData.size()) 
+	if(other.size() != dataSize) 
 		throw std::invalid_argument("Bitmap::swapData: Sizes differ.");
-	using std::swap;
-	swap( other, pixelData);
+	// a view or a bitmap with views shares its storage; replacing it would detach the views
+	if(parent.isNotNull() || storage.use_count() > 1 || !isPacked()) {
+		const uint64_t rowDataSize = static_cast<uint64_t>(width) * pixelFormat.getDataSize();
+		for(uint32_t y = 0; y < height; ++y)
+			std::swap_ranges(pixelData + y * pitch, pixelData + y * pitch + rowDataSize, other.data() + y * pitch);
+		return;
+	}
+	if(!storage->release && storage->vector.data() == pixelData && storage->vector.size() == dataSize) {
+		// the data was taken over from a vector as well: exchange the vectors
+		storage->vector.swap(other);
+	} else {
+		auto newStorage = std::make_shared<Storage>(nullptr, nullptr);
+		newStorage->vector = std::move(other);
+		other.assign(pixelData, pixelData + dataSize);
+		storage = std::move(newStorage);
+	}
+	storage->data = pixelData = storage->vector.data();
 }
 
 void Bitmap::flipVertically() {
-	if(pixelData.empty()) 
-		return;
-
-	std::vector<uint8_t> temp(pixelData.size());
-	const uint8_t * src = pixelData.data();
-	uint8_t * dst = temp.data();
-	const uint64_t rowDataSize( width*pixelFormat.getDataSize() );
-
-	for(int32_t y = (height - 1); y >= 0; --y) {
-		const uint8_t * rowBegin = src + y * rowDataSize;
-		std::copy(rowBegin, rowBegin + rowDataSize, dst);
-		dst += rowDataSize;
+	const uint64_t rowDataSize( static_cast<uint64_t>(width)*pixelFormat.getDataSize() );
+	for(uint32_t y = 0; y < height / 2; ++y) {
+		uint8_t * row = pixelData + y * pitch;
+		std::swap_ranges(row, row + rowDataSize, pixelData + (height - 1 - y) * pitch);
 	}
-	using std::swap;
-	swap(pixelData, temp);
 }
 
 }
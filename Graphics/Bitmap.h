@@ -13,8 +13,11 @@
 
 #include "PixelFormat.h"
 #include "../ReferenceCounter.h"
+#include "../References.h"
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 
 //! @defgroup graphics Graphics
@@ -35,21 +38,60 @@ namespace Util {
 	(0,height)            (width,height)
 
 	\note the coordinates are the same as for SDL Surfaces, but not for OpenGl Textures!
+
+	Storage:
+	The rows of the bitmap are stored one after another, @p getPitch bytes apart. The pitch may be larger than the size of
+	a row (e.g., for aligned rows), but it is always a multiple of the pixel size.
+	The pixel data is either allocated by the bitmap (aligned to DATA_ALIGNMENT bytes), adopted from external memory
+	(see @p createFromData), which is released through a callback, or taken over from a vector (see @p swapData).
+	Views (see @p createView) share the ownership of the pixel data, so it is only released when the bitmap and all its views are gone.
 	@ingroup graphics
 */
 class Bitmap : public ReferenceCounter<Bitmap> {
 	public:
-		//! Create a new bitmap.
+		//! Called with the pixel data when the bitmap does not use external pixel data anymore (see @p createFromData).
+		using ReleaseFn_t = std::function<void (uint8_t *)>;
+
+		//! Alignment of the pixel data allocated by a bitmap (in bytes).
+		static const size_t DATA_ALIGNMENT = 64;
+
+		//! Create a new bitmap. The pixel data is initialized with zeros.
 		UTILAPI explicit Bitmap(const uint32_t width=0,const uint32_t height=0,AttributeFormat pixelFormat = PixelFormat::RGBA);
 
 		/*! Create a new bitmap which containing only raw data. A direct pixel access is not possible.
 			\note This can e.g. be used to store compressed textures */
 		UTILAPI Bitmap(const uint32_t width,const uint32_t height,size_t rawDataSize);
 
-		//! Create a copy of the bitmap together with its data.
+		//! Create a copy of the bitmap together with its data. The rows of the copy are packed (also for views).
 		UTILAPI explicit Bitmap(const Bitmap & source);
 
-		//! Swap all the data with another bitmap
+		UTILAPI ~Bitmap();
+
+		/*! Create a new bitmap without initializing its pixel data (e.g., for decoders, which overwrite every byte anyway).
+			@param pitch Number of bytes per row (0: width * pixel size). It has to be a multiple of the pixel size.
+			@throw std::invalid_argument if the pitch is invalid. */
+		UTILAPI static Reference<Bitmap> createUninitialized(uint32_t width, uint32_t height, const AttributeFormat & pixelFormat, uint64_t pitch=0);
+
+		/*! Create a bitmap that uses the given pixel data without copying it (e.g., the output of a decoder or a mapped file).
+			@param data The first pixel. The data has to span at least (height-1) * pitch + width * pixel size bytes.
+			@param pitch Number of bytes per row (0: width * pixel size). It has to be a multiple of the pixel size.
+			@param release Called with @p data when the bitmap is destroyed or its data is replaced.
+				If it is empty, the data is not released and has to outlive the bitmap.
+			@throw std::invalid_argument if the pitch is invalid. */
+		UTILAPI static Reference<Bitmap> createFromData(uint32_t width, uint32_t height, const AttributeFormat & pixelFormat,
+														uint8_t * data, uint64_t pitch=0, ReleaseFn_t release=nullptr);
+
+		/*! Create a bitmap that refers to the rectangle [x, x+width) x [y, y+height) of this bitmap without copying the pixels.
+			The view can be read, written and passed to BitmapUtils or the streamers like any other bitmap.
+			@note The bitmap has to be managed by a Reference, as the view keeps a reference to it.
+			@throw std::range_error if the rectangle is not contained in this bitmap.
+			@throw std::invalid_argument if the bitmap only contains raw data. */
+		UTILAPI Reference<Bitmap> createView(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+		//! Return the bitmap whose pixel data is used by this view, or nullptr if this bitmap is no view.
+		Bitmap * getParent() const 					{	return parent.get();	}
+
+		//! Swap all the data with another bitmap. Existing views keep referring to the pixel data they were created for.
 		UTILAPI void swap(Bitmap & other);
 
 		uint32_t getWidth() const 					{	return width;	}
@@ -57,34 +99,62 @@ class Bitmap : public ReferenceCounter<Bitmap> {
 
 		const AttributeFormat & getPixelFormat()const	{	return pixelFormat;		}
 
-		//!	Return the number of bytes that are allocated by this Bitmap or that will be allocated.
-		size_t getDataSize() const 					{	return pixelData.size();	}
+		//! Return the number of bytes between the first pixels of two consecutive rows.
+		uint64_t getPitch() const 					{	return pitch;	}
+
+		//! Return true if the rows are stored without padding, i.e., all pixels are stored consecutively.
+		bool isPacked() const 						{	return pitch == static_cast<uint64_t>(width) * pixelFormat.getDataSize();	}
+
+		/*!	Return the number of bytes that are allocated by this Bitmap or that will be allocated.
+			For bitmaps with padded rows, this is the size from the first to the last pixel. */
+		size_t getDataSize() const 					{	return dataSize;	}
 
 		//! Access the data of the bitmap.
-		uint8_t * data()							{	return pixelData.data();	}
+		uint8_t * data()							{	return pixelData;	}
 
 		//! Access the data of the bitmap.
-		const uint8_t * data() const				{	return pixelData.data();	}
+		const uint8_t * data() const				{	return pixelData;	}
 
 		/**
 		 * Overwrite the current data with the given data.
 		 * 
 		 * @param newData Data that will be copied to the internal data storage
 		 * @note The new data must have the same size as the existing data.
+		 *	For bitmaps with padded rows (e.g., views), only the pixels are copied and the padding is left untouched.
 		 */
 		UTILAPI void setData(const std::vector<uint8_t> & newData);
+
+		/**
+		 * Exchange the current data with the given data.
+		 * The bitmap takes over the storage of @p other without copying it. If the previous data was taken over from a vector
+		 * as well, @p other receives that vector without copying; otherwise (allocated or external data), it receives a copy of the previous data.
+		 * For bitmaps with padded rows and for bitmaps that are or have views, the pixels are exchanged by copying,
+		 * so that the views keep referring to the pixels of their parent.
+		 * @note The new data must have the same size as the existing data.
+		 */
 		UTILAPI void swapData(std::vector<uint8_t> & other);
 
 		//!	Swap the rows, so that the bitmap is turned upside down afterwards.
 		UTILAPI void flipVertically();
 
 	private:
+		struct Storage;
+
+		Bitmap(const uint32_t width,const uint32_t height,AttributeFormat pixelFormat,uint64_t pitch,uint8_t * data,std::shared_ptr<Storage> storage);
+
+		//! Replace the pixel data; the previous data is released as soon as no view uses it anymore.
+		void setStorage(uint8_t * newData,size_t newDataSize,ReleaseFn_t newRelease);
+
 		AttributeFormat pixelFormat;
 
 		uint32_t width; 		//!< Horizontal size
 		uint32_t height;		//!< Vertical size
+		uint64_t pitch;			//!< Bytes per row
 
-		std::vector<uint8_t> pixelData;	//!< Storage of bitmap data
+		uint8_t * pixelData;	//!< Storage of bitmap data
+		size_t dataSize;
+		std::shared_ptr<Storage> storage;	//!< Owner of the pixel data (allocated, adopted or taken over from a vector); shared with the views
+		Reference<Bitmap> parent;	//!< Owner of the pixel data of a view
 };
 
 }
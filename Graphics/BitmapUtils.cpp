@@ -11,8 +11,13 @@
 #include "BitmapUtils.h"
 #include "Bitmap.h"
 #include "PixelAccessor.h"
+#include "PixelFormat.h"
 #include "../Macros.h"
+#include "../Parallel.h"
 #include "../References.h"
+#include "../Resources/AttributeAccessor.h"
+#include "../Resources/ResourceConverter.h"
+#include "../Utils.h"
 
 #ifdef UTIL_HAVE_LIB_SDL2
 COMPILER_WARN_PUSH
@@ -21,13 +26,50 @@ COMPILER_WARN_OFF_GCC(-Wswitch-default)
 COMPILER_WARN_POP
 #endif /* UTIL_HAVE_LIB_SDL2 */
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <new>
+#include <numeric>
 #include <stdexcept>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define UTIL_BITMAP_SSE2
+	#include <emmintrin.h>
+	#if defined(__GNUC__) || defined(__clang__)
+		// AVX2 kernels are compiled with a function specific target and selected at runtime.
+		#define UTIL_BITMAP_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
 namespace Util {
 namespace BitmapUtils {
 
+static const uint64_t TILE_PIXELS = 16 * 1024; // pixels per tile; the Color4f values of a tile (256 KiB) should fit into the L2 cache
+static const uint64_t MIN_PARALLEL_PIXELS = 64 * 1024; // minimum number of pixels per thread
+
+//! Returns the number of rows of a tile with about TILE_PIXELS pixels.
+static uint32_t getTileRows(uint32_t width, uint32_t height) {
+	return static_cast<uint32_t>(clamp<uint64_t>(TILE_PIXELS / std::max(width, 1u), 1, std::max(height, 1u)));
+}
+
+/**
+ * Splits the rows [0, height) into tiles (see @p getTileRows) and calls @p fn(tile, firstRow, endRow) for each tile.
+ * The tiles are processed in parallel (in ascending order within each thread); @p fn has to be thread-safe.
+ */
+template<typename Fn>
+static void forEachTile(uint32_t width, uint32_t height, uint32_t threadCount, const Fn& fn) {
+	const uint64_t tileRows = getTileRows(width, height);
+	const uint64_t tileCount = (height + tileRows - 1) / tileRows;
+	const uint64_t grainSize = std::max<uint64_t>(1, MIN_PARALLEL_PIXELS / (tileRows * std::max(width, 1u)));
+	parallelFor(0, tileCount, grainSize, [&](uint64_t firstTile, uint64_t endTile) {
+		for(uint64_t tile = firstTile; tile < endTile; ++tile)
+			fn(tile, static_cast<uint32_t>(tile * tileRows), static_cast<uint32_t>(std::min<uint64_t>(height, (tile + 1) * tileRows)));
+	}, threadCount);
+}
+
 #ifdef UTIL_HAVE_LIB_SDL2
 Reference<Bitmap> createBitmapFromSDLSurface(SDL_Surface * surface) {
 	SDL_PixelFormat * sdlFormat = surface->format;
@@ -124,7 +166,7 @@ SDL_Surface * createSDLSurfaceFromBitmap(const Bitmap & bitmap) {
 	}
 
 	int depth = 8 * f.getBytesPerPixel();
-	int pitch = static_cast<int>(bitmap.getWidth()) * f.getBytesPerPixel();
+	int pitch = static_cast<int>(bitmap.getPitch());
 	return SDL_CreateRGBSurfaceFrom(const_cast<void *>(reinterpret_cast<const void *>(bitmap.data())), 
 									static_cast<int>(bitmap.getWidth()), 
 									static_cast<int>(bitmap.getHeight()), 
@@ -133,7 +175,8 @@ SDL_Surface * createSDLSurfaceFromBitmap(const Bitmap & bitmap) {
 #endif /* UTIL_HAVE_LIB_SDL2 */
 
 Reference<Bitmap> blendTogether(const AttributeFormat & targetFormat, 
-								const std::vector<Reference<Bitmap>> & sources) {
+								const std::vector<Reference<Bitmap>> & sources,
+								uint32_t threadCount) {
 	if(sources.empty()){
 		throw std::invalid_argument("blendTogether: 'sources' may not be empty.");
 	}
@@ -141,32 +184,39 @@ Reference<Bitmap> blendTogether(const AttributeFormat & targetFormat,
 	const uint32_t width = sources.front()->getWidth();
 	const uint32_t height = sources.front()->getHeight();
 
-	std::vector<Color4f> buffer(width*height);
-
-	for(const auto & source : sources) {
-		Reference<PixelAccessor> reader( PixelAccessor::create(source.get()));
-
-		auto pixel = buffer.begin();
-		for(uint32_t y = 0;y<height;++y )
-			for(uint32_t x = 0;x<width;++x )
-				(*(pixel++)) += reader->readColor4f(x,y);
-	}
-
+	std::vector<Reference<PixelAccessor>> readers;
+	for(const auto & source : sources)
+		readers.push_back(PixelAccessor::create(source.get()));
 	Reference<Bitmap> target(new Bitmap(width,height,targetFormat));
-	{
-		const float scale = 1.0f / static_cast<float>(sources.size());
-		Reference<PixelAccessor> writer( PixelAccessor::create(target.get()));
+	Reference<PixelAccessor> writer( PixelAccessor::create(target.get()));
+	const float scale = 1.0f / static_cast<float>(sources.size());
+
+	// the sources are accumulated per tile; each pixel sums up the sources in the same order
+	forEachTile(width, height, threadCount, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+		std::vector<Color4f> buffer(static_cast<size_t>(width) * (endRow - firstRow));
+		std::vector<Color4f> row(width);
+		for(const auto & reader : readers) {
+			auto pixel = buffer.begin();
+			for(uint32_t y = firstRow;y<endRow;++y ) {
+				reader->readRow(y,0,width,row.data());
+				for(uint32_t x = 0;x<width;++x )
+					(*(pixel++)) += row[x];
+			}
+		}
 		auto pixel = buffer.begin();
-		for(uint32_t y = 0;y<height;++y )
+		for(uint32_t y = firstRow;y<endRow;++y ) {
 			for(uint32_t x = 0;x<width;++x )
-				writer->writeColor(x,y,(*(pixel++)) * scale );
-	}
+				row[x] = (*(pixel++)) * scale;
+			writer->writeRow(y,0,width,row.data());
+		}
+	});
 
 	return target;
 }
 
 Reference<Bitmap> combineInterleaved(const AttributeFormat & targetFormat, 
-									 const std::vector<Reference<Bitmap>> & sourceBitmaps) {
+									 const std::vector<Reference<Bitmap>> & sourceBitmaps,
+									 uint32_t threadCount) {
 	if(sourceBitmaps.empty()){
 		throw std::invalid_argument("blendTogether: 'sources' may not be empty.");
 	}
@@ -184,10 +234,18 @@ Reference<Bitmap> combineInterleaved(const AttributeFormat & targetFormat,
 			sources.push_back(PixelAccessor::create(bm.get()));
 		}
 
-		for(uint32_t x = 0; x < width*count; x++)
-			for(uint32_t y = 0; y < height*count; y++){
-				target->writeColor(x,y,sources[(y%count)*count+(x%count)]->readColor4f(x/count,y/count));
+		forEachTile(width*count, height*count, threadCount, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+			std::vector<Color4f> sourceRow(width);
+			std::vector<Color4f> targetRow(static_cast<size_t>(width)*count);
+			for(uint32_t y = firstRow; y < endRow; y++) {
+				for(uint32_t i = 0; i < count; i++) {
+					sources[(y%count)*count+i]->readRow(y/count,0,width,sourceRow.data());
+					for(uint32_t x = 0; x < width; x++)
+						targetRow[x*count+i] = sourceRow[x];
+				}
+				target->writeRow(y,0,width*count,targetRow.data());
 			}
+		});
 	}
 	return targetBitmap;
 }
@@ -197,19 +255,21 @@ Reference<Bitmap> convertBitmap(const Bitmap & source,
 	const uint32_t width = source.getWidth();
 	const uint32_t height = source.getHeight();
 
-	Reference<Bitmap> target(new Bitmap(width,height,newFormat));
-	{
-		Reference<PixelAccessor> reader( PixelAccessor::create(const_cast<Bitmap *>(&source)));
-		Reference<PixelAccessor> writer( PixelAccessor::create(target.get()));
-		for(uint32_t y = 0;y<height;++y )
-			for(uint32_t x = 0;x<width;++x )
-				writer->writeColor(x,y,reader->readColor4f(x,y));
+	Reference<Bitmap> target = Bitmap::createUninitialized(width,height,newFormat);
+	const auto converter = ResourceConverter::compile(source.getPixelFormat(), newFormat);
+	if(source.isPacked()) {
+		converter->convert(source.data(), target->data(), static_cast<uint64_t>(width) * height);
+	} else {
+		forEachTile(width, height, 0, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+			for(uint32_t y = firstRow; y < endRow; ++y)
+				converter->convert(source.data() + y * source.getPitch(), target->data() + y * target->getPitch(), width, 1);
+		});
 	}
 	return target;
 }
 
 
-Reference<Bitmap> expandChannels(const Bitmap & source, uint32_t desiredChannels) {
+Reference<Bitmap> expandChannels(const Bitmap & source, uint32_t desiredChannels, uint32_t threadCount) {
 	desiredChannels = clamp(desiredChannels, 1u, 4u);
 	const uint32_t width = source.getWidth();
 	const uint32_t height = source.getHeight();
@@ -221,33 +281,43 @@ Reference<Bitmap> expandChannels(const Bitmap & source, uint32_t desiredChannels
 	{
 		Reference<PixelAccessor> reader( PixelAccessor::create(const_cast<Bitmap *>(&source)));
 		Reference<PixelAccessor> writer( PixelAccessor::create(target.get()));
-		for(uint32_t y = 0;y<height;++y ) {
-			for(uint32_t x = 0;x<width;++x ) {
-				auto color = reader->readColor4f(x,y);
-				if(channels < 4)
-					color.a(1.0);
-				if(channels < 2)
-					color.g(color.r());
-				if(channels < 3)
-					color.b(color.g());
-				writer->writeColor(x,y,color);
+		forEachTile(width, height, threadCount, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+			std::vector<Color4f> row(width);
+			for(uint32_t y = firstRow;y<endRow;++y ) {
+				reader->readRow(y,0,width,row.data());
+				for(auto & color : row) {
+					if(channels < 4)
+						color.a(1.0);
+					if(channels < 2)
+						color.g(color.r());
+					if(channels < 3)
+						color.b(color.g());
+				}
+				writer->writeRow(y,0,width,row.data());
 			}
-		}
+		});
 	}
 	return target;
 }
 
-void alterBitmap(Bitmap & bitmap, const BitmapAlteringFunction & op) {
+void alterBitmap(Bitmap & bitmap, const BitmapAlteringFunction & op, uint32_t threadCount) {
 	const uint32_t width = bitmap.getWidth();
 	const uint32_t height = bitmap.getHeight();
-	Reference<PixelAccessor> pixels = PixelAccessor::create(&bitmap);
-	BitmapAlteringContext ctxt;
-	ctxt.pixels = pixels.get();
-	for(ctxt.y = 0; ctxt.y < height; ++ctxt.y) {
-		for(ctxt.x = 0; ctxt.x < width; ++ctxt.x) {
-			pixels->writeColor(ctxt.x, ctxt.y, op(ctxt));
+	// op reads from an unaltered copy, so the result does not depend on the order in which the pixels are processed
+	Reference<Bitmap> original(new Bitmap(bitmap));
+	Reference<PixelAccessor> source = PixelAccessor::create(original.get());
+	Reference<PixelAccessor> target = PixelAccessor::create(&bitmap);
+	forEachTile(width, height, threadCount, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+		BitmapAlteringContext ctxt;
+		ctxt.pixels = source.get();
+		std::vector<Color4f> row(width);
+		for(ctxt.y = firstRow; ctxt.y < endRow; ++ctxt.y) {
+			for(ctxt.x = 0; ctxt.x < width; ++ctxt.x) {
+				row[ctxt.x] = op(ctxt);
+			}
+			target->writeRow(ctxt.y, 0, width, row.data());
 		}
-	}
+	});
 }
 
 Reference<Bitmap> createBitmapFromBitMask(const uint32_t width,
@@ -261,52 +331,620 @@ Reference<Bitmap> createBitmapFromBitMask(const uint32_t width,
 	Reference<Bitmap> target(new Bitmap(width,height,format));
 	{
 		Reference<PixelAccessor> writer( PixelAccessor::create(target.get()));
-		//	const Color4ub black(0,0,0,0);
+		const Color4ub black(0,0,0,0);
 		const Color4ub white(255,255,255,255);
 		const uint8_t * cursor = data;
+		std::vector<Color4ub> row(width);
 		for(uint32_t y = 0;y<height;++y ){
 			for(uint32_t x = 0;x<width; ){
 				uint8_t value = *cursor++;
 				for(uint8_t mask = 128 ;mask!=0;mask = mask >> 1){
-					if( (value&mask) >0)
-						writer->writeColor(x,y,white);
+					row[x] = (value&mask) > 0 ? white : black;
 					++x;
 				}
 			}
+			writer->writeRow(y,0,width,row.data());
 		}
 		
 	}
 	return target;
 }
 
-void normalizeBitmap(Bitmap & bitmap) {
+void normalizeBitmap(Bitmap & bitmap, uint32_t threadCount) {
 	const uint32_t width = bitmap.getWidth();
 	const uint32_t height = bitmap.getHeight();
 	Reference<PixelAccessor> pixels = PixelAccessor::create(&bitmap);
-	Color4f max(0,0,0,0);
-	// get max
-	for(uint32_t y = 0; y < height; ++y) {
-		for(uint32_t x = 0; x < width; ++x) {
-			auto p = pixels->readColor4f(x, y);
-			max.r(std::max(max.r(), p.r()));
-			max.g(std::max(max.g(), p.g()));
-			max.b(std::max(max.b(), p.b()));
-			max.a(std::max(max.a(), p.a()));
+	// get max (one partial result per tile; the maximum does not depend on the order of the tiles)
+	const uint32_t tileRows = getTileRows(width, height);
+	std::vector<Color4f> maxima((height + tileRows - 1) / tileRows, Color4f(0,0,0,0));
+	forEachTile(width, height, threadCount, [&](uint64_t tile, uint32_t firstRow, uint32_t endRow) {
+		std::vector<Color4f> row(width);
+		Color4f max(0,0,0,0);
+		for(uint32_t y = firstRow; y < endRow; ++y) {
+			pixels->readRow(y, 0, width, row.data());
+			for(const auto & p : row) {
+				max.r(std::max(max.r(), p.r()));
+				max.g(std::max(max.g(), p.g()));
+				max.b(std::max(max.b(), p.b()));
+				max.a(std::max(max.a(), p.a()));
+			}
 		}
+		maxima[tile] = max;
+	});
+	Color4f max(0,0,0,0);
+	for(const auto & tileMax : maxima) {
+		max.r(std::max(max.r(), tileMax.r()));
+		max.g(std::max(max.g(), tileMax.g()));
+		max.b(std::max(max.b(), tileMax.b()));
+		max.a(std::max(max.a(), tileMax.a()));
 	}
 	// normalize
-	for(uint32_t y = 0; y < height; ++y) {
-		for(uint32_t x = 0; x < width; ++x) {
-			auto p = pixels->readColor4f(x, y);
-			p.r(p.r() / max.r());
-			p.g(p.g() / max.g());
-			p.b(p.b() / max.b());
-			p.a(p.a() / max.a());
-			pixels->writeColor(x, y, p);
+	forEachTile(width, height, threadCount, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+		std::vector<Color4f> row(width);
+		for(uint32_t y = firstRow; y < endRow; ++y) {
+			pixels->readRow(y, 0, width, row.data());
+			for(auto & p : row) {
+				p.r(p.r() / max.r());
+				p.g(p.g() / max.g());
+				p.b(p.b() / max.b());
+				p.a(p.a() / max.a());
+			}
+			pixels->writeRow(y, 0, width, row.data());
 		}
+	});
+}
+
+//-------------------------------------------------------------
+// separable filtering
+
+static const double PI = 3.14159265358979323846;
+
+static double sinc(double x) {
+	if(std::abs(x) < 1.0e-9)
+		return 1.0;
+	x *= PI;
+	return std::sin(x) / x;
+}
+
+//! Modified Bessel function of the first kind of order zero (power series)
+static double bessel0(double x) {
+	const double halfX = 0.5 * x;
+	double sum = 1.0;
+	double term = 1.0;
+	for(int k = 1; k < 64 && term > sum * 1.0e-12; ++k) {
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+	}
+	return sum;
+}
+
+static double triangleKernel(double x) {
+	return std::max(0.0, 1.0 - std::abs(x));
+}
+
+//! Catmull-Rom spline (cubic convolution with a = -0.5)
+static double cubicKernel(double x) {
+	x = std::abs(x);
+	if(x < 1.0)
+		return (1.5 * x - 2.5) * x * x + 1.0;
+	if(x < 2.0)
+		return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+	return 0.0;
+}
+
+static double lanczos3Kernel(double x) {
+	return std::abs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+//! Kaiser windowed sinc with a width of 3 and alpha = 4
+static double kaiserKernel(double x) {
+	const double t = x / 3.0;
+	if(std::abs(t) >= 1.0)
+		return 0.0;
+	return sinc(x) * bessel0(4.0 * std::sqrt(1.0 - t * t)) / bessel0(4.0);
+}
+
+namespace {
+//! Continuous filter kernel; the distance x is given in target pixels when downsampling (in source pixels otherwise).
+struct FilterKernel {
+	double radius; //!< 0: nearest pixel
+	double (*evaluate)(double x); //!< nullptr: box filter, the pixels are weighted by the covered area
+};
+
+//! Precomputed weights for one dimension: target pixel i is the weighted sum of the source pixels [first[i], first[i]+taps).
+struct FilterWeights {
+	uint32_t taps;
+	std::vector<uint32_t> first;
+	std::vector<float> weights; //!< taps weights per target pixel
+};
+}
+
+static FilterKernel getFilterKernel(MipmapFilter filter) {
+	switch(filter) {
+		case MipmapFilter::TRIANGLE:
+			return {1.0, triangleKernel};
+		case MipmapFilter::KAISER:
+			return {3.0, kaiserKernel};
+		case MipmapFilter::LANCZOS:
+			return {3.0, lanczos3Kernel};
+		case MipmapFilter::BOX:
+		default:
+			return {0.5, nullptr};
+	}
+}
+
+static FilterKernel getFilterKernel(ResizeFilter filter) {
+	switch(filter) {
+		case ResizeFilter::NEAREST:
+			return {0.0, nullptr};
+		case ResizeFilter::BICUBIC:
+			return {2.0, cubicKernel};
+		case ResizeFilter::LANCZOS:
+			return {3.0, lanczos3Kernel};
+		case ResizeFilter::BILINEAR:
+		default:
+			return {1.0, triangleKernel};
+	}
+}
+
+/**
+ * Computes the weights for resampling @p sourceSize pixels to @p targetSize pixels.
+ * Source pixels outside of the image are clamped to the border. The weights of each target pixel sum up to one.
+ */
+static FilterWeights computeFilterWeights(uint32_t sourceSize, uint32_t targetSize, const FilterKernel & kernel) {
+	const double scale = static_cast<double>(sourceSize) / targetSize;
+	const double filterScale = std::max(scale, 1.0); // when downsampling, the kernel is stretched over the source pixels
+	const double support = kernel.radius * filterScale;
+	FilterWeights result;
+	if(kernel.radius == 0.0) {
+		result.taps = 1;
+		result.weights.assign(targetSize, 1.0f);
+		for(uint32_t i = 0; i < targetSize; ++i)
+			result.first.push_back(std::min(static_cast<uint32_t>((i + 0.5) * scale), sourceSize - 1));
+		return result;
+	}
+	result.taps = std::min(sourceSize, static_cast<uint32_t>(std::ceil(2.0 * support)) + 1);
+	result.first.resize(targetSize);
+	result.weights.assign(static_cast<size_t>(targetSize) * result.taps, 0.0f);
+	std::vector<double> weights(result.taps);
+	for(uint32_t i = 0; i < targetSize; ++i) {
+		const double center = (i + 0.5) * scale; // in source pixels
+		const int64_t begin = static_cast<int64_t>(std::floor(center - support - 0.5));
+		const int64_t end = static_cast<int64_t>(std::ceil(center + support + 0.5));
+		const auto getWeight = [&](int64_t s) {
+			if(kernel.evaluate == nullptr)
+				return std::max(0.0, std::min(s + 1.0, center + support) - std::max(static_cast<double>(s), center - support));
+			const double weight = kernel.evaluate((s + 0.5 - center) / filterScale);
+			return std::abs(weight) < 1.0e-9 ? 0.0 : weight; // roundoff of the kernel at its zeros (e.g., sinc at integers)
+		};
+		int64_t firstNonZero = begin;
+		while(firstNonZero < end && getWeight(firstNonZero) == 0.0)
+			++firstNonZero;
+		const uint32_t first = static_cast<uint32_t>(clamp<int64_t>(firstNonZero, 0, sourceSize - result.taps));
+		std::fill(weights.begin(), weights.end(), 0.0);
+		double sum = 0.0;
+		for(int64_t s = firstNonZero; s <= end; ++s) {
+			const double weight = getWeight(s);
+			const int64_t index = clamp<int64_t>(s, 0, sourceSize - 1) - first;
+			weights[std::min<int64_t>(index, result.taps - 1)] += weight;
+			sum += weight;
+		}
+		if(sum == 0.0) { // cannot happen for the given kernels; fall back to the nearest pixel
+			weights[std::min<int64_t>(clamp<int64_t>(static_cast<int64_t>(center), 0, sourceSize - 1) - first, result.taps - 1)] = 1.0;
+			sum = 1.0;
+		}
+		result.first[i] = first;
+		for(uint32_t t = 0; t < result.taps; ++t)
+			result.weights[static_cast<size_t>(i) * result.taps + t] = static_cast<float>(weights[t] / sum);
 	}
+	return result;
 }
 
+//! Horizontal pass for pixels with @p Channels components: target pixel x is the weighted sum of the source pixels [first[x], first[x]+taps).
+template<uint32_t Channels>
+static void filterRowScalar(const float * source, float * target, uint32_t targetWidth, const uint32_t * first, const float * weights, uint32_t taps) {
+	for(uint32_t x = 0; x < targetWidth; ++x, weights += taps) {
+		const float * pixel = source + static_cast<size_t>(first[x]) * Channels;
+		float sum[Channels] = {};
+		for(uint32_t t = 0; t < taps; ++t, pixel += Channels)
+			for(uint32_t c = 0; c < Channels; ++c)
+				sum[c] += weights[t] * pixel[c];
+		for(uint32_t c = 0; c < Channels; ++c)
+			target[static_cast<size_t>(x) * Channels + c] = sum[c];
+	}
 }
+
+//! Vertical pass: target[i] is the weighted sum of source[t * rowStride + i] for t in [0, taps).
+static void filterColumnsScalar(const float * source, uint64_t rowStride, float * target, uint64_t count, const float * weights, uint32_t taps) {
+	for(uint64_t i = 0; i < count; ++i) {
+		float sum = 0.0f;
+		for(uint32_t t = 0; t < taps; ++t)
+			sum += weights[t] * source[t * rowStride + i];
+		target[i] = sum;
+	}
 }
 
+#ifdef UTIL_BITMAP_SSE2
+static void filterRow4_SSE2(const float * source, float * target, uint32_t targetWidth, const uint32_t * first, const float * weights, uint32_t taps) {
+	for(uint32_t x = 0; x < targetWidth; ++x, weights += taps) {
+		const float * pixel = source + static_cast<size_t>(first[x]) * 4;
+		__m128 sum = _mm_setzero_ps();
+		for(uint32_t t = 0; t < taps; ++t, pixel += 4)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(pixel)));
+		_mm_storeu_ps(target + static_cast<size_t>(x) * 4, sum);
+	}
+}
+
+static void filterColumns_SSE2(const float * source, uint64_t rowStride, float * target, uint64_t count, const float * weights, uint32_t taps) {
+	uint64_t i = 0;
+	for(; i + 4 <= count; i += 4) {
+		__m128 sum = _mm_setzero_ps();
+		for(uint32_t t = 0; t < taps; ++t)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(source + t * rowStride + i)));
+		_mm_storeu_ps(target + i, sum);
+	}
+	filterColumnsScalar(source + i, rowStride, target + i, count - i, weights, taps);
+}
+#endif /* UTIL_BITMAP_SSE2 */
+
+#ifdef UTIL_BITMAP_AVX2
+// As in AttributeConversion, the kernels clear the upper halves of the AVX registers before returning to SSE code.
+#define UTIL_AVX2_FMA __attribute__((target("avx2,fma")))
+
+UTIL_AVX2_FMA static void filterRow4_AVX2(const float * source, float * target, uint32_t targetWidth, const uint32_t * first, const float * weights, uint32_t taps) {
+	for(uint32_t x = 0; x < targetWidth; ++x, weights += taps) {
+		const float * pixel = source + static_cast<size_t>(first[x]) * 4;
+		__m128 sum = _mm_setzero_ps();
+		for(uint32_t t = 0; t < taps; ++t, pixel += 4)
+			sum = _mm_fmadd_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(pixel), sum);
+		_mm_storeu_ps(target + static_cast<size_t>(x) * 4, sum);
+	}
+	_mm256_zeroupper();
+}
+
+UTIL_AVX2_FMA static void filterColumns_AVX2(const float * source, uint64_t rowStride, float * target, uint64_t count, const float * weights, uint32_t taps) {
+	uint64_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m256 sum = _mm256_setzero_ps();
+		for(uint32_t t = 0; t < taps; ++t)
+			sum = _mm256_fmadd_ps(_mm256_set1_ps(weights[t]), _mm256_loadu_ps(source + t * rowStride + i), sum);
+		_mm256_storeu_ps(target + i, sum);
+	}
+	_mm256_zeroupper();
+	filterColumnsScalar(source + i, rowStride, target + i, count - i, weights, taps);
+}
+
+#undef UTIL_AVX2_FMA
+#endif /* UTIL_BITMAP_AVX2 */
+
+namespace {
+//! Filter kernels for the available instruction set (selected once at runtime)
+struct FilterFunctions {
+	void (*filterRow4)(const float *, float *, uint32_t, const uint32_t *, const float *, uint32_t);
+	void (*filterColumns)(const float *, uint64_t, float *, uint64_t, const float *, uint32_t);
+};
+}
+
+static FilterFunctions selectFilterFunctions() {
+#ifdef UTIL_BITMAP_AVX2
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return {filterRow4_AVX2, filterColumns_AVX2};
+#endif
+#ifdef UTIL_BITMAP_SSE2
+	return {filterRow4_SSE2, filterColumns_SSE2};
+#else
+	return {filterRowScalar<4>, filterColumnsScalar};
+#endif
+}
+
+static const FilterFunctions & getFilterFunctions() {
+	static const FilterFunctions functions = selectFilterFunctions();
+	return functions;
+}
+
+//! Filters a row of @p channels interleaved components horizontally.
+static void filterRow(const float * source, float * target, const FilterWeights & weights, uint32_t channels, const FilterFunctions & functions) {
+	const uint32_t targetWidth = static_cast<uint32_t>(weights.first.size());
+	switch(channels) {
+		case 1:
+			filterRowScalar<1>(source, target, targetWidth, weights.first.data(), weights.weights.data(), weights.taps);
+			break;
+		case 2:
+			filterRowScalar<2>(source, target, targetWidth, weights.first.data(), weights.weights.data(), weights.taps);
+			break;
+		case 3:
+			filterRowScalar<3>(source, target, targetWidth, weights.first.data(), weights.weights.data(), weights.taps);
+			break;
+		default:
+			functions.filterRow4(source, target, targetWidth, weights.first.data(), weights.weights.data(), weights.taps);
+			break;
+	}
+}
+
+/**
+ * Resamples an image of @p channels interleaved float components with the given weights.
+ * The target rows are processed in parallel tiles. Each tile filters the source rows it needs horizontally into a buffer,
+ * which stays in the cache for the vertical pass.
+ * @param getSourceRow Function (uint32_t y, float * buffer) -> const float *, which returns source row y, either directly
+ *	or after writing it into the given buffer (sourceWidth * channels values).
+ * @param storeTargetRow Function (uint32_t y, const float * row), which stores the filtered target row y (e.g., after converting it).
+ */
+template<typename GetSourceRow, typename StoreTargetRow>
+static void resample(const GetSourceRow & getSourceRow, const StoreTargetRow & storeTargetRow, uint32_t sourceWidth,
+					 const FilterWeights & horizontal, const FilterWeights & vertical, uint32_t channels, uint32_t threadCount) {
+	const uint32_t targetWidth = static_cast<uint32_t>(horizontal.first.size());
+	const uint32_t targetHeight = static_cast<uint32_t>(vertical.first.size());
+	const uint64_t targetRowSize = static_cast<uint64_t>(targetWidth) * channels;
+	const FilterFunctions & functions = getFilterFunctions();
+	// the source rows at the border of a tile are filtered by both neighboring tiles, so wide filters use larger tiles
+	const uint64_t tileRows = clamp<uint64_t>(getTileRows(targetWidth, targetHeight), 4 * vertical.taps, std::max(targetHeight, 1u));
+	const uint64_t tileCount = (targetHeight + tileRows - 1) / tileRows;
+	const uint64_t grainSize = std::max<uint64_t>(1, MIN_PARALLEL_PIXELS / (tileRows * std::max(targetWidth, 1u)));
+	parallelFor(0, tileCount, grainSize, [&](uint64_t firstTile, uint64_t endTile) {
+		std::vector<float> sourceRow(static_cast<size_t>(sourceWidth) * channels);
+		std::vector<float> rows;
+		std::vector<float> targetRow(targetRowSize);
+		for(uint64_t tile = firstTile; tile < endTile; ++tile) {
+			const uint32_t firstRow = static_cast<uint32_t>(tile * tileRows);
+			const uint32_t endRow = static_cast<uint32_t>(std::min<uint64_t>(targetHeight, (tile + 1) * tileRows));
+			const uint32_t firstSourceRow = vertical.first[firstRow];
+			const uint32_t endSourceRow = vertical.first[endRow - 1] + vertical.taps;
+			rows.resize((endSourceRow - firstSourceRow) * targetRowSize);
+			for(uint32_t y = firstSourceRow; y < endSourceRow; ++y)
+				filterRow(getSourceRow(y, sourceRow.data()), rows.data() + (y - firstSourceRow) * targetRowSize, horizontal, channels, functions);
+			for(uint32_t y = firstRow; y < endRow; ++y) {
+				functions.filterColumns(rows.data() + (vertical.first[y] - firstSourceRow) * targetRowSize, targetRowSize,
+										targetRow.data(), targetRowSize, vertical.weights.data() + static_cast<size_t>(y) * vertical.taps, vertical.taps);
+				storeTargetRow(y, targetRow.data());
+			}
+		}
+	}, threadCount);
+}
+
+//-------------------------------------------------------------
+// mipmaps
+
+static const AttributeFormat & getFloatFormat(uint32_t components) {
+	switch(components) {
+		case 1:
+			return PixelFormat::MONO_FLOAT;
+		case 2:
+			return PixelFormat::RG_FLOAT;
+		case 3:
+			return PixelFormat::RGB_FLOAT;
+		default:
+			return PixelFormat::RGBA_FLOAT;
+	}
+}
+
+//! Return the number of values per pixel (e.g., 3 for R11G11B10_FLOAT, which packs them into one component), or 0 if there is no accessor for the format.
+static uint32_t getPixelValueCount(const AttributeFormat & format) {
+	const auto factory = AttributeAccessor::getAccessorFactory(format);
+	if(!factory)
+		return 0;
+	std::vector<uint8_t> pixel(format.getDataSize());
+	const Reference<AttributeAccessor> accessor = factory(pixel.data(), pixel.size(), format, 0);
+	return accessor ? accessor->getValueCount() : 0;
+}
+
+static float decodeSRGB(float value) {
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float encodeSRGB(float value) {
+	value = std::max(value, 0.0f);
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+//! sRGB encoding by linear interpolation in a table of 4096 intervals (the error is far below the precision of 8 bit values).
+static float encodeSRGBApproximate(float value) {
+	static const std::vector<float> table = []() {
+		std::vector<float> values(4097);
+		for(size_t i = 0; i < values.size(); ++i)
+			values[i] = encodeSRGB(static_cast<float>(i) / 4096.0f);
+		return values;
+	}();
+	const float position = clamp(value, 0.0f, 1.0f) * 4096.0f;
+	const uint32_t index = std::min(static_cast<uint32_t>(position), 4095u);
+	return table[index] + (position - static_cast<float>(index)) * (table[index + 1] - table[index]);
+}
+
+//! Returns the fraction of the RGBA pixels whose alpha value multiplied by @p scale is larger than @p threshold.
+static float getAlphaCoverage(const std::vector<float> & pixels, float threshold, float scale) {
+	uint64_t covered = 0;
+	for(size_t i = 3; i < pixels.size(); i += 4)
+		covered += pixels[i] * scale > threshold ? 1 : 0;
+	return static_cast<float>(covered) / static_cast<float>(pixels.size() / 4);
+}
+
+//! Returns the scale of the alpha values (binary search in [0,4]) for which the alpha coverage is closest to @p coverage.
+static float findAlphaScale(const std::vector<float> & pixels, float threshold, float coverage) {
+	float minScale = 0.0f;
+	float maxScale = 4.0f;
+	float bestScale = 1.0f;
+	float bestError = std::abs(getAlphaCoverage(pixels, threshold, 1.0f) - coverage);
+	for(int i = 0; i < 10 && bestError > 0.0f; ++i) {
+		const float scale = 0.5f * (minScale + maxScale);
+		const float current = getAlphaCoverage(pixels, threshold, scale);
+		const float error = std::abs(current - coverage);
+		if(error < bestError) {
+			bestError = error;
+			bestScale = scale;
+		}
+		if(current < coverage)
+			minScale = scale;
+		else
+			maxScale = scale;
+	}
+	return bestScale;
+}
+
+std::vector<Reference<Bitmap>> generateMipmaps(const Bitmap & source, MipmapFilter filter, bool sRGB,
+											   float alphaCoverageThreshold, uint32_t threadCount) {
+	const AttributeFormat & format = source.getPixelFormat();
+	const uint64_t pixelSize = format.getDataSize();
+	const uint32_t channels = pixelSize == 0 ? 0 : getPixelValueCount(format);
+	if(channels == 0 || channels > 4)
+		throw std::invalid_argument("generateMipmaps: Unsupported pixel format '" + format.toString() + "'.");
+
+	// all levels are stored in one allocation
+	struct Level {
+		uint32_t width, height;
+		size_t offset;
+	};
+	std::vector<Level> levels;
+	size_t dataSize = 0;
+	for(uint32_t width = source.getWidth(), height = source.getHeight(); ; width = std::max(width / 2, 1u), height = std::max(height / 2, 1u)) {
+		levels.push_back({width, height, dataSize});
+		const size_t levelSize = static_cast<size_t>(width) * height * pixelSize;
+		dataSize += (levelSize + Bitmap::DATA_ALIGNMENT - 1) / Bitmap::DATA_ALIGNMENT * Bitmap::DATA_ALIGNMENT;
+		if(width == 0 || height == 0 || (width == 1 && height == 1))
+			break;
+	}
+	std::shared_ptr<uint8_t> storage(static_cast<uint8_t *>(::operator new(dataSize, std::align_val_t(Bitmap::DATA_ALIGNMENT))),
+		[](uint8_t * data) { ::operator delete(data, std::align_val_t(Bitmap::DATA_ALIGNMENT)); });
+	std::vector<Reference<Bitmap>> result;
+	for(const auto & level : levels)
+		result.emplace_back(Bitmap::createFromData(level.width, level.height, format, storage.get() + level.offset, 0, [storage](uint8_t *) {}));
+
+	// level 0: copy of the source
+	const uint32_t width = source.getWidth();
+	const uint32_t height = source.getHeight();
+	const uint64_t rowSize = static_cast<uint64_t>(width) * pixelSize;
+	for(uint32_t y = 0; y < height; ++y)
+		std::copy_n(source.data() + y * source.getPitch(), rowSize, result.front()->data() + y * rowSize);
+	if(levels.size() == 1)
+		return result;
+
+	// the levels are filtered in linear floating point precision
+	const AttributeFormat & floatFormat = getFloatFormat(channels);
+	const auto toFloat = ResourceConverter::compile(format, floatFormat);
+	const auto fromFloat = ResourceConverter::compile(floatFormat, format);
+	const uint64_t floatRowSize = static_cast<uint64_t>(width) * channels;
+	const uint32_t colorChannels = channels == 4 ? 3 : channels;
+	const bool isByteFormat = format.getDataType() == TypeConstant::UINT8 && format.isNormalized();
+	std::vector<float> sRGBTable; // sRGB decoding of 8 bit values
+	if(sRGB && isByteFormat) {
+		sRGBTable.resize(256);
+		for(uint32_t i = 0; i < 256; ++i)
+			sRGBTable[i] = decodeSRGB(i / 255.0f);
+	}
+	// the first level is filtered from the converted rows of the source, the other levels from the previous level
+	const auto getSourceRow = [&](uint32_t y, float * row) -> const float * {
+		toFloat->convert(result.front()->data() + y * rowSize, reinterpret_cast<uint8_t *>(row), width, 1);
+		if(sRGB && isByteFormat) {
+			const float * table = sRGBTable.data();
+			for(uint64_t i = 0; i < floatRowSize; i += channels)
+				for(uint32_t c = 0; c < colorChannels; ++c)
+					row[i + c] = table[static_cast<int32_t>(row[i + c] * 255.0f + 0.5f)]; // the bytes have been converted to [0,1]
+		} else if(sRGB) {
+			for(uint64_t i = 0; i < floatRowSize; i += channels)
+				for(uint32_t c = 0; c < colorChannels; ++c)
+					row[i + c] = decodeSRGB(row[i + c]);
+		}
+		return row;
+	};
+
+	const bool preserveCoverage = alphaCoverageThreshold > 0.0f && channels == 4;
+	float coverage = 0.0f;
+	if(preserveCoverage) {
+		const uint32_t tileRows = getTileRows(width, height);
+		std::vector<uint64_t> covered((height + tileRows - 1) / tileRows, 0); // one count per tile
+		forEachTile(width, height, threadCount, [&](uint64_t tile, uint32_t firstRow, uint32_t endRow) {
+			std::vector<float> row(floatRowSize);
+			for(uint32_t y = firstRow; y < endRow; ++y) {
+				toFloat->convert(result.front()->data() + y * rowSize, reinterpret_cast<uint8_t *>(row.data()), width, 1);
+				for(uint64_t i = 3; i < floatRowSize; i += 4)
+					covered[tile] += row[i] > alphaCoverageThreshold ? 1 : 0;
+			}
+		});
+		coverage = static_cast<float>(std::accumulate(covered.begin(), covered.end(), static_cast<uint64_t>(0))) / (static_cast<float>(width) * height);
+	}
+
+	const FilterKernel kernel = getFilterKernel(filter);
+	std::vector<float> current;
+	std::vector<float> next;
+	std::vector<float> encoded;
+	for(size_t l = 1; l < levels.size(); ++l) {
+		const Level & previous = levels[l - 1];
+		const Level & level = levels[l];
+		const uint64_t previousRowSize = static_cast<uint64_t>(previous.width) * channels;
+		const uint64_t levelRowSize = static_cast<uint64_t>(level.width) * channels;
+		const FilterWeights horizontal = computeFilterWeights(previous.width, level.width, kernel);
+		const FilterWeights vertical = computeFilterWeights(previous.height, level.height, kernel);
+		next.resize(level.height * levelRowSize);
+		const auto storeRow = [&](uint32_t y, const float * row) {
+			std::copy_n(row, levelRowSize, next.data() + y * levelRowSize);
+		};
+		if(l == 1) {
+			resample(getSourceRow, storeRow, previous.width, horizontal, vertical, channels, threadCount);
+		} else {
+			resample([&](uint32_t y, float *) -> const float * { return current.data() + y * previousRowSize; },
+					 storeRow, previous.width, horizontal, vertical, channels, threadCount);
+		}
+
+		const std::vector<float> * output = &next;
+		if(sRGB || preserveCoverage) {
+			// the next level is filtered from the unscaled linear values
+			encoded = next;
+			const float alphaScale = preserveCoverage ? findAlphaScale(next, alphaCoverageThreshold, coverage) : 1.0f;
+			forEachTile(level.width, level.height, threadCount, [&](uint64_t, uint32_t firstRow, uint32_t endRow) {
+				for(uint64_t i = firstRow * levelRowSize; i < endRow * levelRowSize; i += channels) {
+					if(sRGB) {
+						for(uint32_t c = 0; c < colorChannels; ++c)
+							encoded[i + c] = isByteFormat ? encodeSRGBApproximate(encoded[i + c]) : encodeSRGB(encoded[i + c]);
+					}
+					if(preserveCoverage)
+						encoded[i + 3] = clamp(encoded[i + 3] * alphaScale, 0.0f, 1.0f);
+				}
+			});
+			output = &encoded;
+		}
+		fromFloat->convert(reinterpret_cast<const uint8_t *>(output->data()), result[l]->data(),
+						   static_cast<uint64_t>(level.width) * level.height, threadCount);
+		std::swap(current, next);
+	}
+	return result;
+}
+
+
+//-------------------------------------------------------------
+// resizing
+
+Reference<Bitmap> resizeBitmap(const Bitmap & source, uint32_t width, uint32_t height, ResizeFilter filter, uint32_t threadCount) {
+	const AttributeFormat & format = source.getPixelFormat();
+	const uint32_t channels = format.getDataSize() == 0 ? 0 : getPixelValueCount(format);
+	if(channels == 0 || channels > 4)
+		throw std::invalid_argument("resizeBitmap: Unsupported pixel format '" + format.toString() + "'.");
+	Reference<Bitmap> target = Bitmap::createUninitialized(width, height, format);
+	if(width == 0 || height == 0)
+		return target;
+	if(source.getWidth() == 0 || source.getHeight() == 0)
+		throw std::invalid_argument("resizeBitmap: The source bitmap is empty.");
+
+	const FilterKernel kernel = getFilterKernel(filter);
+	const FilterWeights horizontal = computeFilterWeights(source.getWidth(), width, kernel);
+	const FilterWeights vertical = computeFilterWeights(source.getHeight(), height, kernel);
+	if(format.getDataType() == TypeConstant::FLOAT && format.getInternalType() == 0) {
+		// float components in RGBA order are filtered in place
+		const uint64_t rowSize = static_cast<uint64_t>(width) * channels;
+		resample([&](uint32_t y, float *) { return reinterpret_cast<const float *>(source.data() + y * source.getPitch()); },
+				 [&](uint32_t y, const float * row) { std::copy_n(row, rowSize, reinterpret_cast<float *>(target->data() + y * target->getPitch())); },
+				 source.getWidth(), horizontal, vertical, channels, threadCount);
+	} else {
+		// other formats (e.g., RGBA with 8 bit components) are converted row by row
+		const AttributeFormat & floatFormat = getFloatFormat(channels);
+		const auto toFloat = ResourceConverter::compile(format, floatFormat);
+		const auto fromFloat = ResourceConverter::compile(floatFormat, format);
+		resample([&](uint32_t y, float * row) {
+					toFloat->convert(source.data() + y * source.getPitch(), reinterpret_cast<uint8_t *>(row), source.getWidth(), 1);
+					return static_cast<const float *>(row);
+				 },
+				 [&](uint32_t y, const float * row) { fromFloat->convert(reinterpret_cast<const uint8_t *>(row), target->data() + y * target->getPitch(), width, 1); },
+				 source.getWidth(), horizontal, vertical, channels, threadCount);
+	}
+	return target;
+}
+
+}
+}
@@ -29,6 +29,8 @@ class AttributeFormat;
 
 /**
  * Collection of Bitmap related operations.
+ * The per-pixel operations split the image into tiles of rows, which are processed in parallel.
+ * Their results do not depend on the number of threads.
  * @ingroup graphics
  */
 namespace BitmapUtils {
@@ -47,20 +49,31 @@ typedef std::function<Color4f (const BitmapAlteringContext &)> BitmapAlteringFun
  * For real-time applications use a specialized implementation.
  * @param bitmap Bitmap that is to be changed
  * @param op Operation that is called for every pixel of the bitmap
+ * @param threadCount The maximum number of threads (0 = default). Use 1 if @p op is not thread-safe.
+ * @note Unless @p threadCount is 1, @p op is called concurrently from multiple threads (for different pixels in unspecified order).
+ *	It may read the bitmap through the given context, but must not modify shared state without synchronization.
+ * @note @p op always reads the original content of the bitmap (the context refers to a copy), so the result
+ *	does not depend on the number of threads.
  */
-UTILAPI void alterBitmap(Bitmap & bitmap, const BitmapAlteringFunction & op);
+UTILAPI void alterBitmap(Bitmap & bitmap, const BitmapAlteringFunction & op, uint32_t threadCount=0);
 
 
-//! Blend all given images into one having the given format.
+/**
+ * Blend all given images into one having the given format.
+ * @param threadCount The maximum number of threads (0 = default).
+ */
 UTILAPI Reference<Bitmap> blendTogether(const AttributeFormat & targetFormat, 
-									   const std::vector<Reference<Bitmap> > & sources);
+									   const std::vector<Reference<Bitmap> > & sources,
+									   uint32_t threadCount=0);
 
 /**
  * Combines all given images into one having the given format.
  * \note first pixel of first bitmap, first pixel of second bitmap, etc...
+ * @param threadCount The maximum number of threads (0 = default).
  */
 UTILAPI Reference<Bitmap> combineInterleaved(const AttributeFormat & targetFormat, 
-											const std::vector<Reference<Bitmap> > & sources);
+											const std::vector<Reference<Bitmap> > & sources,
+											uint32_t threadCount=0);
 
 /**
  * internal method, used for saving images which are in a format that
@@ -79,9 +92,10 @@ UTILAPI Reference<Bitmap> convertBitmap(const Bitmap & source, const AttributeFo
  *
  * @param source the bitmap to be converted
  * @param desiredChannels the number of new channels
+ * @param threadCount The maximum number of threads (0 = default).
  * @return a new bitmap of the specified format with the content of the given bitmap
  */
-UTILAPI Reference<Bitmap> expandChannels(const Bitmap & source, uint32_t desiredChannels);
+UTILAPI Reference<Bitmap> expandChannels(const Bitmap & source, uint32_t desiredChannels, uint32_t threadCount=0);
 
 /**
  * Create a black/transparent - white bitmap with the given format based on a 
@@ -94,8 +108,66 @@ UTILAPI Reference<Bitmap> createBitmapFromBitMask(const uint32_t width,
 												 const size_t dataSize,
 												 const uint8_t * data);
 
-//! Normalizes each pixel to the range [0,1]
-UTILAPI void normalizeBitmap(Bitmap & bitmap);
+/**
+ * Normalizes each pixel to the range [0,1]
+ * @param threadCount The maximum number of threads (0 = default).
+ */
+UTILAPI void normalizeBitmap(Bitmap & bitmap, uint32_t threadCount=0);
+
+//! Downsampling filters for generateMipmaps
+enum class MipmapFilter : uint8_t {
+	BOX,		//!< Average of the covered pixels (2x2 for even sizes)
+	TRIANGLE,	//!< Tent filter (radius of one target pixel)
+	KAISER,		//!< Kaiser windowed sinc (radius of three target pixels); sharper than BOX and TRIANGLE
+	LANCZOS		//!< Lanczos3 windowed sinc (radius of three target pixels); sharpest, but may overshoot at edges
+};
+
+/**
+ * Generates the complete mipmap chain of a bitmap down to 1x1 pixels.
+ * The size of each level is half the size of the previous level (rounded down, at least 1).
+ * Each level is filtered from the previous one with a separable filter in floating point precision.
+ * The rows of the levels are filtered in parallel tiles.
+ *
+ * All levels are stored in one contiguous allocation in ascending order, each level starting at a multiple of
+ * Bitmap::DATA_ALIGNMENT bytes (e.g., for uploading the whole chain at once). Every level keeps the allocation alive.
+ *
+ * @param source Bitmap with up to four components (e.g., MONO, RGB, RGBA or their float variants). It is not changed.
+ * @param filter Downsampling filter
+ * @param sRGB If true, the color components are stored in sRGB encoding and are averaged in linear space.
+ *	The fourth component (alpha) is always linear.
+ * @param alphaCoverageThreshold If larger than 0, the alpha component of each level is scaled so that the fraction of
+ *	pixels with an alpha value larger than the threshold matches the one of @p source (e.g., for alpha tested foliage).
+ * @param threadCount The maximum number of threads (0 = default).
+ * @return The levels in the pixel format of @p source, starting with a copy of @p source.
+ * @throw std::invalid_argument if the pixel format of @p source is not supported (e.g., for raw data).
+ */
+UTILAPI std::vector<Reference<Bitmap>> generateMipmaps(const Bitmap & source, MipmapFilter filter=MipmapFilter::BOX, bool sRGB=false,
+													   float alphaCoverageThreshold=0.0f, uint32_t threadCount=0);
+
+//! Resampling filters for resizeBitmap
+enum class ResizeFilter : uint8_t {
+	NEAREST,	//!< Nearest pixel (no filtering)
+	BILINEAR,	//!< Tent filter; averages all covered pixels when downsampling
+	BICUBIC,	//!< Catmull-Rom spline
+	LANCZOS		//!< Lanczos3 windowed sinc; sharpest, but may overshoot at edges
+};
+
+/**
+ * Resizes a bitmap with separable resampling.
+ * The weights of the filter are precomputed for each target row and column. When downsampling, the filter is
+ * stretched over all covered source pixels, so no aliasing occurs. The components are filtered in floating point
+ * precision (other formats are converted row by row); the rows are processed in parallel tiles.
+ *
+ * @param source Bitmap with up to four components (any format supported by PixelAccessor, e.g., RGBA or RGBA_FLOAT)
+ * @param width Width of the new bitmap
+ * @param height Height of the new bitmap
+ * @param filter Resampling filter
+ * @param threadCount The maximum number of threads (0 = default).
+ * @return A new bitmap with the pixel format of @p source
+ * @throw std::invalid_argument if the pixel format of @p source is not supported or if @p source is empty.
+ */
+UTILAPI Reference<Bitmap> resizeBitmap(const Bitmap & source, uint32_t width, uint32_t height, ResizeFilter filter=ResizeFilter::BILINEAR,
+									   uint32_t threadCount=0);
 
 #ifdef UTIL_HAVE_LIB_SDL2
 //! Conversion between Bitmap and SDL_Surface
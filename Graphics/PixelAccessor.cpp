@@ -10,9 +10,11 @@
 */
 #include "PixelAccessor.h"
 #include "../Resources/AttributeAccessor.h"
+#include "../Resources/ResourceConverter.h"
 #include "../Macros.h"
 #include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace Util {
 
@@ -26,13 +28,36 @@ bool PixelAccessor::crop(uint32_t & x,uint32_t & y,uint32_t & width,uint32_t & h
 	return true;
 }
 
+//! ---o
+void PixelAccessor::doReadRow(uint32_t y, uint32_t x, uint32_t count, Color4f * colors) const {
+	for(uint32_t i=0; i<count; ++i)
+		colors[i] = doReadColor4f(x+i,y);
+}
+
+//! ---o
+void PixelAccessor::doReadRow(uint32_t y, uint32_t x, uint32_t count, Color4ub * colors) const {
+	for(uint32_t i=0; i<count; ++i)
+		colors[i] = doReadColor4ub(x+i,y);
+}
+
+//! ---o
+void PixelAccessor::doWriteRow(uint32_t y, uint32_t x, uint32_t count, const Color4f * colors) {
+	for(uint32_t i=0; i<count; ++i)
+		doWriteColor(x+i,y,colors[i]);
+}
+
+//! ---o
+void PixelAccessor::doWriteRow(uint32_t y, uint32_t x, uint32_t count, const Color4ub * colors) {
+	for(uint32_t i=0; i<count; ++i)
+		doWriteColor(x+i,y,colors[i]);
+}
+
 //! ---o
 void PixelAccessor::doFill(uint32_t x,uint32_t y,uint32_t width,uint32_t height,const Color4f & c){
-	const uint32_t maxX = x+width;
+	const std::vector<Color4f> row(width, c);
 	const uint32_t maxY = y+height;
 	for(uint32_t cy=y ; cy<maxY; ++cy)
-		for(uint32_t cx=x ; cx<maxX ; ++cx)
-			doWriteColor(cx,cy,c);
+		doWriteRow(cy,x,width,row.data());
 }
 
 //-------------
@@ -59,9 +84,10 @@ static uint32_t toFloat10(float f) {
 
 static float fromFloat11(uint32_t float11Bits) {
 	float f;
+	if((float11Bits & 0x7c0u) == 0) return 0; // zero (denormals are flushed)
 	uint32_t exponent = ((float11Bits & 0x7ffu) >> 6) + 127 - 15;
 	uint32_t mantissa = (float11Bits & 0x3fu);
-	uint32_t floatBits = (exponent << 23) | mantissa;
+	uint32_t floatBits = (exponent << 23) | (mantissa << 17);
 	memcpy(&f, &floatBits, sizeof(float));
 	return f;
 }
@@ -70,9 +96,10 @@ static float fromFloat11(uint32_t float11Bits) {
 
 static float fromFloat10(uint32_t float10Bits) {
 	float f;
+	if((float10Bits & 0x3e0u) == 0) return 0; // zero (denormals are flushed)
 	uint32_t exponent = ((float10Bits & 0x3ffu) >> 5) + 127 - 15;
 	uint32_t mantissa = (float10Bits & 0x1fu);
-	uint32_t floatBits = (exponent << 23) | mantissa;
+	uint32_t floatBits = (exponent << 23) | (mantissa << 18);
 	memcpy(&f, &floatBits, sizeof(float));
 	return f;
 }
@@ -87,11 +114,14 @@ public:
 	static Reference<AttributeAccessor> create(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) {
 		return new R11G11B10FloatAccessor(ptr, size, attr, stride);
 	}
+
+	//! The packed 32 bit value holds three values.
+	uint32_t getValueCount() const override { return 3; }
 		
 	template<typename S>
 	void _readValues(uint64_t index, S* values, uint64_t count) const {
-		std::vector<float> floatValues(count);
-		readValues(index, floatValues.data(), count);
+		std::vector<float> floatValues(std::min<uint64_t>(count, 3));
+		readValues(index, floatValues.data(), floatValues.size());
 		std::transform(floatValues.begin(), floatValues.end(), values, [](float v) { return static_cast<S>(v);});
 		//std::copy(floatValues.begin(), floatValues.end(), values);
 	}
@@ -114,9 +144,9 @@ public:
 	virtual void readValues(uint64_t index, float* values, uint64_t count) const {
 		assertRange(index);
 		uint32_t v = *_ptr<const uint32_t>(index);
-		if(count >= 0) *(values+0) = fromFloat11(v);
-		if(count >= 1) *(values+1) = fromFloat11(v >> 11);
-		if(count >= 2) *(values+2) = fromFloat10(v >> 22);
+		if(count > 0) *(values+0) = fromFloat11(v);
+		if(count > 1) *(values+1) = fromFloat11(v >> 11);
+		if(count > 2) *(values+2) = fromFloat10(v >> 22);
 	}
 	
 	virtual void readValues(uint64_t index, double* values, uint64_t count) const { _readValues(index, values, count); }
@@ -130,9 +160,9 @@ public:
 	virtual void writeValues(uint64_t index, const uint64_t* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const float* values, uint64_t count) const {
 		assertRange(index);
-		uint32_t r = count >= 0 ? toFloat11(*(values+0)) : 0;
-		uint32_t g = count >= 1 ? toFloat11(*(values+1)) : 0;
-		uint32_t b = count >= 2 ? toFloat10(*(values+2)) : 0;
+		uint32_t r = count > 0 ? toFloat11(*(values+0)) : 0;
+		uint32_t g = count > 1 ? toFloat11(*(values+1)) : 0;
+		uint32_t b = count > 2 ? toFloat10(*(values+2)) : 0;
 		*_ptr<uint32_t>(index) = r | (g << 11) | (b << 22);
 	}
 	
@@ -194,6 +224,7 @@ public:
 };
 
 static const bool BgraAccRegistered = AttributeAccessor::registerAccessor(PixelFormat::INTERNAL_TYPE_BGRA, BgraAccessor::create);
+static const bool BgraOrderRegistered = ResourceConverter::registerComponentOrder(PixelFormat::INTERNAL_TYPE_BGRA, {2,1,0,3});
 
 // ------------------------------------
 
@@ -245,8 +276,36 @@ private:
 	void doWriteSingleValueFloat(uint32_t x, uint32_t y, float value) override {
 		doWriteColor(x, y, Util::Color4f(value,0,0,0));
 	}
+
+	//! ---|> PixelAccessor
+	void doReadRow(uint32_t y, uint32_t x, uint32_t count, Color4f * colors) const override {
+		if(acc->getValueCount() < 4)
+			std::fill(colors, colors+count, Color4f(0,0,0,1));
+		acc->readRange(getIndex(x,y), count, reinterpret_cast<float*>(colors), 4);
+	}
+
+	//! ---|> PixelAccessor
+	void doReadRow(uint32_t y, uint32_t x, uint32_t count, Color4ub * colors) const override {
+		if(acc->getValueCount() < 4)
+			std::fill(colors, colors+count, Color4ub(0,0,0,255));
+		acc->readRange(getIndex(x,y), count, reinterpret_cast<uint8_t*>(colors), 4);
+	}
+
+	//! ---|> PixelAccessor
+	void doWriteRow(uint32_t y, uint32_t x, uint32_t count, const Color4f * colors) override {
+		acc->writeRange(getIndex(x,y), count, reinterpret_cast<const float*>(colors), 4);
+	}
+
+	//! ---|> PixelAccessor
+	void doWriteRow(uint32_t y, uint32_t x, uint32_t count, const Color4ub * colors) override {
+		acc->writeRange(getIndex(x,y), count, reinterpret_cast<const uint8_t*>(colors), 4);
+	}
 };
 
+// the row accessors treat arrays of colors as arrays of values
+static_assert(sizeof(Color4f) == 4 * sizeof(float), "Color4f has to consist of exactly four floats.");
+static_assert(sizeof(Color4ub) == 4 * sizeof(uint8_t), "Color4ub has to consist of exactly four bytes.");
+
 // -----------------------------------------------------------------------------------
 
 //! (static)
@@ -264,9 +323,12 @@ Reference<PixelAccessor> PixelAccessor::create(Reference<Bitmap> bitmap) {
 }
 
 void PixelAccessor::copy(PixelAccessor * source, PixelAccessor * dest){
-	for(uint32_t x = 0; x< std::min(source->getWidth(), dest->getWidth()); ++x)
-		for(uint32_t y = 0; y< std::min(source->getHeight(), dest->getHeight()); ++y)
-			dest->doWriteColor(x,y,source->doReadColor4f(x,y));
+	const uint32_t width = std::min(source->getWidth(), dest->getWidth());
+	std::vector<Color4f> row(width);
+	for(uint32_t y = 0; y< std::min(source->getHeight(), dest->getHeight()); ++y) {
+		source->doReadRow(y,0,width,row.data());
+		dest->doWriteRow(y,0,width,row.data());
+	}
 }
 
 
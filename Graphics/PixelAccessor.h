@@ -33,14 +33,18 @@ class AttributeAccessor;
 class PixelAccessor : public ReferenceCounter<PixelAccessor> {
 	private:
 		Reference<Bitmap> myBitmap;
+		uint32_t rowLength; //!< Number of pixels between the first pixels of two consecutive rows (pitch / pixel size)
 	protected:
 		bool checkRange(uint32_t x,uint32_t y) const { return x<myBitmap->getWidth() && y<myBitmap->getHeight(); }
+		bool checkRowRange(uint32_t x,uint32_t y,uint32_t count) const { return y<myBitmap->getHeight() && x<=myBitmap->getWidth() && count<=myBitmap->getWidth()-x; }
 		UTILAPI bool crop(uint32_t & x,uint32_t & y,uint32_t & width,uint32_t & height) const;
-		inline uint32_t getIndex(uint32_t x,uint32_t y) const { return (y * myBitmap->getWidth() + x); }
+		inline uint32_t getIndex(uint32_t x,uint32_t y) const { return (y * rowLength + x); }
 
 		PixelAccessor(Reference<Bitmap> bitmap) :
 			ReferenceCounter<PixelAccessor>(),
-			myBitmap(std::move(bitmap)) {
+			myBitmap(std::move(bitmap)),
+			rowLength(myBitmap->getPixelFormat().getDataSize() > 0 ?
+				static_cast<uint32_t>(myBitmap->getPitch() / myBitmap->getPixelFormat().getDataSize()) : myBitmap->getWidth()) {
 		}
 	public:
 		using Ref = Reference<PixelAccessor>;
@@ -67,6 +71,18 @@ class PixelAccessor : public ReferenceCounter<PixelAccessor> {
 		//! Write a single value to the bitmap (e.g., a value to the red channel for monochrome bitmaps).
 		inline void writeSingleValueFloat(uint32_t x, uint32_t y, float value);
 
+		/*! Read @p count consecutive pixels of row @p y, starting at column @p x.
+			The range is checked once for the whole span; missing channels are set to (0,0,0,1).
+			\note Specific PixelAccessors provide an optimized implementation */
+		inline void readRow(uint32_t y, uint32_t x, uint32_t count, Color4f * colors) const;
+		inline void readRow(uint32_t y, uint32_t x, uint32_t count, Color4ub * colors) const;
+		//! Write @p count consecutive pixels of row @p y, starting at column @p x.
+		inline void writeRow(uint32_t y, uint32_t x, uint32_t count, const Color4f * colors);
+		inline void writeRow(uint32_t y, uint32_t x, uint32_t count, const Color4ub * colors);
+
+		//! Returns the number of bytes between the first pixels of two consecutive rows (see @p Bitmap::getPitch).
+		uint64_t getRowStride() const { return myBitmap->getPitch(); }
+
 		/*! Fill the given area with the given color.
 			\note Specific PixelAccessors may provide an optimized implementation */
 		void fill(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const Color4f & c){
@@ -87,6 +103,11 @@ class PixelAccessor : public ReferenceCounter<PixelAccessor> {
 		template<typename _T> const _T * _ptr(const uint32_t x, const uint32_t y) const{
 			return reinterpret_cast<_T*>( myBitmap->data() + getIndex(x,y) * myBitmap->getPixelFormat().getDataSize() );
 		}
+
+		/*! Direct access to the first pixel of row @p y (see @p getRowStride).
+			\note Be careful: No boundary checks are performed! */
+		uint8_t * _rowPtr(const uint32_t y) { return myBitmap->data() + y * getRowStride(); }
+		const uint8_t * _rowPtr(const uint32_t y) const { return myBitmap->data() + y * getRowStride(); }
 	private:
 		//! ---o
 		virtual Color4f doReadColor4f(uint32_t x, uint32_t y) const = 0;
@@ -109,6 +130,18 @@ class PixelAccessor : public ReferenceCounter<PixelAccessor> {
 		//! ---o
 		virtual void doWriteSingleValueFloat(uint32_t x, uint32_t y, float value) = 0;
 
+		//! ---o
+		UTILAPI virtual void doReadRow(uint32_t y, uint32_t x, uint32_t count, Color4f * colors) const;
+
+		//! ---o
+		UTILAPI virtual void doReadRow(uint32_t y, uint32_t x, uint32_t count, Color4ub * colors) const;
+
+		//! ---o
+		UTILAPI virtual void doWriteRow(uint32_t y, uint32_t x, uint32_t count, const Color4f * colors);
+
+		//! ---o
+		UTILAPI virtual void doWriteRow(uint32_t y, uint32_t x, uint32_t count, const Color4ub * colors);
+
 		//! ---o
 		UTILAPI virtual void doFill(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const Color4f & c);
 };
@@ -159,6 +192,34 @@ inline void PixelAccessor::writeColor(uint32_t x, uint32_t y, const Color4ub & c
 		WARN("writeColor: out of range");
 }
 
+inline void PixelAccessor::readRow(uint32_t y, uint32_t x, uint32_t count, Color4f * colors) const {
+	if(checkRowRange(x,y,count))
+		doReadRow(y,x,count,colors);
+	else
+		WARN("readRow: out of range");
+}
+
+inline void PixelAccessor::readRow(uint32_t y, uint32_t x, uint32_t count, Color4ub * colors) const {
+	if(checkRowRange(x,y,count))
+		doReadRow(y,x,count,colors);
+	else
+		WARN("readRow: out of range");
+}
+
+inline void PixelAccessor::writeRow(uint32_t y, uint32_t x, uint32_t count, const Color4f * colors) {
+	if(checkRowRange(x,y,count))
+		doWriteRow(y,x,count,colors);
+	else
+		WARN("writeRow: out of range");
+}
+
+inline void PixelAccessor::writeRow(uint32_t y, uint32_t x, uint32_t count, const Color4ub * colors) {
+	if(checkRowRange(x,y,count))
+		doWriteRow(y,x,count,colors);
+	else
+		WARN("writeRow: out of range");
+}
+
 inline void PixelAccessor::writeSingleValueFloat(uint32_t x, uint32_t y, float value) {
 	if(checkRange(x, y)) {
 		doWriteSingleValueFloat(x, y, value);
@@ -29,10 +29,12 @@ namespace PixelFormat {
 	// default pixel formats
 	UTILAPI extern const AttributeFormat RG;			// 0xR_G_
 	UTILAPI extern const AttributeFormat RG_FLOAT;		// 0xR_______G_______
+	UTILAPI extern const AttributeFormat RG_HALF;		// 0xR___G___
 	UTILAPI extern const AttributeFormat RG_INT32;		// 0xR_______G_______
 	UTILAPI extern const AttributeFormat RG_UINT32;		// 0xR_______G_______
 	UTILAPI extern const AttributeFormat RGB;			// 0x00B_G_R_
 	UTILAPI extern const AttributeFormat RGB_FLOAT;		// 0xR_______G_______B_______
+	UTILAPI extern const AttributeFormat RGB_HALF;		// 0xR___G___B___
 	UTILAPI extern const AttributeFormat RGB_INT32;		// 0xR_______G_______B_______
 	UTILAPI extern const AttributeFormat RGB_UINT32;		// 0xR_______G_______B_______
 	UTILAPI extern const AttributeFormat BGR;			// 0x00R_G_B_
@@ -41,6 +43,7 @@ namespace PixelFormat {
 	UTILAPI extern const AttributeFormat BGR_UINT32;		// 0xB_______G_______R_______
 	UTILAPI extern const AttributeFormat RGBA;			// 0xA_B_G_R_
 	UTILAPI extern const AttributeFormat RGBA_FLOAT;	// 0xR_______G_______B_______A_______
+	UTILAPI extern const AttributeFormat RGBA_HALF;	// 0xR___G___B___A___
 	UTILAPI extern const AttributeFormat RGBA_INT32;	// 0xR_______G_______B_______A_______
 	UTILAPI extern const AttributeFormat RGBA_UINT32;	// 0xR_______G_______B_______A_______
 	UTILAPI extern const AttributeFormat BGRA;			// 0xA_R_G_B_
@@ -49,6 +52,7 @@ namespace PixelFormat {
 	UTILAPI extern const AttributeFormat BGRA_UINT32;	// 0xB_______G_______R_______A_______
 	UTILAPI extern const AttributeFormat MONO;			// 0xR_
 	UTILAPI extern const AttributeFormat MONO_FLOAT;	// 0xR_______
+	UTILAPI extern const AttributeFormat MONO_HALF;	// 0xR___
 	UTILAPI extern const AttributeFormat MONO_INT32;	// 0xR_______
 	UTILAPI extern const AttributeFormat MONO_UINT32;	// 0xR_______
 	UTILAPI extern const AttributeFormat R11G11B10_FLOAT;	
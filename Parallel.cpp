@@ -0,0 +1,146 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include "Parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+namespace Util {
+
+namespace {
+
+//! A set of tasks that is processed by the calling thread and up to @p maxHelpers worker threads.
+struct Job {
+	const std::function<void(uint64_t)>* task;
+	uint64_t taskCount;
+	uint32_t maxHelpers;
+	std::atomic<uint64_t> nextTask{0};
+	// guarded by the pool's mutex
+	uint32_t helpers = 0;
+	// guarded by doneMutex
+	uint64_t doneTasks = 0;
+	uint32_t activeHelpers = 0;
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+
+	//! Processes unclaimed tasks until all tasks are claimed and returns the number of processed tasks.
+	uint64_t process() {
+		uint64_t processed = 0;
+		for(uint64_t i = nextTask++; i < taskCount; i = nextTask++) {
+			(*task)(i);
+			++processed;
+		}
+		return processed;
+	}
+
+	bool isJoinable() const {
+		return helpers < maxHelpers && nextTask.load() < taskCount;
+	}
+};
+
+//---
+
+class WorkerPool {
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::deque<Job*> jobs;
+	std::vector<std::thread> workers;
+	bool stopping = false;
+
+	Job* findJoinableJob() const {
+		for(auto job : jobs) {
+			if(job->isJoinable())
+				return job;
+		}
+		return nullptr;
+	}
+
+	void work() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while(true) {
+			Job* job = nullptr;
+			jobAvailable.wait(lock, [&] { return stopping || (job = findJoinableJob()) != nullptr; });
+			if(stopping)
+				return;
+			++job->helpers;
+			{
+				// the job stays alive until activeHelpers drops to zero
+				std::lock_guard<std::mutex> doneLock(job->doneMutex);
+				++job->activeHelpers;
+			}
+			lock.unlock();
+			const uint64_t processed = job->process();
+			{
+				std::lock_guard<std::mutex> doneLock(job->doneMutex);
+				job->doneTasks += processed;
+				--job->activeHelpers;
+				job->doneCondition.notify_all();
+			}
+			lock.lock();
+		}
+	}
+
+public:
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		jobAvailable.notify_all();
+		for(auto& worker : workers)
+			worker.join();
+	}
+
+	void run(Job& job) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			while(workers.size() < job.maxHelpers)
+				workers.emplace_back(&WorkerPool::work, this);
+			jobs.push_back(&job);
+		}
+		jobAvailable.notify_all();
+
+		const uint64_t processed = job.process();
+		{
+			// no worker can join the job after it is removed from the queue
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+		}
+		std::unique_lock<std::mutex> doneLock(job.doneMutex);
+		job.doneTasks += processed;
+		job.doneCondition.wait(doneLock, [&] { return job.doneTasks == job.taskCount && job.activeHelpers == 0; });
+	}
+};
+
+WorkerPool& getWorkerPool() {
+	static WorkerPool pool;
+	return pool;
+}
+
+}
+
+//---
+
+void runParallelTasks(uint64_t taskCount, const std::function<void(uint64_t)>& task, uint32_t threadCount) {
+	threadCount = threadCount == 0 ? getDefaultThreadCount() : threadCount;
+	if(taskCount <= 1 || threadCount == 1) {
+		for(uint64_t i = 0; i < taskCount; ++i)
+			task(i);
+		return;
+	}
+	Job job;
+	job.task = &task;
+	job.taskCount = taskCount;
+	job.maxHelpers = static_cast<uint32_t>(std::min<uint64_t>(threadCount, taskCount) - 1);
+	getWorkerPool().run(job);
+}
+
+} /* Util */
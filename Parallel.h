@@ -0,0 +1,74 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_PARALLEL_H_
+#define UTIL_PARALLEL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Util {
+
+//! Returns the number of threads that are used by default for parallel operations (at least 1).
+inline uint32_t getDefaultThreadCount() {
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Calls @p task(i) for each i in [0, taskCount) using the library's persistent worker pool and blocks until all tasks are done.
+ * The calling thread processes tasks itself, so nested calls from within a task do not deadlock.
+ * The pool is created on first use and grows to the largest requested @p threadCount; its threads are reused by later calls.
+ * @param threadCount The maximum number of threads working on the tasks, including the calling thread (0 = @p getDefaultThreadCount()).
+ * @note @p task must not throw.
+ */
+UTILAPI void runParallelTasks(uint64_t taskCount, const std::function<void(uint64_t)>& task, uint32_t threadCount=0);
+
+/**
+ * Splits the range [begin, end) into contiguous chunks and calls @p fn(chunkBegin, chunkEnd) for each chunk in parallel.
+ * The chunks are processed by the calling thread and the worker pool of @p runParallelTasks(). Exceptions thrown by @p fn are rethrown after all chunks are processed.
+ * @param grainSize The minimum number of indices per chunk. Small ranges are processed by the calling thread only.
+ * @param threadCount The maximum number of threads (0 = @p getDefaultThreadCount()).
+ */
+template<typename Fn>
+void parallelFor(uint64_t begin, uint64_t end, uint64_t grainSize, const Fn& fn, uint32_t threadCount=0) {
+	if(begin >= end)
+		return;
+	const uint64_t count = end - begin;
+	threadCount = threadCount == 0 ? getDefaultThreadCount() : threadCount;
+	const uint64_t chunkCount = std::max<uint64_t>(1, std::min<uint64_t>(threadCount, count / std::max<uint64_t>(grainSize, 1)));
+	if(chunkCount == 1) {
+		fn(begin, end);
+		return;
+	}
+	const uint64_t chunkSize = (count + chunkCount - 1) / chunkCount;
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+	const auto run = [&](uint64_t chunkBegin, uint64_t chunkEnd) {
+		try {
+			fn(chunkBegin, chunkEnd);
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(exceptionMutex);
+			if(!exception)
+				exception = std::current_exception();
+		}
+	};
+	runParallelTasks((count + chunkSize - 1) / chunkSize, [&](uint64_t chunk) {
+		const uint64_t chunkBegin = begin + chunk * chunkSize;
+		run(chunkBegin, std::min(end, chunkBegin + chunkSize));
+	}, threadCount);
+	if(exception)
+		std::rethrow_exception(exception);
+}
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_PARALLEL_H_ */
@@ -8,6 +8,7 @@
 */
 
 #include "AttributeAccessor.h"
+#include "AttributeConversion.h"
 #include "ResourceFormat.h"
 
 #include "../Macros.h"
@@ -18,11 +19,12 @@
 #include <cstring>
 #include <unordered_map>
 #include <algorithm>
+#include <type_traits>
 
 namespace Util {
 
-static std::unordered_map<uint8_t, AttributeAccessor::AccessorFactory_t>& getAccessorRegistry() {
-	static std::unordered_map<uint8_t, AttributeAccessor::AccessorFactory_t> registry;
+static std::unordered_map<uint32_t, AttributeAccessor::AccessorFactory_t>& getAccessorRegistry() {
+	static std::unordered_map<uint32_t, AttributeAccessor::AccessorFactory_t> registry;
 	return registry;
 }
 
@@ -51,6 +53,44 @@ public:
 		std::transform(values, values + count, v, [](S v) { return static_cast<T>(v);});
 	}
 	
+	template<typename S>
+	void _readRange(uint64_t firstIndex, uint64_t elementCount, S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		const uint8_t* src = _ptr<const uint8_t>(firstIndex);
+		if(std::is_same<S,T>::value && valueStride == components && stride == components*sizeof(T)) {
+			std::memcpy(values, src, elementCount*stride);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, src += stride, values += valueStride) {
+			const T* v = reinterpret_cast<const T*>(src);
+			for(uint64_t c=0; c<count; ++c)
+				values[c] = static_cast<S>(v[c]);
+		}
+	}
+	
+	template<typename S>
+	void _writeRange(uint64_t firstIndex, uint64_t elementCount, const S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		uint8_t* tgt = _ptr<uint8_t>(firstIndex);
+		if(std::is_same<S,T>::value && valueStride == components && stride == components*sizeof(T)) {
+			std::memcpy(tgt, values, elementCount*stride);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, tgt += stride, values += valueStride) {
+			T* v = reinterpret_cast<T*>(tgt);
+			for(uint64_t c=0; c<count; ++c)
+				v[c] = static_cast<T>(values[c]);
+		}
+	}
+	
 	virtual void readValues(uint64_t index, int8_t* values, uint64_t count) const { _readValues(index, values, count); }
 	virtual void readValues(uint64_t index, int16_t* values, uint64_t count) const { _readValues(index, values, count); }
 	virtual void readValues(uint64_t index, int32_t* values, uint64_t count) const { _readValues(index, values, count); }
@@ -71,8 +111,51 @@ public:
 	virtual void writeValues(uint64_t index, const uint64_t* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const float* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const double* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
 };
 
+//-------------------------------------------------------------
+// conversion of contiguous normalized values (uses vectorized kernels for common type combinations)
+
+template<typename T, typename S>
+static void convertUnsignedNormalized(const T* values, S* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = unnormalizeUnsigned<S>(normalizeUnsigned<T>(values[i]));
+}
+static void convertUnsignedNormalized(const uint8_t* values, float* target, uint64_t count) { AttributeConversion::normalizeUnsigned(values, target, count); }
+static void convertUnsignedNormalized(const uint16_t* values, float* target, uint64_t count) { AttributeConversion::normalizeUnsigned(values, target, count); }
+static void convertUnsignedNormalized(const float* values, uint8_t* target, uint64_t count) { AttributeConversion::unnormalizeUnsigned(values, target, count); }
+static void convertUnsignedNormalized(const float* values, uint16_t* target, uint64_t count) { AttributeConversion::unnormalizeUnsigned(values, target, count); }
+
+template<typename T, typename S>
+static void convertSignedNormalized(const T* values, S* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = unnormalizeSigned<S>(normalizeSigned<T>(values[i]));
+}
+static void convertSignedNormalized(const int8_t* values, float* target, uint64_t count) { AttributeConversion::normalizeSigned(values, target, count); }
+static void convertSignedNormalized(const int16_t* values, float* target, uint64_t count) { AttributeConversion::normalizeSigned(values, target, count); }
+static void convertSignedNormalized(const float* values, int8_t* target, uint64_t count) { AttributeConversion::unnormalizeSigned(values, target, count); }
+static void convertSignedNormalized(const float* values, int16_t* target, uint64_t count) { AttributeConversion::unnormalizeSigned(values, target, count); }
+
 //-------------------------------------------------------------
 // UnsignedNormalizedAttributeAccessor
 
@@ -86,18 +169,46 @@ public:
 	void _readValues(uint64_t index, S* values, uint64_t count) const {
 		assertRange(index);
 		count = std::min<uint64_t>(count, getAttribute().getComponentCount());
-		const T* v = _ptr<const T>(index);
-		for(uint64_t i=0; i<count; ++i)
-			*(values+i) = unnormalizeUnsigned<S>(normalizeUnsigned<T>(*(v+i)));
+		convertUnsignedNormalized(_ptr<const T>(index), values, count);
 	}
 	
 	template<typename S>
 	void _writeValues(uint64_t index, const S* values, uint64_t count) const {
 		assertRange(index);
 		count = std::min<uint64_t>(count, getAttribute().getComponentCount());
-		T* v = _ptr<T>(index);
-		for(uint64_t i=0; i<count; ++i)
-			*(v+i) = unnormalizeUnsigned<T>(normalizeUnsigned<S>(*(values+i)));
+		convertUnsignedNormalized(values, _ptr<T>(index), count);
+	}
+	
+	template<typename S>
+	void _readRange(uint64_t firstIndex, uint64_t elementCount, S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		const uint8_t* src = _ptr<const uint8_t>(firstIndex);
+		if(valueStride == components && stride == components*sizeof(T)) {
+			convertUnsignedNormalized(reinterpret_cast<const T*>(src), values, elementCount*components);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, src += stride, values += valueStride)
+			convertUnsignedNormalized(reinterpret_cast<const T*>(src), values, count);
+	}
+	
+	template<typename S>
+	void _writeRange(uint64_t firstIndex, uint64_t elementCount, const S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		uint8_t* tgt = _ptr<uint8_t>(firstIndex);
+		if(valueStride == components && stride == components*sizeof(T)) {
+			convertUnsignedNormalized(values, reinterpret_cast<T*>(tgt), elementCount*components);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, tgt += stride, values += valueStride)
+			convertUnsignedNormalized(values, reinterpret_cast<T*>(tgt), count);
 	}
 		
 	virtual void readValues(uint64_t index, int8_t* values, uint64_t count) const { _readValues(index, values, count); }
@@ -120,6 +231,26 @@ public:
 	virtual void writeValues(uint64_t index, const uint64_t* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const float* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const double* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
 };
 
 //-------------------------------------------------------------
@@ -135,18 +266,46 @@ public:
 	void _readValues(uint64_t index, S* values, uint64_t count) const {
 		assertRange(index);
 		count = std::min<uint64_t>(count, getAttribute().getComponentCount());
-		const T* v = _ptr<const T>(index);
-		for(uint64_t i=0; i<count; ++i)
-			*(values+i) = unnormalizeSigned<S>(normalizeSigned<T>(*(v+i)));
+		convertSignedNormalized(_ptr<const T>(index), values, count);
 	}
 	
 	template<typename S>
 	void _writeValues(uint64_t index, const S* values, uint64_t count) const {
 		assertRange(index);
 		count = std::min<uint64_t>(count, getAttribute().getComponentCount());
-		T* v = _ptr<T>(index);
-		for(uint64_t i=0; i<count; ++i)
-			*(v+i) = unnormalizeSigned<T>(normalizeSigned<S>(*(values+i)));
+		convertSignedNormalized(values, _ptr<T>(index), count);
+	}
+	
+	template<typename S>
+	void _readRange(uint64_t firstIndex, uint64_t elementCount, S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		const uint8_t* src = _ptr<const uint8_t>(firstIndex);
+		if(valueStride == components && stride == components*sizeof(T)) {
+			convertSignedNormalized(reinterpret_cast<const T*>(src), values, elementCount*components);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, src += stride, values += valueStride)
+			convertSignedNormalized(reinterpret_cast<const T*>(src), values, count);
+	}
+	
+	template<typename S>
+	void _writeRange(uint64_t firstIndex, uint64_t elementCount, const S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		uint8_t* tgt = _ptr<uint8_t>(firstIndex);
+		if(valueStride == components && stride == components*sizeof(T)) {
+			convertSignedNormalized(values, reinterpret_cast<T*>(tgt), elementCount*components);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, tgt += stride, values += valueStride)
+			convertSignedNormalized(values, reinterpret_cast<T*>(tgt), count);
 	}
 		
 	virtual void readValues(uint64_t index, int8_t* values, uint64_t count) const { _readValues(index, values, count); }
@@ -169,48 +328,216 @@ public:
 	virtual void writeValues(uint64_t index, const uint64_t* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const float* values, uint64_t count) const { _writeValues(index, values, count); }
 	virtual void writeValues(uint64_t index, const double* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+};
+
+//-------------------------------------------------------------
+// Float16AttributeAccessor (half and bfloat16)
+
+struct HalfConversion {
+	static void toFloat(const uint16_t* values, float* target, uint64_t count) { AttributeConversion::halfToFloat(values, target, count); }
+	static void fromFloat(const float* values, uint16_t* target, uint64_t count) { AttributeConversion::floatToHalf(values, target, count); }
+};
+
+struct BFloat16Conversion {
+	static void toFloat(const uint16_t* values, float* target, uint64_t count) { AttributeConversion::bfloat16ToFloat(values, target, count); }
+	static void fromFloat(const float* values, uint16_t* target, uint64_t count) { AttributeConversion::floatToBfloat16(values, target, count); }
+};
+
+static const uint64_t FLOAT16_BUFFER_SIZE = 256;
+
+//! Converts 16 bit floats to S (through a small float buffer if S is not float).
+template<class Conversion_t, typename S>
+static void convertFromFloat16(const uint16_t* values, S* target, uint64_t count) {
+	if(std::is_same<S,float>::value) {
+		Conversion_t::toFloat(values, reinterpret_cast<float*>(target), count);
+		return;
+	}
+	float buffer[FLOAT16_BUFFER_SIZE];
+	for(uint64_t i=0; i<count; i+=FLOAT16_BUFFER_SIZE) {
+		const uint64_t n = std::min(FLOAT16_BUFFER_SIZE, count-i);
+		Conversion_t::toFloat(values+i, buffer, n);
+		std::transform(buffer, buffer + n, target + i, [](float v) { return static_cast<S>(v);});
+	}
+}
+
+//! Converts S to 16 bit floats (through a small float buffer if S is not float).
+template<class Conversion_t, typename S>
+static void convertToFloat16(const S* values, uint16_t* target, uint64_t count) {
+	if(std::is_same<S,float>::value) {
+		Conversion_t::fromFloat(reinterpret_cast<const float*>(values), target, count);
+		return;
+	}
+	float buffer[FLOAT16_BUFFER_SIZE];
+	for(uint64_t i=0; i<count; i+=FLOAT16_BUFFER_SIZE) {
+		const uint64_t n = std::min(FLOAT16_BUFFER_SIZE, count-i);
+		std::transform(values + i, values + i + n, buffer, [](S v) { return static_cast<float>(v);});
+		Conversion_t::fromFloat(buffer, target+i, n);
+	}
+}
+
+template<class Conversion_t>
+class Float16AttributeAccessor : public AttributeAccessor {
+public:
+	Float16AttributeAccessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) :
+		AttributeAccessor(ptr, size, attr, stride) {}
+	
+	template<typename S>
+	void _readValues(uint64_t index, S* values, uint64_t count) const {
+		assertRange(index);
+		count = std::min<uint64_t>(count, getAttribute().getComponentCount());
+		convertFromFloat16<Conversion_t>(_ptr<const uint16_t>(index), values, count);
+	}
+	
+	template<typename S>
+	void _writeValues(uint64_t index, const S* values, uint64_t count) const {
+		assertRange(index);
+		count = std::min<uint64_t>(count, getAttribute().getComponentCount());
+		convertToFloat16<Conversion_t>(values, _ptr<uint16_t>(index), count);
+	}
+	
+	template<typename S>
+	void _readRange(uint64_t firstIndex, uint64_t elementCount, S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		const uint8_t* src = _ptr<const uint8_t>(firstIndex);
+		if(valueStride == components && stride == components*sizeof(uint16_t)) {
+			convertFromFloat16<Conversion_t>(reinterpret_cast<const uint16_t*>(src), values, elementCount*components);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, src += stride, values += valueStride)
+			convertFromFloat16<Conversion_t>(reinterpret_cast<const uint16_t*>(src), values, count);
+	}
+	
+	template<typename S>
+	void _writeRange(uint64_t firstIndex, uint64_t elementCount, const S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		const uint64_t components = getAttribute().getComponentCount();
+		valueStride = valueStride == 0 ? components : valueStride;
+		const uint64_t count = std::min<uint64_t>(valueStride, components);
+		const uint64_t stride = getStride();
+		uint8_t* tgt = _ptr<uint8_t>(firstIndex);
+		if(valueStride == components && stride == components*sizeof(uint16_t)) {
+			convertToFloat16<Conversion_t>(values, reinterpret_cast<uint16_t*>(tgt), elementCount*components);
+			return;
+		}
+		for(uint64_t i=0; i<elementCount; ++i, tgt += stride, values += valueStride)
+			convertToFloat16<Conversion_t>(values, reinterpret_cast<uint16_t*>(tgt), count);
+	}
+	
+	virtual void readValues(uint64_t index, int8_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, int16_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, int32_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, int64_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint8_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint16_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint32_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint64_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, float* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, double* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int8_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int16_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int32_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int64_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint8_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint16_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint32_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint64_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const float* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const double* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
 };
 
 //-------------------------------------------------------------
 // AttributeAccessor
 
-Reference<AttributeAccessor> AttributeAccessor::create(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) {
+template<class Accessor_t>
+static Reference<AttributeAccessor> createAccessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) {
+	return new Accessor_t(ptr, size, attr, stride);
+}
+
+//-------------
+
+AttributeAccessor::AccessorFactory_t AttributeAccessor::getAccessorFactory(const AttributeFormat& attr) {
 	
 	if(attr.getInternalType() != 0) {
 		const auto& registry = getAccessorRegistry();
 		auto factory = registry.find(attr.getInternalType());
 		if(factory != registry.end()) {
-			return factory->second(ptr, size, attr, stride);
+			return factory->second;
 		}
 		WARN("AttributeAccessor: No accessor found for internal type " + StringUtils::toString(attr.getInternalType()) + ". Using default accessor.");
 	}
 
 	if(attr.isNormalized()) {
 		switch (attr.getDataType()) {
-			case TypeConstant::UINT8: return new UnsignedNormalizedAttributeAccessor<uint8_t>(ptr, size, attr, stride);
-			case TypeConstant::UINT16: return new UnsignedNormalizedAttributeAccessor<uint16_t>(ptr, size, attr, stride);
-			case TypeConstant::UINT32: return new UnsignedNormalizedAttributeAccessor<uint32_t>(ptr, size, attr, stride);
-			case TypeConstant::UINT64: return new UnsignedNormalizedAttributeAccessor<uint64_t>(ptr, size, attr, stride);
-			case TypeConstant::INT8: return new SignedNormalizedAttributeAccessor<int8_t>(ptr, size, attr, stride);
-			case TypeConstant::INT16: return new SignedNormalizedAttributeAccessor<int16_t>(ptr, size, attr, stride);
-			case TypeConstant::INT32: return new SignedNormalizedAttributeAccessor<int32_t>(ptr, size, attr, stride);
-			case TypeConstant::INT64: return new SignedNormalizedAttributeAccessor<int64_t>(ptr, size, attr, stride);
-			case TypeConstant::FLOAT: return new SignedNormalizedAttributeAccessor<float>(ptr, size, attr, stride);
-			case TypeConstant::DOUBLE: return new SignedNormalizedAttributeAccessor<double>(ptr, size, attr, stride);
+			case TypeConstant::UINT8: return createAccessor<UnsignedNormalizedAttributeAccessor<uint8_t>>;
+			case TypeConstant::UINT16: return createAccessor<UnsignedNormalizedAttributeAccessor<uint16_t>>;
+			case TypeConstant::UINT32: return createAccessor<UnsignedNormalizedAttributeAccessor<uint32_t>>;
+			case TypeConstant::UINT64: return createAccessor<UnsignedNormalizedAttributeAccessor<uint64_t>>;
+			case TypeConstant::INT8: return createAccessor<SignedNormalizedAttributeAccessor<int8_t>>;
+			case TypeConstant::INT16: return createAccessor<SignedNormalizedAttributeAccessor<int16_t>>;
+			case TypeConstant::INT32: return createAccessor<SignedNormalizedAttributeAccessor<int32_t>>;
+			case TypeConstant::INT64: return createAccessor<SignedNormalizedAttributeAccessor<int64_t>>;
+			case TypeConstant::FLOAT: return createAccessor<SignedNormalizedAttributeAccessor<float>>;
+			case TypeConstant::DOUBLE: return createAccessor<SignedNormalizedAttributeAccessor<double>>;
 			default: break;
 		}
 	} else {
 		switch (attr.getDataType()) {
-			case TypeConstant::UINT8: return new StandardAttributeAccessor<uint8_t>(ptr, size, attr, stride);
-			case TypeConstant::UINT16: return new StandardAttributeAccessor<uint16_t>(ptr, size, attr, stride);
-			case TypeConstant::UINT32: return new StandardAttributeAccessor<uint32_t>(ptr, size, attr, stride);
-			case TypeConstant::UINT64: return new StandardAttributeAccessor<uint64_t>(ptr, size, attr, stride);
-			case TypeConstant::INT8: return new StandardAttributeAccessor<int8_t>(ptr, size, attr, stride);
-			case TypeConstant::INT16: return new StandardAttributeAccessor<int16_t>(ptr, size, attr, stride);
-			case TypeConstant::INT32: return new StandardAttributeAccessor<int32_t>(ptr, size, attr, stride);
-			case TypeConstant::INT64: return new StandardAttributeAccessor<int64_t>(ptr, size, attr, stride);
-			case TypeConstant::FLOAT: return new StandardAttributeAccessor<float>(ptr, size, attr, stride);
-			case TypeConstant::DOUBLE: return new StandardAttributeAccessor<double>(ptr, size, attr, stride);
+			case TypeConstant::UINT8: return createAccessor<StandardAttributeAccessor<uint8_t>>;
+			case TypeConstant::UINT16: return createAccessor<StandardAttributeAccessor<uint16_t>>;
+			case TypeConstant::UINT32: return createAccessor<StandardAttributeAccessor<uint32_t>>;
+			case TypeConstant::UINT64: return createAccessor<StandardAttributeAccessor<uint64_t>>;
+			case TypeConstant::INT8: return createAccessor<StandardAttributeAccessor<int8_t>>;
+			case TypeConstant::INT16: return createAccessor<StandardAttributeAccessor<int16_t>>;
+			case TypeConstant::INT32: return createAccessor<StandardAttributeAccessor<int32_t>>;
+			case TypeConstant::INT64: return createAccessor<StandardAttributeAccessor<int64_t>>;
+			case TypeConstant::FLOAT: return createAccessor<StandardAttributeAccessor<float>>;
+			case TypeConstant::DOUBLE: return createAccessor<StandardAttributeAccessor<double>>;
+			case TypeConstant::HALF: return createAccessor<Float16AttributeAccessor<HalfConversion>>;
+			case TypeConstant::BFLOAT16: return createAccessor<Float16AttributeAccessor<BFloat16Conversion>>;
 			default: break;
 		}
 	}
@@ -221,6 +548,13 @@ Reference<AttributeAccessor> AttributeAccessor::create(uint8_t* ptr, uint64_t si
 
 //-------------
 
+Reference<AttributeAccessor> AttributeAccessor::create(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) {
+	const auto factory = getAccessorFactory(attr);
+	return factory ? factory(ptr, size, attr, stride) : nullptr;
+}
+
+//-------------
+
 Reference<AttributeAccessor> AttributeAccessor::create(uint8_t* ptr, uint64_t size, const ResourceFormat& format, const StringIdentifier& name) {
 	return format.hasAttribute(name) ? create(ptr, size, format.getAttribute(name), format.getSize()) : nullptr;
 }
@@ -239,7 +573,8 @@ bool AttributeAccessor::hasAccessor(const AttributeFormat& attr) {
 		const auto& registry = getAccessorRegistry();
 		return registry.find(attr.getInternalType()) != registry.end();
 	} else {
-		return attr.getDataType() != TypeConstant::HALF;
+		const auto type = attr.getDataType();
+		return !attr.isNormalized() || (type != TypeConstant::HALF && type != TypeConstant::BFLOAT16);
 	}
 }
 
@@ -262,5 +597,54 @@ void AttributeAccessor::writeRaw(uint64_t index, const uint8_t* data, uint64_t s
 	std::copy(data, data + size, ptr);
 }
 
+//-------------
+
+template<typename S>
+static void readRangeDefault(const AttributeAccessor& acc, uint64_t firstIndex, uint64_t elementCount, S* values, uint64_t valueStride) {
+	if(elementCount == 0)
+		return;
+	const uint64_t components = acc.getValueCount();
+	valueStride = valueStride == 0 ? components : valueStride;
+	const uint64_t count = std::min<uint64_t>(valueStride, components);
+	for(uint64_t i=0; i<elementCount; ++i, values += valueStride)
+		acc.readValues(firstIndex+i, values, count);
+}
+
+//-------------
+
+template<typename S>
+static void writeRangeDefault(const AttributeAccessor& acc, uint64_t firstIndex, uint64_t elementCount, const S* values, uint64_t valueStride) {
+	if(elementCount == 0)
+		return;
+	const uint64_t components = acc.getValueCount();
+	valueStride = valueStride == 0 ? components : valueStride;
+	const uint64_t count = std::min<uint64_t>(valueStride, components);
+	for(uint64_t i=0; i<elementCount; ++i, values += valueStride)
+		acc.writeValues(firstIndex+i, values, count);
+}
+
+//-------------
+
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); readRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+void AttributeAccessor::writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride) const { assertRange(firstIndex, elementCount); writeRangeDefault(*this, firstIndex, elementCount, values, valueStride); }
+
 //-------------
 } /* Util */
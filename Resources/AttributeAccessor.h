@@ -16,6 +16,7 @@
 #include <vector>
 #include <cstdlib>
 #include <functional>
+#include <limits>
 #include <sstream>
 
 namespace Util {
@@ -37,6 +38,14 @@ protected:
 			throw std::range_error(s.str());
 		}
 	 }
+	 
+	inline void assertRange(uint64_t index, uint64_t count) const { 
+		if(!checkRange(index, count)) {
+			std::ostringstream s;
+			s << "Trying to access attributes at indices [" << index << ", " << (index+count) << ") of overall " << (dataSize/stride) << " indices.";
+			throw std::range_error(s.str());
+		}
+	 }
 public:
 	using Ref = Reference<AttributeAccessor>;
 	virtual ~AttributeAccessor() = default;
@@ -52,6 +61,13 @@ public:
 	UTILAPI static bool registerAccessor(uint32_t internalType, const AccessorFactory_t& factory);
 	UTILAPI static bool hasAccessor(const AttributeFormat& attr);
 	
+	/**
+	* Returns the factory that creates accessors for the given attribute.
+	* This allows to resolve the accessor type once and create accessors for different data pointers afterwards.
+	* @return The factory, or an empty function if there is no accessor for the attribute.
+	*/
+	UTILAPI static AccessorFactory_t getAccessorFactory(const AttributeFormat& attr);
+	
 	UTILAPI void readRaw(uint64_t index, uint8_t* data, uint64_t size) const;
 	virtual void readValues(uint64_t index, int8_t* values, uint64_t count) const = 0;
 	virtual void readValues(uint64_t index, int16_t* values, uint64_t count) const = 0;
@@ -81,11 +97,29 @@ public:
 	*/
 	template<typename T> 
 	std::vector<T> readValues(uint64_t index) {
-		std::vector<T> values(attribute.getComponentCount());
+		std::vector<T> values(getValueCount());
 		readValues(index, values.data(), values.size());
 		return values;
 	}
 	
+	/**
+	* Reads the values of @p elementCount consecutive elements, starting at element @p firstIndex.
+	* The range is validated once for the whole batch and the values are internally converted to the correct type.
+	* @param values Target array, which needs to hold at least @p elementCount * @p valueStride values.
+	* @param valueStride Number of values between two consecutive elements in @p values (0 = number of components).
+	* @note For each element at most min(valueStride, component count) values are read.
+	*/
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride=0) const;
+	
 	void writeRaw(uint64_t index, const uint8_t* data, uint64_t size) const;
 	virtual void writeValues(uint64_t index, const int8_t* values, uint64_t count) const = 0;
 	virtual void writeValues(uint64_t index, const int16_t* values, uint64_t count) const = 0;
@@ -116,15 +150,44 @@ public:
 		writeValues(index, values.data(), values.size());
 	}
 	
+	/**
+	* Writes the values of @p elementCount consecutive elements, starting at element @p firstIndex.
+	* The range is validated once for the whole batch and the values are internally converted to the correct type.
+	* @param values Source array, which needs to hold at least @p elementCount * @p valueStride values.
+	* @param valueStride Number of values between two consecutive elements in @p values (0 = number of components).
+	* @note For each element at most min(valueStride, component count) values are written.
+	*/
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride=0) const;
+	UTILAPI virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride=0) const;
+	
 	/**
 	* Returns the resource format attribute this accessor is associated with. 
 	*/
 	const AttributeFormat& getAttribute() const { return attribute; }
+
+	/**
+	* Returns the number of values per element that are read or written through this accessor.
+	* This is the component count of the attribute, except for packed attributes (e.g., 3 for a unit vector packed into two 16 bit integers).
+	*/
+	virtual uint32_t getValueCount() const { return attribute.getComponentCount(); }
 	
 	/**
 	* Checks whether the @p index is in range. 
 	*/
-	inline bool checkRange(uint64_t index) const { return index*stride<dataSize; }
+	inline bool checkRange(uint64_t index) const { return index<getIndexCount(); }
+	
+	/**
+	* Checks whether all @p count elements starting at @p index are in range. 
+	*/
+	inline bool checkRange(uint64_t index, uint64_t count) const { return count == 0 || (index<getIndexCount() && count<=getIndexCount()-index); }
 	
 	/**
 	* Returns the raw data pointer to the resource attribute at the given index. 
@@ -134,7 +197,17 @@ public:
 
 	//! Get the size in bytes of the accessed data.
 	uint64_t getDataSize() const { return dataSize; }
+
+	//! Get the number of bytes between two consecutive elements.
+	uint64_t getStride() const { return stride; }
 private:
+	//! Number of valid indices, i.e., of elements that start within the accessed data (computed without overflow).
+	uint64_t getIndexCount() const {
+		if(stride == 0)
+			return dataSize > 0 ? std::numeric_limits<uint64_t>::max() : 0;
+		return dataSize/stride + (dataSize%stride != 0 ? 1 : 0);
+	}
+
 	uint8_t* const dataPtr;
 	const uint64_t dataSize;
 	const AttributeFormat attribute;
@@ -0,0 +1,938 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "AttributeConversion.h"
+#include "AttributeAccessor.h"
+#include "../Utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define UTIL_CONVERSION_SSE2
+	#include <emmintrin.h>
+	#if defined(__GNUC__) || defined(__clang__)
+		// AVX2 kernels are compiled with a function specific target and selected at runtime.
+		#define UTIL_CONVERSION_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
+namespace Util {
+namespace AttributeConversion {
+
+//-------------------------------------------------------------
+// scalar kernels (reference implementation)
+
+template<typename T>
+static void normalizeUnsignedScalar(const T* values, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = Util::unnormalizeUnsigned<float>(Util::normalizeUnsigned<T>(values[i]));
+}
+
+template<typename T>
+static void normalizeSignedScalar(const T* values, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = Util::unnormalizeSigned<float>(Util::normalizeSigned<T>(values[i]));
+}
+
+template<typename T>
+static void unnormalizeUnsignedScalar(const float* values, T* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = Util::unnormalizeUnsigned<T>(Util::normalizeUnsigned<float>(values[i]));
+}
+
+template<typename T>
+static void unnormalizeSignedScalar(const float* values, T* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = Util::unnormalizeSigned<T>(Util::normalizeSigned<float>(values[i]));
+}
+
+/* Notes on exactness:
+ * - Reading: The scalar code computes float(double(v)/max). As both operands are exactly representable
+ *   as float, the division in single precision yields the identical result (double rounding is innocuous
+ *   for division if the intermediate precision has at least 2p+2 bits).
+ * - Writing: The scalar code computes T(double(clamp(f))*max) with truncation. The product of a float and
+ *   a 16 bit integer is exact in double precision but not in single precision, so the vectorized kernels
+ *   convert to double before scaling.
+ * - The clamping order matches std::min(max, std::max(min, v)), i.e., NaN is mapped to the lower bound.
+ */
+
+#ifdef UTIL_CONVERSION_SSE2
+//-------------------------------------------------------------
+// SSE2 kernels
+
+static inline void storeNormalized4_SSE2(float* target, __m128i v, __m128 scale) {
+	_mm_storeu_ps(target, _mm_div_ps(_mm_cvtepi32_ps(v), scale));
+}
+
+static inline void storeNormalizedSigned4_SSE2(float* target, __m128i v, __m128 scale) {
+	_mm_storeu_ps(target, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(v), scale), _mm_set1_ps(-1.0f)));
+}
+
+//! clamp 4 floats and scale them in double precision to 4 (truncated) int32 values
+static inline __m128i unnormalize4_SSE2(const float* values, __m128 lo, __m128 hi, __m128d scale) {
+	const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values), lo), hi);
+	const __m128d d0 = _mm_mul_pd(_mm_cvtps_pd(v), scale);
+	const __m128d d1 = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), scale);
+	return _mm_unpacklo_epi64(_mm_cvttpd_epi32(d0), _mm_cvttpd_epi32(d1));
+}
+
+static void normalizeU8_SSE2(const uint8_t* values, float* target, uint64_t count) {
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128i zero = _mm_setzero_si128();
+	uint64_t i = 0;
+	for(; i+16<=count; i+=16) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		const __m128i lo = _mm_unpacklo_epi8(v, zero);
+		const __m128i hi = _mm_unpackhi_epi8(v, zero);
+		storeNormalized4_SSE2(target+i, _mm_unpacklo_epi16(lo, zero), scale);
+		storeNormalized4_SSE2(target+i+4, _mm_unpackhi_epi16(lo, zero), scale);
+		storeNormalized4_SSE2(target+i+8, _mm_unpacklo_epi16(hi, zero), scale);
+		storeNormalized4_SSE2(target+i+12, _mm_unpackhi_epi16(hi, zero), scale);
+	}
+	normalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+static void normalizeU16_SSE2(const uint16_t* values, float* target, uint64_t count) {
+	const __m128 scale = _mm_set1_ps(65535.0f);
+	const __m128i zero = _mm_setzero_si128();
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		storeNormalized4_SSE2(target+i, _mm_unpacklo_epi16(v, zero), scale);
+		storeNormalized4_SSE2(target+i+4, _mm_unpackhi_epi16(v, zero), scale);
+	}
+	normalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+static void normalizeI8_SSE2(const int8_t* values, float* target, uint64_t count) {
+	const __m128 scale = _mm_set1_ps(127.0f);
+	uint64_t i = 0;
+	for(; i+16<=count; i+=16) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		// sign extension by interleaving with itself and shifting arithmetically
+		const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+		const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+		storeNormalizedSigned4_SSE2(target+i, _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16), scale);
+		storeNormalizedSigned4_SSE2(target+i+4, _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16), scale);
+		storeNormalizedSigned4_SSE2(target+i+8, _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16), scale);
+		storeNormalizedSigned4_SSE2(target+i+12, _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16), scale);
+	}
+	normalizeSignedScalar(values+i, target+i, count-i);
+}
+
+static void normalizeI16_SSE2(const int16_t* values, float* target, uint64_t count) {
+	const __m128 scale = _mm_set1_ps(32767.0f);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		storeNormalizedSigned4_SSE2(target+i, _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), scale);
+		storeNormalizedSigned4_SSE2(target+i+4, _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16), scale);
+	}
+	normalizeSignedScalar(values+i, target+i, count-i);
+}
+
+static void unnormalizeU8_SSE2(const float* values, uint8_t* target, uint64_t count) {
+	const __m128 lo = _mm_set1_ps(0.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128d scale = _mm_set1_pd(255.0);
+	uint64_t i = 0;
+	for(; i+16<=count; i+=16) {
+		const __m128i v0 = unnormalize4_SSE2(values+i, lo, hi, scale);
+		const __m128i v1 = unnormalize4_SSE2(values+i+4, lo, hi, scale);
+		const __m128i v2 = unnormalize4_SSE2(values+i+8, lo, hi, scale);
+		const __m128i v3 = unnormalize4_SSE2(values+i+12, lo, hi, scale);
+		const __m128i v = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), v);
+	}
+	unnormalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+static void unnormalizeU16_SSE2(const float* values, uint16_t* target, uint64_t count) {
+	const __m128 lo = _mm_set1_ps(0.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128d scale = _mm_set1_pd(65535.0);
+	// SSE2 has no unsigned saturating 32->16 bit pack: shift into the signed range and back
+	const __m128i bias32 = _mm_set1_epi32(32768);
+	const __m128i bias16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		const __m128i v0 = _mm_sub_epi32(unnormalize4_SSE2(values+i, lo, hi, scale), bias32);
+		const __m128i v1 = _mm_sub_epi32(unnormalize4_SSE2(values+i+4, lo, hi, scale), bias32);
+		const __m128i v = _mm_xor_si128(_mm_packs_epi32(v0, v1), bias16);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), v);
+	}
+	unnormalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+static void unnormalizeI8_SSE2(const float* values, int8_t* target, uint64_t count) {
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128d scale = _mm_set1_pd(127.0);
+	uint64_t i = 0;
+	for(; i+16<=count; i+=16) {
+		const __m128i v0 = unnormalize4_SSE2(values+i, lo, hi, scale);
+		const __m128i v1 = unnormalize4_SSE2(values+i+4, lo, hi, scale);
+		const __m128i v2 = unnormalize4_SSE2(values+i+8, lo, hi, scale);
+		const __m128i v3 = unnormalize4_SSE2(values+i+12, lo, hi, scale);
+		const __m128i v = _mm_packs_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), v);
+	}
+	unnormalizeSignedScalar(values+i, target+i, count-i);
+}
+
+static void unnormalizeI16_SSE2(const float* values, int16_t* target, uint64_t count) {
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128d scale = _mm_set1_pd(32767.0);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		const __m128i v0 = unnormalize4_SSE2(values+i, lo, hi, scale);
+		const __m128i v1 = unnormalize4_SSE2(values+i+4, lo, hi, scale);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), _mm_packs_epi32(v0, v1));
+	}
+	unnormalizeSignedScalar(values+i, target+i, count-i);
+}
+
+#endif /* UTIL_CONVERSION_SSE2 */
+
+#ifdef UTIL_CONVERSION_AVX2
+//-------------------------------------------------------------
+// AVX2 kernels
+// GCC does not reliably insert vzeroupper for function specific targets, so every kernel clears the upper halves of
+// the registers before it returns to (non-VEX) SSE code, which would otherwise be slowed down considerably.
+
+#define UTIL_AVX2 __attribute__((target("avx2")))
+
+UTIL_AVX2 static inline void storeNormalized8_AVX2(float* target, __m256i v, __m256 scale) {
+	_mm256_storeu_ps(target, _mm256_div_ps(_mm256_cvtepi32_ps(v), scale));
+}
+
+UTIL_AVX2 static inline void storeNormalizedSigned8_AVX2(float* target, __m256i v, __m256 scale) {
+	_mm256_storeu_ps(target, _mm256_max_ps(_mm256_div_ps(_mm256_cvtepi32_ps(v), scale), _mm256_set1_ps(-1.0f)));
+}
+
+//! clamp 8 floats and scale them in double precision to 2x4 (truncated) int32 values
+UTIL_AVX2 static inline void unnormalize8_AVX2(const float* values, __m256 lo, __m256 hi, __m256d scale, __m128i& out0, __m128i& out1) {
+	const __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(values), lo), hi);
+	out0 = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), scale));
+	out1 = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), scale));
+}
+
+UTIL_AVX2 static void normalizeU8_AVX2(const uint8_t* values, float* target, uint64_t count) {
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		storeNormalized8_AVX2(target+i, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(values+i))), scale);
+	_mm256_zeroupper();
+	normalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void normalizeU16_AVX2(const uint16_t* values, float* target, uint64_t count) {
+	const __m256 scale = _mm256_set1_ps(65535.0f);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		storeNormalized8_AVX2(target+i, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i))), scale);
+	_mm256_zeroupper();
+	normalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void normalizeI8_AVX2(const int8_t* values, float* target, uint64_t count) {
+	const __m256 scale = _mm256_set1_ps(127.0f);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		storeNormalizedSigned8_AVX2(target+i, _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(values+i))), scale);
+	_mm256_zeroupper();
+	normalizeSignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void normalizeI16_AVX2(const int16_t* values, float* target, uint64_t count) {
+	const __m256 scale = _mm256_set1_ps(32767.0f);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		storeNormalizedSigned8_AVX2(target+i, _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i))), scale);
+	_mm256_zeroupper();
+	normalizeSignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void unnormalizeU8_AVX2(const float* values, uint8_t* target, uint64_t count) {
+	const __m256 lo = _mm256_set1_ps(0.0f);
+	const __m256 hi = _mm256_set1_ps(1.0f);
+	const __m256d scale = _mm256_set1_pd(255.0);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		__m128i v0, v1;
+		unnormalize8_AVX2(values+i, lo, hi, scale, v0, v1);
+		const __m128i v = _mm_packs_epi32(v0, v1);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(target+i), _mm_packus_epi16(v, v));
+	}
+	_mm256_zeroupper();
+	unnormalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void unnormalizeU16_AVX2(const float* values, uint16_t* target, uint64_t count) {
+	const __m256 lo = _mm256_set1_ps(0.0f);
+	const __m256 hi = _mm256_set1_ps(1.0f);
+	const __m256d scale = _mm256_set1_pd(65535.0);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		__m128i v0, v1;
+		unnormalize8_AVX2(values+i, lo, hi, scale, v0, v1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), _mm_packus_epi32(v0, v1));
+	}
+	_mm256_zeroupper();
+	unnormalizeUnsignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void unnormalizeI8_AVX2(const float* values, int8_t* target, uint64_t count) {
+	const __m256 lo = _mm256_set1_ps(-1.0f);
+	const __m256 hi = _mm256_set1_ps(1.0f);
+	const __m256d scale = _mm256_set1_pd(127.0);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		__m128i v0, v1;
+		unnormalize8_AVX2(values+i, lo, hi, scale, v0, v1);
+		const __m128i v = _mm_packs_epi32(v0, v1);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(target+i), _mm_packs_epi16(v, v));
+	}
+	_mm256_zeroupper();
+	unnormalizeSignedScalar(values+i, target+i, count-i);
+}
+
+UTIL_AVX2 static void unnormalizeI16_AVX2(const float* values, int16_t* target, uint64_t count) {
+	const __m256 lo = _mm256_set1_ps(-1.0f);
+	const __m256 hi = _mm256_set1_ps(1.0f);
+	const __m256d scale = _mm256_set1_pd(32767.0);
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		__m128i v0, v1;
+		unnormalize8_AVX2(values+i, lo, hi, scale, v0, v1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), _mm_packs_epi32(v0, v1));
+	}
+	_mm256_zeroupper();
+	unnormalizeSignedScalar(values+i, target+i, count-i);
+}
+
+#undef UTIL_AVX2
+#endif /* UTIL_CONVERSION_AVX2 */
+
+//-------------------------------------------------------------
+// runtime dispatch
+
+struct Kernels {
+	const char* name;
+	void (*normalizeU8)(const uint8_t*, float*, uint64_t);
+	void (*normalizeU16)(const uint16_t*, float*, uint64_t);
+	void (*normalizeI8)(const int8_t*, float*, uint64_t);
+	void (*normalizeI16)(const int16_t*, float*, uint64_t);
+	void (*unnormalizeU8)(const float*, uint8_t*, uint64_t);
+	void (*unnormalizeU16)(const float*, uint16_t*, uint64_t);
+	void (*unnormalizeI8)(const float*, int8_t*, uint64_t);
+	void (*unnormalizeI16)(const float*, int16_t*, uint64_t);
+};
+
+static Kernels selectKernels() {
+#ifdef UTIL_CONVERSION_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		return {"avx2", normalizeU8_AVX2, normalizeU16_AVX2, normalizeI8_AVX2, normalizeI16_AVX2,
+			unnormalizeU8_AVX2, unnormalizeU16_AVX2, unnormalizeI8_AVX2, unnormalizeI16_AVX2};
+#endif
+#ifdef UTIL_CONVERSION_SSE2
+	return {"sse2", normalizeU8_SSE2, normalizeU16_SSE2, normalizeI8_SSE2, normalizeI16_SSE2,
+		unnormalizeU8_SSE2, unnormalizeU16_SSE2, unnormalizeI8_SSE2, unnormalizeI16_SSE2};
+#else
+	return {"scalar", normalizeUnsignedScalar<uint8_t>, normalizeUnsignedScalar<uint16_t>, normalizeSignedScalar<int8_t>, normalizeSignedScalar<int16_t>,
+		unnormalizeUnsignedScalar<uint8_t>, unnormalizeUnsignedScalar<uint16_t>, unnormalizeSignedScalar<int8_t>, unnormalizeSignedScalar<int16_t>};
+#endif
+}
+
+static const Kernels& getKernels() {
+	static const Kernels kernels = selectKernels();
+	return kernels;
+}
+
+//-------------------------------------------------------------
+
+void normalizeUnsigned(const uint8_t* values, float* target, uint64_t count) { getKernels().normalizeU8(values, target, count); }
+void normalizeUnsigned(const uint16_t* values, float* target, uint64_t count) { getKernels().normalizeU16(values, target, count); }
+void normalizeSigned(const int8_t* values, float* target, uint64_t count) { getKernels().normalizeI8(values, target, count); }
+void normalizeSigned(const int16_t* values, float* target, uint64_t count) { getKernels().normalizeI16(values, target, count); }
+void unnormalizeUnsigned(const float* values, uint8_t* target, uint64_t count) { getKernels().unnormalizeU8(values, target, count); }
+void unnormalizeUnsigned(const float* values, uint16_t* target, uint64_t count) { getKernels().unnormalizeU16(values, target, count); }
+void unnormalizeSigned(const float* values, int8_t* target, uint64_t count) { getKernels().unnormalizeI8(values, target, count); }
+void unnormalizeSigned(const float* values, int16_t* target, uint64_t count) { getKernels().unnormalizeI16(values, target, count); }
+
+std::string getKernelName() { return getKernels().name; }
+
+//-------------------------------------------------------------
+// 16 bit floating point kernels
+
+/* Notes on exactness:
+ * - half -> float and bfloat16 -> float are exact. Signaling NaNs are quieted (as done by F16C).
+ * - float -> half and float -> bfloat16 round to nearest even (as _mm256_cvtps_ph with _MM_FROUND_TO_NEAREST_INT).
+ *   NaNs keep their sign and upper mantissa bits and are quieted, values beyond the half range become infinity.
+ */
+
+static inline uint32_t floatBits(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static inline float bitsToFloat(uint32_t bits) {
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static inline float halfToFloat(uint16_t value) {
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1f;
+	const uint32_t mantissa = value & 0x3ff;
+	if(exponent == 0x1f) // infinity or NaN
+		return bitsToFloat(sign | 0x7f800000 | (mantissa << 13) | (mantissa != 0 ? 0x400000 : 0));
+	if(exponent == 0) { // zero or subnormal
+		const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f); // mantissa * 2^-24 (exact)
+		return bitsToFloat(sign | floatBits(magnitude));
+	}
+	return bitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+static inline uint16_t floatToHalf(float value) {
+	const uint32_t bits = floatBits(value);
+	const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+	const uint32_t magnitude = bits & 0x7fffffff;
+	if(magnitude > 0x7f800000) // NaN
+		return sign | 0x7e00 | static_cast<uint16_t>((magnitude >> 13) & 0x3ff);
+	if(magnitude >= 0x47800000) // >= 2^16 (or infinity)
+		return sign | 0x7c00;
+	uint32_t result, remainder, halfway;
+	if(magnitude < 0x38800000) { // < 2^-14 -> subnormal half
+		if(magnitude < 0x33000000) // < 2^-25 -> rounds to zero
+			return sign;
+		const uint32_t shift = 126 - (magnitude >> 23);
+		const uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+		result = mantissa >> shift;
+		remainder = mantissa & ((1u << shift) - 1);
+		halfway = 1u << (shift - 1);
+	} else {
+		result = (magnitude >> 13) - (112 << 10);
+		remainder = magnitude & 0x1fff;
+		halfway = 0x1000;
+	}
+	if(remainder > halfway || (remainder == halfway && (result & 1))) // may carry into the exponent (up to infinity)
+		++result;
+	return sign | static_cast<uint16_t>(result);
+}
+
+static inline float bfloat16ToFloat(uint16_t value) {
+	return bitsToFloat(static_cast<uint32_t>(value) << 16);
+}
+
+static inline uint16_t floatToBfloat16(float value) {
+	const uint32_t bits = floatBits(value);
+	if((bits & 0x7fffffff) > 0x7f800000) // NaN
+		return static_cast<uint16_t>((bits >> 16) | 0x40);
+	return static_cast<uint16_t>((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+}
+
+static void halfToFloatScalar(const uint16_t* values, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = halfToFloat(values[i]);
+}
+
+static void floatToHalfScalar(const float* values, uint16_t* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = floatToHalf(values[i]);
+}
+
+static void bfloat16ToFloatScalar(const uint16_t* values, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = bfloat16ToFloat(values[i]);
+}
+
+static void floatToBfloat16Scalar(const float* values, uint16_t* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i)
+		target[i] = floatToBfloat16(values[i]);
+}
+
+#ifdef UTIL_CONVERSION_SSE2
+// bfloat16 is the upper half of a float, so the conversion only needs integer operations.
+
+static void bfloat16ToFloat_SSE2(const uint16_t* values, float* target, uint64_t count) {
+	const __m128i zero = _mm_setzero_si128();
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), _mm_unpacklo_epi16(zero, v));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i+4), _mm_unpackhi_epi16(zero, v));
+	}
+	bfloat16ToFloatScalar(values+i, target+i, count-i);
+}
+
+static inline __m128i floatToBfloat16_SSE2(const float* values) {
+	const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+	const __m128i isNaN = _mm_cmpgt_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7fffffff)), _mm_set1_epi32(0x7f800000));
+	const __m128i lsb = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+	const __m128i rounded = _mm_srli_epi32(_mm_add_epi32(bits, _mm_add_epi32(lsb, _mm_set1_epi32(0x7fff))), 16);
+	const __m128i nan = _mm_or_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x40));
+	const __m128i result = _mm_or_si128(_mm_and_si128(isNaN, nan), _mm_andnot_si128(isNaN, rounded));
+	return _mm_srai_epi32(_mm_slli_epi32(result, 16), 16); // sign extend, so packs_epi32 keeps the bit pattern
+}
+
+static void floatToBfloat16_SSE2(const float* values, uint16_t* target, uint64_t count) {
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), _mm_packs_epi32(floatToBfloat16_SSE2(values+i), floatToBfloat16_SSE2(values+i+4)));
+	floatToBfloat16Scalar(values+i, target+i, count-i);
+}
+#endif /* UTIL_CONVERSION_SSE2 */
+
+#ifdef UTIL_CONVERSION_AVX2
+#define UTIL_F16C __attribute__((target("avx,f16c")))
+
+UTIL_F16C static void halfToFloat_F16C(const uint16_t* values, float* target, uint64_t count) {
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		_mm256_storeu_ps(target+i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values+i))));
+	_mm256_zeroupper();
+	halfToFloatScalar(values+i, target+i, count-i);
+}
+
+UTIL_F16C static void floatToHalf_F16C(const float* values, uint16_t* target, uint64_t count) {
+	uint64_t i = 0;
+	for(; i+8<=count; i+=8)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target+i), _mm256_cvtps_ph(_mm256_loadu_ps(values+i), _MM_FROUND_TO_NEAREST_INT));
+	_mm256_zeroupper();
+	floatToHalfScalar(values+i, target+i, count-i);
+}
+
+#undef UTIL_F16C
+#endif /* UTIL_CONVERSION_AVX2 */
+
+struct Float16Kernels {
+	const char* name;
+	void (*halfToFloat)(const uint16_t*, float*, uint64_t);
+	void (*floatToHalf)(const float*, uint16_t*, uint64_t);
+	void (*bfloat16ToFloat)(const uint16_t*, float*, uint64_t);
+	void (*floatToBfloat16)(const float*, uint16_t*, uint64_t);
+};
+
+static Float16Kernels selectFloat16Kernels() {
+#ifdef UTIL_CONVERSION_AVX2
+	if(__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c"))
+		return {"f16c", halfToFloat_F16C, floatToHalf_F16C, bfloat16ToFloat_SSE2, floatToBfloat16_SSE2};
+#endif
+#ifdef UTIL_CONVERSION_SSE2
+	// only the bfloat16 kernels are vectorized with SSE2
+	return {"scalar", halfToFloatScalar, floatToHalfScalar, bfloat16ToFloat_SSE2, floatToBfloat16_SSE2};
+#else
+	return {"scalar", halfToFloatScalar, floatToHalfScalar, bfloat16ToFloatScalar, floatToBfloat16Scalar};
+#endif
+}
+
+static const Float16Kernels& getFloat16Kernels() {
+	static const Float16Kernels kernels = selectFloat16Kernels();
+	return kernels;
+}
+
+//-------------------------------------------------------------
+
+void halfToFloat(const uint16_t* values, float* target, uint64_t count) { getFloat16Kernels().halfToFloat(values, target, count); }
+void floatToHalf(const float* values, uint16_t* target, uint64_t count) { getFloat16Kernels().floatToHalf(values, target, count); }
+void bfloat16ToFloat(const uint16_t* values, float* target, uint64_t count) { getFloat16Kernels().bfloat16ToFloat(values, target, count); }
+void floatToBfloat16(const float* values, uint16_t* target, uint64_t count) { getFloat16Kernels().floatToBfloat16(values, target, count); }
+
+std::string getFloat16KernelName() { return getFloat16Kernels().name; }
+
+//-------------------------------------------------------------
+// quantized attribute kernels
+// The packed data of an attribute may be unaligned (e.g., in interleaved layouts), so it is only accessed through memcpy.
+
+template<typename T>
+static inline T loadPacked(const uint8_t* data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+template<typename T>
+static inline void storePacked(uint8_t* data, T value) {
+	std::memcpy(data, &value, sizeof(T));
+}
+
+static std::invalid_argument createTypeError(const char* kernel, TypeConstant type) {
+	return std::invalid_argument(std::string("AttributeConversion::") + kernel + ": Unsupported type " + getTypeString(type) + ".");
+}
+
+template<typename T>
+static inline float snormToFloat(T value) {
+	return std::max(static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max()), -1.0f);
+}
+
+template<typename T>
+static inline T floatToSnorm(float value) {
+	const float clamped = std::min(1.0f, std::max(-1.0f, value)); // NaN -> -1
+	return static_cast<T>(std::lround(clamped * static_cast<float>(std::numeric_limits<T>::max())));
+}
+
+template<typename T>
+static void decodeOctahedralT(const uint8_t* data, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, data += 2*sizeof(T), target += 3) {
+		float x = snormToFloat(loadPacked<T>(data));
+		float y = snormToFloat(loadPacked<T>(data + sizeof(T)));
+		const float z = 1.0f - std::abs(x) - std::abs(y);
+		const float t = std::max(-z, 0.0f); // fold the lower hemisphere
+		x += x >= 0.0f ? -t : t;
+		y += y >= 0.0f ? -t : t;
+		const float invLength = 1.0f / std::sqrt(x*x + y*y + z*z);
+		target[0] = x * invLength;
+		target[1] = y * invLength;
+		target[2] = z * invLength;
+	}
+}
+
+template<typename T>
+static void encodeOctahedralT(const float* values, uint8_t* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, values += 3, target += 2*sizeof(T)) {
+		const float sum = std::abs(values[0]) + std::abs(values[1]) + std::abs(values[2]);
+		const float invSum = sum > 0.0f ? 1.0f / sum : 0.0f;
+		float x = values[0] * invSum;
+		float y = values[1] * invSum;
+		if(values[2] < 0.0f) {
+			const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+		}
+		storePacked(target, floatToSnorm<T>(x));
+		storePacked(target + sizeof(T), floatToSnorm<T>(y));
+	}
+}
+
+void decodeOctahedral(const uint8_t* data, TypeConstant type, float* target, uint64_t count) {
+	switch(type) {
+		case TypeConstant::INT8: decodeOctahedralT<int8_t>(data, target, count); break;
+		case TypeConstant::INT16: decodeOctahedralT<int16_t>(data, target, count); break;
+		default: throw createTypeError("decodeOctahedral", type);
+	}
+}
+
+void encodeOctahedral(const float* values, uint8_t* target, TypeConstant type, uint64_t count) {
+	switch(type) {
+		case TypeConstant::INT8: encodeOctahedralT<int8_t>(values, target, count); break;
+		case TypeConstant::INT16: encodeOctahedralT<int16_t>(values, target, count); break;
+		default: throw createTypeError("encodeOctahedral", type);
+	}
+}
+
+//-------------------------------------------------------------
+
+static inline float signedBitsToFloat(uint32_t bits, uint32_t width) {
+	const int32_t value = static_cast<int32_t>(bits << (32 - width)) >> (32 - width); // sign extend
+	return std::max(static_cast<float>(value) / static_cast<float>((1 << (width - 1)) - 1), -1.0f);
+}
+
+static inline uint32_t floatToSignedBits(float value, uint32_t width) {
+	const float max = static_cast<float>((1 << (width - 1)) - 1);
+	const float clamped = std::min(1.0f, std::max(-1.0f, value));
+	return static_cast<uint32_t>(std::lround(clamped * max)) & ((1u << width) - 1);
+}
+
+static inline uint32_t floatToUnsignedBits(float value, uint32_t width) {
+	const float clamped = std::min(1.0f, std::max(0.0f, value));
+	return static_cast<uint32_t>(std::lround(clamped * static_cast<float>((1u << width) - 1)));
+}
+
+void decodeSnorm10_10_10_2(const uint8_t* data, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, data += 4, target += 4) {
+		const uint32_t v = loadPacked<uint32_t>(data);
+		target[0] = signedBitsToFloat(v & 0x3ff, 10);
+		target[1] = signedBitsToFloat((v >> 10) & 0x3ff, 10);
+		target[2] = signedBitsToFloat((v >> 20) & 0x3ff, 10);
+		target[3] = signedBitsToFloat(v >> 30, 2);
+	}
+}
+
+void encodeSnorm10_10_10_2(const float* values, uint8_t* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, values += 4, target += 4)
+		storePacked<uint32_t>(target, floatToSignedBits(values[0], 10) | (floatToSignedBits(values[1], 10) << 10)
+			| (floatToSignedBits(values[2], 10) << 20) | (floatToSignedBits(values[3], 2) << 30));
+}
+
+void decodeUnorm10_10_10_2(const uint8_t* data, float* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, data += 4, target += 4) {
+		const uint32_t v = loadPacked<uint32_t>(data);
+		target[0] = static_cast<float>(v & 0x3ff) / 1023.0f;
+		target[1] = static_cast<float>((v >> 10) & 0x3ff) / 1023.0f;
+		target[2] = static_cast<float>((v >> 20) & 0x3ff) / 1023.0f;
+		target[3] = static_cast<float>(v >> 30) / 3.0f;
+	}
+}
+
+void encodeUnorm10_10_10_2(const float* values, uint8_t* target, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, values += 4, target += 4)
+		storePacked<uint32_t>(target, floatToUnsignedBits(values[0], 10) | (floatToUnsignedBits(values[1], 10) << 10)
+			| (floatToUnsignedBits(values[2], 10) << 20) | (floatToUnsignedBits(values[3], 2) << 30));
+}
+
+//-------------------------------------------------------------
+
+template<typename T>
+static void dequantizeT(const uint8_t* data, float* target, uint64_t count, uint32_t components, const float* offset, const float* scale) {
+	for(uint64_t i=0; i<count; ++i, target += components)
+		for(uint32_t c=0; c<components; ++c, data += sizeof(T))
+			target[c] = offset[c] + static_cast<float>(loadPacked<T>(data)) * scale[c];
+}
+
+template<typename T>
+static void quantizeT(const float* values, uint8_t* target, uint64_t count, uint32_t components, const float* offset, const float* invScale) {
+	const double max = static_cast<double>(std::numeric_limits<T>::max());
+	for(uint64_t i=0; i<count; ++i, values += components)
+		for(uint32_t c=0; c<components; ++c, target += sizeof(T)) {
+			const double q = std::round(static_cast<double>((values[c] - offset[c]) * invScale[c]));
+			storePacked(target, static_cast<T>(std::min(max, std::max(0.0, q)))); // NaN -> 0
+		}
+}
+
+void dequantize(const uint8_t* data, TypeConstant type, float* target, uint64_t count, uint32_t components, const float* offset, const float* scale) {
+	switch(type) {
+		case TypeConstant::UINT8: dequantizeT<uint8_t>(data, target, count, components, offset, scale); break;
+		case TypeConstant::UINT16: dequantizeT<uint16_t>(data, target, count, components, offset, scale); break;
+		case TypeConstant::UINT32: dequantizeT<uint32_t>(data, target, count, components, offset, scale); break;
+		default: throw createTypeError("dequantize", type);
+	}
+}
+
+void quantize(const float* values, uint8_t* target, TypeConstant type, uint64_t count, uint32_t components, const float* offset, const float* invScale) {
+	switch(type) {
+		case TypeConstant::UINT8: quantizeT<uint8_t>(values, target, count, components, offset, invScale); break;
+		case TypeConstant::UINT16: quantizeT<uint16_t>(values, target, count, components, offset, invScale); break;
+		case TypeConstant::UINT32: quantizeT<uint32_t>(values, target, count, components, offset, invScale); break;
+		default: throw createTypeError("quantize", type);
+	}
+}
+
+//-------------------------------------------------------------
+// strided copy kernels
+
+template<uint64_t N>
+static void copyStrided(const uint8_t* source, uint64_t sourceStride, uint8_t* target, uint64_t targetStride, uint64_t count) {
+	for(uint64_t i=0; i<count; ++i, source += sourceStride, target += targetStride)
+		std::memcpy(target, source, N);
+}
+
+void copyStrided(const uint8_t* source, uint64_t sourceStride, uint8_t* target, uint64_t targetStride, uint64_t count, uint64_t size) {
+	if(size == sourceStride && size == targetStride) {
+		std::memcpy(target, source, count * size);
+		return;
+	}
+	switch(size) {
+		case 1: copyStrided<1>(source, sourceStride, target, targetStride, count); break;
+		case 2: copyStrided<2>(source, sourceStride, target, targetStride, count); break;
+		case 3: copyStrided<3>(source, sourceStride, target, targetStride, count); break;
+		case 4: copyStrided<4>(source, sourceStride, target, targetStride, count); break;
+		case 8: copyStrided<8>(source, sourceStride, target, targetStride, count); break;
+		case 12: copyStrided<12>(source, sourceStride, target, targetStride, count); break;
+		case 16: copyStrided<16>(source, sourceStride, target, targetStride, count); break;
+		default:
+			for(uint64_t i=0; i<count; ++i, source += sourceStride, target += targetStride)
+				std::memcpy(target, source, size);
+			break;
+	}
+}
+
+//-------------------------------------------------------------
+
+template<uint32_t N>
+static void swizzleStrided(const uint8_t* source, uint64_t sourceStride, uint8_t* target, uint64_t targetStride, uint64_t count, const uint32_t* order, uint32_t componentCount) {
+	for(uint64_t i=0; i<count; ++i, source += sourceStride, target += targetStride)
+		for(uint32_t c=0; c<componentCount; ++c)
+			std::memcpy(target + c*N, source + order[c]*N, N);
+}
+
+void swizzleStrided(const uint8_t* source, uint64_t sourceStride, uint8_t* target, uint64_t targetStride, uint64_t count,
+		uint32_t componentSize, const uint32_t* order, uint32_t componentCount) {
+	switch(componentSize) {
+		case 1: swizzleStrided<1>(source, sourceStride, target, targetStride, count, order, componentCount); break;
+		case 2: swizzleStrided<2>(source, sourceStride, target, targetStride, count, order, componentCount); break;
+		case 4: swizzleStrided<4>(source, sourceStride, target, targetStride, count, order, componentCount); break;
+		case 8: swizzleStrided<8>(source, sourceStride, target, targetStride, count, order, componentCount); break;
+		default:
+			for(uint64_t i=0; i<count; ++i, source += sourceStride, target += targetStride)
+				for(uint32_t c=0; c<componentCount; ++c)
+					std::memcpy(target + c*componentSize, source + order[c]*componentSize, componentSize);
+			break;
+	}
+}
+
+//-------------------------------------------------------------
+// byte shuffle kernels
+
+//! Shuffle control and fill bytes for the elements that fit into 16 bytes.
+struct ShuffleMask {
+	uint8_t shuffle[16];
+	uint8_t fill[16];
+	uint32_t elements;
+};
+
+static ShuffleMask createShuffleMask(uint32_t sourceStride, uint32_t targetStride, const int8_t* pattern, const uint8_t* fill) {
+	ShuffleMask mask;
+	mask.elements = 16 / std::max(sourceStride, targetStride);
+	std::memset(mask.shuffle, 0x80, sizeof(mask.shuffle)); // the high bit zeroes the byte
+	std::memset(mask.fill, 0, sizeof(mask.fill));
+	for(uint32_t e=0; e<mask.elements; ++e) {
+		for(uint32_t i=0; i<targetStride; ++i) {
+			if(pattern[i] < 0)
+				mask.fill[e*targetStride + i] = fill[i];
+			else
+				mask.shuffle[e*targetStride + i] = static_cast<uint8_t>(e*sourceStride + pattern[i]);
+		}
+	}
+	return mask;
+}
+
+static void shuffleBytesScalar(const uint8_t* source, uint32_t sourceStride, uint8_t* target, uint32_t targetStride, uint64_t count,
+		const int8_t* pattern, const uint8_t* fill) {
+	for(uint64_t i=0; i<count; ++i, source += sourceStride, target += targetStride)
+		for(uint32_t c=0; c<targetStride; ++c)
+			target[c] = pattern[c] < 0 ? fill[c] : source[pattern[c]];
+}
+
+#ifdef UTIL_CONVERSION_AVX2
+#define UTIL_SSSE3 __attribute__((target("ssse3")))
+#define UTIL_AVX2 __attribute__((target("avx2")))
+
+/* Each iteration loads and stores 16 bytes, but only advances by the bytes of the whole elements in the mask.
+ * The loop stops before any access would leave the given ranges, so the surplus bytes of a store are always
+ * overwritten by the next iteration or by the scalar tail. */
+UTIL_SSSE3 static void shuffleBytes_SSSE3(const uint8_t* source, uint32_t sourceStride, uint8_t* target, uint32_t targetStride, uint64_t count,
+		const int8_t* pattern, const uint8_t* fill, const ShuffleMask& mask) {
+	const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.shuffle));
+	const __m128i constant = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.fill));
+	uint64_t i = 0;
+	for(; (count-i)*sourceStride >= 16 && (count-i)*targetStride >= 16; i+=mask.elements) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i*sourceStride));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i*targetStride), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), constant));
+	}
+	shuffleBytesScalar(source + i*sourceStride, sourceStride, target + i*targetStride, targetStride, count-i, pattern, fill);
+}
+
+// vpshufb only shuffles within 128 bit lanes, so each lane processes the elements of one mask.
+UTIL_AVX2 static void shuffleBytes_AVX2(const uint8_t* source, uint32_t sourceStride, uint8_t* target, uint32_t targetStride, uint64_t count,
+		const int8_t* pattern, const uint8_t* fill, const ShuffleMask& mask) {
+	const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.shuffle)));
+	const __m256i constant = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.fill)));
+	const uint64_t n = mask.elements;
+	uint64_t i = 0;
+	for(; count-i >= n && (count-i-n)*sourceStride >= 16 && (count-i-n)*targetStride >= 16; i+=2*n) {
+		const uint8_t* src = source + i*sourceStride;
+		uint8_t* tgt = target + i*targetStride;
+		const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n*sourceStride)), 1);
+		const __m256i result = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), constant);
+		if(n*targetStride == 16) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(tgt), result);
+		} else {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(tgt), _mm256_castsi256_si128(result));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(tgt + n*targetStride), _mm256_extracti128_si256(result, 1));
+		}
+	}
+	_mm256_zeroupper();
+	shuffleBytes_SSSE3(source + i*sourceStride, sourceStride, target + i*targetStride, targetStride, count-i, pattern, fill, mask);
+}
+
+#undef UTIL_AVX2
+#undef UTIL_SSSE3
+#endif /* UTIL_CONVERSION_AVX2 */
+
+using ShuffleKernel_t = void (*)(const uint8_t*, uint32_t, uint8_t*, uint32_t, uint64_t, const int8_t*, const uint8_t*, const ShuffleMask&);
+
+struct ShuffleKernels {
+	const char* name;
+	ShuffleKernel_t shuffleBytes;
+};
+
+static ShuffleKernels selectShuffleKernels() {
+#ifdef UTIL_CONVERSION_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		return {"avx2", shuffleBytes_AVX2};
+	if(__builtin_cpu_supports("ssse3"))
+		return {"ssse3", shuffleBytes_SSSE3};
+#endif
+	return {"scalar", nullptr};
+}
+
+static const ShuffleKernels& getShuffleKernels() {
+	static const ShuffleKernels kernels = selectShuffleKernels();
+	return kernels;
+}
+
+//-------------------------------------------------------------
+
+void shuffleBytes(const uint8_t* source, uint32_t sourceStride, uint8_t* target, uint32_t targetStride, uint64_t count,
+		const int8_t* pattern, const uint8_t* fill) {
+	const auto kernel = getShuffleKernels().shuffleBytes;
+	if(!kernel || sourceStride == 0 || sourceStride > 16 || targetStride == 0 || targetStride > 16) {
+		shuffleBytesScalar(source, sourceStride, target, targetStride, count, pattern, fill);
+		return;
+	}
+	kernel(source, sourceStride, target, targetStride, count, pattern, fill, createShuffleMask(sourceStride, targetStride, pattern, fill));
+}
+
+std::string getShuffleKernelName() { return getShuffleKernels().name; }
+
+//-------------------------------------------------------------
+
+TypeConstant getIntermediateType(const AttributeFormat& source, const AttributeFormat& target) {
+	const auto isPlainInteger = [](const AttributeFormat& attr) {
+		return !attr.isNormalized() && attr.getInternalType() == 0 && (isSignedIntegerType(attr.getDataType()) || isUnsignedIntegerType(attr.getDataType()));
+	};
+	const auto needsDouble = [&](const AttributeFormat& attr) {
+		return attr.getInternalType() != 0 || attr.getDataType() == TypeConstant::DOUBLE || (isPlainInteger(attr) && getNumBytes(attr.getDataType()) > 2);
+	};
+	if(isPlainInteger(source) && isPlainInteger(target))
+		return isUnsignedIntegerType(source.getDataType()) && isUnsignedIntegerType(target.getDataType()) ? TypeConstant::UINT64 : TypeConstant::INT64;
+	return needsDouble(source) || needsDouble(target) ? TypeConstant::DOUBLE : TypeConstant::FLOAT;
+}
+
+//-------------------------------------------------------------
+
+template<typename T>
+static void convertRange(const AttributeAccessor& source, const AttributeAccessor& target, uint64_t first, uint64_t count, std::vector<uint64_t>& buffer) {
+	const uint32_t sourceComponents = source.getValueCount();
+	const uint32_t valueStride = std::max(sourceComponents, target.getValueCount());
+	buffer.resize((count * valueStride * sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	T* values = reinterpret_cast<T*>(buffer.data());
+	if(sourceComponents < valueStride) {
+		for(uint64_t i=0; i<count; ++i)
+			for(uint32_t c=sourceComponents; c<valueStride; ++c)
+				values[i*valueStride + c] = static_cast<T>(c == 3 ? 1 : 0);
+	}
+	source.readRange(first, count, values, valueStride);
+	target.writeRange(first, count, values, valueStride);
+}
+
+void convertRange(const AttributeAccessor& source, const AttributeAccessor& target, uint64_t first, uint64_t count,
+		TypeConstant intermediateType, std::vector<uint64_t>& buffer) {
+	switch(intermediateType) {
+		case TypeConstant::UINT64: convertRange<uint64_t>(source, target, first, count, buffer); break;
+		case TypeConstant::INT64: convertRange<int64_t>(source, target, first, count, buffer); break;
+		case TypeConstant::DOUBLE: convertRange<double>(source, target, first, count, buffer); break;
+		default: convertRange<float>(source, target, first, count, buffer); break;
+	}
+}
+
+//-------------------------------------------------------------
+
+} /* AttributeConversion */
+} /* Util */
@@ -0,0 +1,138 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_ATTRIBUTECONVERSION_H_
+#define UTIL_RESOURCES_ATTRIBUTECONVERSION_H_
+
+#include "AttributeFormat.h"
+#include "../TypeConstant.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Util {
+class AttributeAccessor;
+
+/**
+ * Bulk conversion kernels between normalized integer values and floating point values
+ * and between 16 bit floating point values (half and bfloat16) and float.
+ * It also contains the encoding and decoding kernels for quantized attributes (see QuantizedAttribute.h).
+ *
+ * The kernels operate on contiguous arrays and produce exactly the same results as
+ * the scalar functions (e.g., @p normalizeUnsigned and @p unnormalizeUnsigned) in Utils.h.
+ * If available, a vectorized implementation (AVX2, F16C or SSE2) is chosen at runtime.
+ *
+ * Additionally, this namespace contains the strided copy kernels used by the bulk resource converters.
+ * @ingroup resources
+ */
+namespace AttributeConversion {
+
+//! uint8/uint16 in [0,max] -> float in [0,1]
+UTILAPI void normalizeUnsigned(const uint8_t* values, float* target, uint64_t count);
+UTILAPI void normalizeUnsigned(const uint16_t* values, float* target, uint64_t count);
+
+//! int8/int16 in [min,max] -> float in [-1,1]
+UTILAPI void normalizeSigned(const int8_t* values, float* target, uint64_t count);
+UTILAPI void normalizeSigned(const int16_t* values, float* target, uint64_t count);
+
+//! float (clamped to [0,1]) -> uint8/uint16
+UTILAPI void unnormalizeUnsigned(const float* values, uint8_t* target, uint64_t count);
+UTILAPI void unnormalizeUnsigned(const float* values, uint16_t* target, uint64_t count);
+
+//! float (clamped to [-1,1]) -> int8/int16
+UTILAPI void unnormalizeSigned(const float* values, int8_t* target, uint64_t count);
+UTILAPI void unnormalizeSigned(const float* values, int16_t* target, uint64_t count);
+
+//! half (IEEE 754 binary16) <-> float; float values are rounded to nearest even, values beyond the half range become infinity.
+UTILAPI void halfToFloat(const uint16_t* values, float* target, uint64_t count);
+UTILAPI void floatToHalf(const float* values, uint16_t* target, uint64_t count);
+
+//! bfloat16 (upper 16 bits of a float) <-> float; float values are rounded to nearest even.
+UTILAPI void bfloat16ToFloat(const uint16_t* values, float* target, uint64_t count);
+UTILAPI void floatToBfloat16(const float* values, uint16_t* target, uint64_t count);
+
+/**
+ * Octahedral encoded unit vectors (two signed normalized components of the given @p type, INT8 or INT16) <-> 3 floats per vector.
+ * Encoded vectors are normalized before encoding; decoded vectors have unit length.
+ * The packed data does not need to be aligned.
+ * @param count The number of vectors.
+ * @throw std::invalid_argument if the type is not supported.
+ */
+UTILAPI void decodeOctahedral(const uint8_t* data, TypeConstant type, float* target, uint64_t count);
+UTILAPI void encodeOctahedral(const float* values, uint8_t* target, TypeConstant type, uint64_t count);
+
+/**
+ * Packed 32 bit vectors (x: bits 0-9, y: bits 10-19, z: bits 20-29, w: bits 30-31) <-> 4 floats per vector.
+ * The signed variant maps to [-1,1], the unsigned variant to [0,1]. The packed data does not need to be aligned.
+ * @param count The number of vectors.
+ */
+UTILAPI void decodeSnorm10_10_10_2(const uint8_t* data, float* target, uint64_t count);
+UTILAPI void encodeSnorm10_10_10_2(const float* values, uint8_t* target, uint64_t count);
+UTILAPI void decodeUnorm10_10_10_2(const uint8_t* data, float* target, uint64_t count);
+UTILAPI void encodeUnorm10_10_10_2(const float* values, uint8_t* target, uint64_t count);
+
+/**
+ * Fixed point values relative to a range: value = offset[c] + q * scale[c] for each component c of @p count elements
+ * with @p components components of the given @p type (UINT8, UINT16 or UINT32). The packed data does not need to be aligned.
+ * When quantizing, the values are rounded to the nearest step and clamped to the range of the integer type.
+ * @p quantize takes the precomputed inverse scale (1 / scale[c], or 0 for an empty range).
+ * @throw std::invalid_argument if the type is not supported.
+ */
+UTILAPI void dequantize(const uint8_t* data, TypeConstant type, float* target, uint64_t count, uint32_t components, const float* offset, const float* scale);
+UTILAPI void quantize(const float* values, uint8_t* target, TypeConstant type, uint64_t count, uint32_t components, const float* offset, const float* invScale);
+
+//! Copies the first @p size bytes of @p count elements between two strided arrays.
+UTILAPI void copyStrided(const uint8_t* source, uint64_t sourceStride, uint8_t* target, uint64_t targetStride, uint64_t count, uint64_t size);
+
+/**
+ * Copies @p count elements between two strided arrays and reorders their components.
+ * Component @p i of each target element is taken from component @p order[i] of the source element.
+ * @param componentSize The size of a single component in bytes.
+ */
+UTILAPI void swizzleStrided(const uint8_t* source, uint64_t sourceStride, uint8_t* target, uint64_t targetStride, uint64_t count,
+	uint32_t componentSize, const uint32_t* order, uint32_t componentCount);
+
+/**
+ * Rearranges the bytes of @p count packed elements, e.g., to reorder or expand 8 bit color channels (RGB -> BGRA).
+ * Byte @p i of each target element is taken from byte @p pattern[i] (< @p sourceStride) of the source element
+ * or is set to @p fill[i] if @p pattern[i] is negative. Both arrays have @p targetStride entries.
+ * Elements of up to 16 bytes are processed with SSSE3 or AVX2 byte shuffles if available.
+ * @note All bytes of the target elements are written.
+ */
+UTILAPI void shuffleBytes(const uint8_t* source, uint32_t sourceStride, uint8_t* target, uint32_t targetStride, uint64_t count,
+	const int8_t* pattern, const uint8_t* fill);
+
+/**
+ * Returns the type of the values that are used to convert between the two attributes (through @p AttributeAccessor::readRange/writeRange)
+ * without unnecessary loss of precision: 64 bit integers for plain integer attributes, float if it is sufficient and double otherwise.
+ */
+UTILAPI TypeConstant getIntermediateType(const AttributeFormat& source, const AttributeFormat& target);
+
+/**
+ * Converts the attribute values of @p count elements starting at element @p first from one accessor to another
+ * using the given intermediate type (see @p getIntermediateType).
+ * Components that are missing in the source are set to 0, except for the fourth component (e.g., alpha), which is set to 1.
+ * @param buffer Temporary storage (reused between calls to avoid allocations).
+ */
+UTILAPI void convertRange(const AttributeAccessor& source, const AttributeAccessor& target, uint64_t first, uint64_t count,
+	TypeConstant intermediateType, std::vector<uint64_t>& buffer);
+
+//! Returns the name of the instruction set used by the conversion kernels ("avx2", "sse2" or "scalar").
+UTILAPI std::string getKernelName();
+
+//! Returns the name of the instruction set used by the half precision kernels ("f16c" or "scalar"). The bfloat16 kernels use SSE2 if available.
+UTILAPI std::string getFloat16KernelName();
+
+//! Returns the name of the instruction set used by the byte shuffle kernel ("avx2", "ssse3" or "scalar").
+UTILAPI std::string getShuffleKernelName();
+
+}
+}
+
+#endif /* end of include guard: UTIL_RESOURCES_ATTRIBUTECONVERSION_H_ */
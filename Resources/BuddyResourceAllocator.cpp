@@ -0,0 +1,130 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "BuddyResourceAllocator.h"
+#include "../Macros.h"
+#include "../Utils.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Util {
+
+static uint32_t floorLog2(uint64_t value) {
+	uint32_t result = 0;
+	while(value >>= 1)
+		++result;
+	return result;
+}
+
+static bool isPowerOfTwo(uint64_t value) {
+	return value > 0 && (value & (value - 1)) == 0;
+}
+
+// Handles store the offset of the block together with its order (the allocation offset might differ from the block offset).
+static const uint32_t ORDER_BITS = 6;
+
+//-------------------
+
+BuddyResourceAllocator::BuddyResourceAllocator(uint64_t _capacity, uint64_t _minBlockSize) :
+		ResourceAllocator(_capacity >= _minBlockSize && _minBlockSize > 0 ? _minBlockSize << floorLog2(_capacity / _minBlockSize) : 0),
+		minBlockSize(_minBlockSize), maxOrder(capacity > 0 ? floorLog2(capacity / _minBlockSize) : 0) {
+	if(!isPowerOfTwo(minBlockSize))
+		throw std::invalid_argument("BuddyResourceAllocator: The minimum block size has to be a power of two.");
+	WARN_IF(capacity != _capacity, "BuddyResourceAllocator: The capacity is not a power of two multiple of the minimum block size. Only the first " + std::to_string(capacity) + " bytes are used.");
+	freeLists.resize(maxOrder + 1);
+	if(capacity > 0)
+		freeLists[maxOrder].insert(0);
+}
+
+//-------------------
+
+ResourceAllocator::Allocation BuddyResourceAllocator::allocate(uint64_t size, uint64_t alignment) {
+	if(size == 0 || size > capacity)
+		return invalidAllocation();
+	// Blocks are aligned to their size. For alignments that are no power of two, reserve additional space for padding.
+	uint64_t blockSize = std::max(size, minBlockSize);
+	if(alignment > 1 && !isPowerOfTwo(alignment))
+		blockSize += alignment - 1;
+	else
+		blockSize = std::max(blockSize, alignment);
+	if(blockSize > capacity)
+		return invalidAllocation();
+	uint32_t order = floorLog2((blockSize - 1) / minBlockSize) + (blockSize > minBlockSize ? 1 : 0);
+	if(order > maxOrder)
+		return invalidAllocation();
+
+	// find the smallest free block that is large enough
+	uint32_t current = order;
+	while(current <= maxOrder && freeLists[current].empty())
+		++current;
+	if(current > maxOrder)
+		return invalidAllocation();
+	const uint64_t blockOffset = *freeLists[current].begin();
+	freeLists[current].erase(freeLists[current].begin());
+
+	// split the block and put the unused upper halves into the free lists
+	while(current > order) {
+		--current;
+		freeLists[current].insert(blockOffset + getBlockSize(current));
+	}
+
+	allocatedBlocks.emplace(blockOffset, order);
+	usedSize += getBlockSize(order);
+	requestedSize += size;
+	peakUsedSize = std::max(peakUsedSize, usedSize);
+	return {align(blockOffset, alignment), size, (blockOffset << ORDER_BITS) | order};
+}
+
+//-------------------
+
+void BuddyResourceAllocator::free(Allocation&& allocation) {
+	WARN_AND_RETURN_IF(!allocation.isValid(), "BuddyResourceAllocator: Cannot free invalid allocation.",);
+	uint64_t blockOffset = allocation.handle >> ORDER_BITS;
+	uint32_t order = static_cast<uint32_t>(allocation.handle & ((1u << ORDER_BITS) - 1));
+	const auto it = allocatedBlocks.find(blockOffset);
+	WARN_AND_RETURN_IF(it == allocatedBlocks.end() || it->second != order, "BuddyResourceAllocator: Cannot free allocation. Block is not allocated.",);
+	allocatedBlocks.erase(it);
+	usedSize -= getBlockSize(order);
+	requestedSize -= allocation.size;
+
+	// merge with the buddies as long as they are free
+	while(order < maxOrder) {
+		const uint64_t buddy = blockOffset ^ getBlockSize(order);
+		auto& freeList = freeLists[order];
+		const auto buddyIt = freeList.find(buddy);
+		if(buddyIt == freeList.end())
+			break;
+		freeList.erase(buddyIt);
+		blockOffset = std::min(blockOffset, buddy);
+		++order;
+	}
+	freeLists[order].insert(blockOffset);
+}
+
+//-------------------
+
+ResourceAllocator::Statistics BuddyResourceAllocator::getStatistics() const {
+	Statistics stats;
+	stats.capacity = capacity;
+	stats.usedSize = usedSize;
+	stats.requestedSize = requestedSize;
+	stats.peakUsedSize = peakUsedSize;
+	stats.allocationCount = allocatedBlocks.size();
+	for(uint32_t order=0; order<=maxOrder; ++order) {
+		stats.freeBlockCount += freeLists[order].size();
+		if(!freeLists[order].empty())
+			stats.largestFreeBlock = getBlockSize(order);
+	}
+	return stats;
+}
+
+//-------------------
+
+} /* Util */
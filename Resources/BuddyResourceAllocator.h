@@ -0,0 +1,55 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_BUDDYRESOURCEALLOCATOR_H_
+#define UTIL_RESOURCES_BUDDYRESOURCEALLOCATOR_H_
+
+#include "ResourceAllocator.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Util {
+
+/** BuddyResourceAllocator
+	General purpose allocator based on the binary buddy system.
+	Blocks are powers of two multiples of the minimum block size and are naturally aligned to their size.
+	Freed blocks are merged with their buddies, so the allocator does not fragment over time.
+	Allocation and freeing are O(log(capacity/minBlockSize)).
+	@ingroup resources
+*/
+class BuddyResourceAllocator : public ResourceAllocator {
+public:
+	/**
+	 * @param capacity Size of the managed block. It is rounded down to a power of two multiple of @p minBlockSize.
+	 * @param minBlockSize The size of the smallest block (has to be a power of two).
+	 */
+	UTILAPI explicit BuddyResourceAllocator(uint64_t capacity, uint64_t minBlockSize=256);
+
+	using ResourceAllocator::allocate;
+	UTILAPI Allocation allocate(uint64_t size, uint64_t alignment=0) override;
+	UTILAPI void free(Allocation&& allocation) override;
+	UTILAPI Statistics getStatistics() const override;
+
+	uint64_t getMinBlockSize() const { return minBlockSize; }
+private:
+	uint64_t getBlockSize(uint32_t order) const { return minBlockSize << order; }
+
+	const uint64_t minBlockSize;
+	const uint32_t maxOrder;
+	std::vector<std::unordered_set<uint64_t>> freeLists; //!< offsets of the free blocks of each order
+	std::unordered_map<uint64_t, uint32_t> allocatedBlocks; //!< block offset -> order
+	uint64_t usedSize = 0;
+	uint64_t requestedSize = 0;
+	uint64_t peakUsedSize = 0;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_BUDDYRESOURCEALLOCATOR_H_ */
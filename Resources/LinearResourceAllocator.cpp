@@ -0,0 +1,70 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "LinearResourceAllocator.h"
+#include "../Macros.h"
+#include "../Utils.h"
+
+#include <algorithm>
+
+namespace Util {
+
+//-------------------
+
+LinearResourceAllocator::LinearResourceAllocator(uint64_t capacity) : ResourceAllocator(capacity) {}
+
+//-------------------
+
+ResourceAllocator::Allocation LinearResourceAllocator::allocate(uint64_t size, uint64_t alignment) {
+	const uint64_t offset = align(head, alignment);
+	if(size == 0 || offset > capacity || size > capacity - offset)
+		return invalidAllocation();
+	head = offset + size;
+	requestedSize += size;
+	peakUsedSize = std::max(peakUsedSize, head);
+	++allocationCount;
+	return {offset, size, nextHandle++};
+}
+
+//-------------------
+
+void LinearResourceAllocator::free(Allocation&& allocation) {
+	WARN_AND_RETURN_IF(!allocation.isValid() || allocation.handle < firstHandle || allocation.handle >= nextHandle, "LinearResourceAllocator: Cannot free invalid allocation.",);
+	WARN_AND_RETURN_IF(allocationCount == 0, "LinearResourceAllocator: Cannot free allocation. There are no allocations.",);
+	requestedSize -= allocation.size;
+	if(--allocationCount == 0)
+		reset();
+}
+
+//-------------------
+
+ResourceAllocator::Statistics LinearResourceAllocator::getStatistics() const {
+	Statistics stats;
+	stats.capacity = capacity;
+	stats.usedSize = head;
+	stats.requestedSize = requestedSize;
+	stats.peakUsedSize = peakUsedSize;
+	stats.allocationCount = allocationCount;
+	stats.freeBlockCount = head < capacity ? 1 : 0;
+	stats.largestFreeBlock = capacity - head;
+	return stats;
+}
+
+//-------------------
+
+void LinearResourceAllocator::reset() {
+	head = 0;
+	requestedSize = 0;
+	allocationCount = 0;
+	firstHandle = nextHandle; // invalidates the handles of all previous allocations
+}
+
+//-------------------
+
+} /* Util */
@@ -0,0 +1,44 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_LINEARRESOURCEALLOCATOR_H_
+#define UTIL_RESOURCES_LINEARRESOURCEALLOCATOR_H_
+
+#include "ResourceAllocator.h"
+
+namespace Util {
+
+/** LinearResourceAllocator
+	Bump allocator for transient data (e.g., per frame).
+	Allocations are placed one after another. Freeing single allocations does not make their space
+	available again; the allocator is reset automatically when all allocations are freed or manually by @p reset().
+	@ingroup resources
+*/
+class LinearResourceAllocator : public ResourceAllocator {
+public:
+	UTILAPI explicit LinearResourceAllocator(uint64_t capacity);
+
+	using ResourceAllocator::allocate;
+	UTILAPI Allocation allocate(uint64_t size, uint64_t alignment=0) override;
+	UTILAPI void free(Allocation&& allocation) override;
+	UTILAPI Statistics getStatistics() const override;
+
+	//! Discards all allocations at once.
+	UTILAPI void reset();
+private:
+	uint64_t head = 0;
+	uint64_t requestedSize = 0;
+	uint64_t peakUsedSize = 0;
+	uint64_t allocationCount = 0;
+	uint64_t firstHandle = 0;
+	uint64_t nextHandle = 0;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_LINEARRESOURCEALLOCATOR_H_ */
@@ -0,0 +1,220 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "MappedFileResource.h"
+#include "../Macros.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Util {
+
+//---------------
+
+static uint64_t getMappingGranularity() {
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwAllocationGranularity;
+#else
+	return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+//---------------
+
+MappedFileResource::Ref MappedFileResource::open(const FileName& file, const ResourceFormat& format, AccessMode mode, uint64_t offset, uint64_t size) {
+	Ref resource = new MappedFileResource(file, format, mode);
+	return resource->mapRegion(offset, size, false) ? resource : nullptr;
+}
+
+//---------------
+
+MappedFileResource::Ref MappedFileResource::create(const FileName& file, const ResourceFormat& format, uint64_t elementCount) {
+	WARN_AND_RETURN_IF(format.getSize() == 0 || elementCount == 0, "MappedFileResource: Cannot create empty file '" + file.toString() + "'.", nullptr);
+	Ref resource = new MappedFileResource(file, format, AccessMode::ReadWrite);
+	return resource->mapRegion(0, format.getSize() * elementCount, true) ? resource : nullptr;
+}
+
+//---------------
+
+MappedFileResource::MappedFileResource(const FileName& file, const ResourceFormat& format, AccessMode _mode) : Resource(format), fileName(file), mode(_mode) {}
+
+//---------------
+
+MappedFileResource::~MappedFileResource() {
+	release();
+}
+
+//---------------
+
+bool MappedFileResource::mapRegion(uint64_t offset, uint64_t size, bool createFile) {
+	WARN_AND_RETURN_IF(!fileName.getFSName().empty() && fileName.getFSName() != "file", "MappedFileResource: Only local files can be mapped: '" + fileName.toString() + "'.", false);
+	const std::string path = fileName.getPath();
+	const bool writable = mode == AccessMode::ReadWrite;
+	uint64_t fileSize = 0;
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, createFile ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	WARN_AND_RETURN_IF(file == INVALID_HANDLE_VALUE, "MappedFileResource: Could not open file '" + path + "'.", false);
+	fileHandle = reinterpret_cast<intptr_t>(file);
+	if(createFile) {
+		LARGE_INTEGER newSize;
+		newSize.QuadPart = static_cast<LONGLONG>(size);
+		WARN_AND_RETURN_IF(!SetFilePointerEx(file, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file), "MappedFileResource: Could not resize file '" + path + "'.", (release(), false));
+	}
+	LARGE_INTEGER currentSize;
+	WARN_AND_RETURN_IF(!GetFileSizeEx(file, &currentSize), "MappedFileResource: Could not query the size of file '" + path + "'.", (release(), false));
+	fileSize = static_cast<uint64_t>(currentSize.QuadPart);
+#else
+	const int file = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | (createFile ? (O_CREAT | O_TRUNC) : 0), 0644);
+	WARN_AND_RETURN_IF(file < 0, "MappedFileResource: Could not open file '" + path + "': " + std::strerror(errno), false);
+	fileHandle = file;
+	if(createFile)
+		WARN_AND_RETURN_IF(ftruncate(file, static_cast<off_t>(size)) != 0, "MappedFileResource: Could not resize file '" + path + "': " + std::strerror(errno), (release(), false));
+	struct stat fileStat;
+	WARN_AND_RETURN_IF(fstat(file, &fileStat) != 0, "MappedFileResource: Could not query the size of file '" + path + "': " + std::strerror(errno), (release(), false));
+	fileSize = static_cast<uint64_t>(fileStat.st_size);
+#endif
+	WARN_AND_RETURN_IF(offset > fileSize || size > fileSize - offset, "MappedFileResource: The region is out of range of file '" + path + "'.", (release(), false));
+	size = size == 0 ? fileSize - offset : size;
+	WARN_AND_RETURN_IF(size == 0, "MappedFileResource: Cannot map empty region of file '" + path + "'.", (release(), false));
+
+	// the offset of the mapping has to be a multiple of the page size (or allocation granularity)
+	const uint64_t alignedOffset = offset - offset % getMappingGranularity();
+	mappingSize = size + (offset - alignedOffset);
+#if defined(_WIN32)
+	const DWORD protection = mode == AccessMode::ReadWrite ? PAGE_READWRITE : (mode == AccessMode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY);
+	HANDLE mapping = CreateFileMappingA(file, nullptr, protection, 0, 0, nullptr);
+	WARN_AND_RETURN_IF(!mapping, "MappedFileResource: Could not create mapping of file '" + path + "'.", (release(), false));
+	mappingHandle = reinterpret_cast<intptr_t>(mapping);
+	const DWORD access = mode == AccessMode::ReadWrite ? FILE_MAP_WRITE : (mode == AccessMode::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ);
+	void* ptr = MapViewOfFile(mapping, access, static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset & 0xffffffffu), static_cast<SIZE_T>(mappingSize));
+	WARN_AND_RETURN_IF(!ptr, "MappedFileResource: Could not map file '" + path + "'.", (release(), false));
+#else
+	const int protection = mode == AccessMode::ReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+	const int flags = mode == AccessMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+	void* ptr = mmap(nullptr, mappingSize, protection, flags, file, static_cast<off_t>(alignedOffset));
+	WARN_AND_RETURN_IF(ptr == MAP_FAILED, "MappedFileResource: Could not map file '" + path + "': " + std::strerror(errno), (release(), false));
+#endif
+	mappingBase = static_cast<uint8_t*>(ptr);
+	data = mappingBase + (offset - alignedOffset);
+	fileOffset = offset;
+	dataSize = size;
+	return true;
+}
+
+//---------------
+
+void MappedFileResource::flush() {
+	if(isDirtyTrackingEnabled()) {
+		for(const auto& range : getDirtyRanges())
+			flush(range.offset, range.size, false);
+	} else {
+		flush(0, dataSize, false);
+	}
+}
+
+//---------------
+
+void MappedFileResource::flush(uint64_t offset, uint64_t size, bool async) {
+	if(!data || mode != AccessMode::ReadWrite || size == 0)
+		return;
+	WARN_AND_RETURN_IF(!checkRange(offset, size), "MappedFileResource: Cannot flush data. Size + offset is out of range.",);
+	// the flushed range has to start at a page boundary
+	uint8_t* begin = data + offset;
+	const uint64_t pageOffset = static_cast<uint64_t>(begin - mappingBase) % getMappingGranularity();
+	begin -= pageOffset;
+	size += pageOffset;
+#if defined(_WIN32)
+	WARN_IF(!FlushViewOfFile(begin, static_cast<SIZE_T>(size)), "MappedFileResource: Could not flush mapping of file '" + fileName.getPath() + "'.");
+	if(!async)
+		FlushFileBuffers(reinterpret_cast<HANDLE>(fileHandle));
+#else
+	WARN_IF(msync(begin, size, async ? MS_ASYNC : MS_SYNC) != 0, "MappedFileResource: Could not flush mapping of file '" + fileName.getPath() + "': " + std::strerror(errno));
+#endif
+}
+
+//---------------
+
+void MappedFileResource::release() {
+#if defined(_WIN32)
+	if(mappingBase)
+		UnmapViewOfFile(mappingBase);
+	if(mappingHandle)
+		CloseHandle(reinterpret_cast<HANDLE>(mappingHandle));
+	if(fileHandle != -1)
+		CloseHandle(reinterpret_cast<HANDLE>(fileHandle));
+#else
+	if(mappingBase)
+		munmap(mappingBase, mappingSize);
+	if(fileHandle != -1)
+		::close(static_cast<int>(fileHandle));
+#endif
+	mappingBase = nullptr;
+	data = nullptr;
+	mappingSize = 0;
+	mappingHandle = 0;
+	fileHandle = -1;
+	dataSize = 0;
+}
+
+//---------------
+
+void MappedFileResource::upload(const uint8_t* srcData, size_t size, size_t offset) {
+	WARN_AND_RETURN_IF(mode == AccessMode::ReadOnly, "MappedFileResource: Cannot upload data. The file '" + fileName.getPath() + "' is mapped read-only.",);
+	WARN_AND_RETURN_IF(!srcData || !data, "MappedFileResource: Cannot upload data. Invalid source data pointer or file is not mapped.",);
+	WARN_AND_RETURN_IF(!checkRange(offset, size), "MappedFileResource: Cannot upload data. Size + offset is out of range.",);
+	std::copy(srcData, srcData+size, data+offset);
+	markDirty(offset, size);
+	// instead of synchronously writing back the whole mapping (Resource::upload calls flush()), only the
+	// uploaded pages are scheduled for writing
+	flush(offset, size, true);
+}
+
+//---------------
+
+void MappedFileResource::advise(AccessHint hint, uint64_t offset, uint64_t size) {
+	if(!data)
+		return;
+	size = size == 0 && offset < dataSize ? dataSize - offset : size;
+	WARN_AND_RETURN_IF(!checkRange(offset, size), "MappedFileResource: Cannot advise access. Size + offset is out of range.",);
+#if defined(_WIN32)
+	// access hints are not supported
+#else
+	uint8_t* begin = data + offset;
+	const uint64_t pageOffset = static_cast<uint64_t>(begin - mappingBase) % getMappingGranularity();
+	begin -= pageOffset;
+	size += pageOffset;
+	int advice = MADV_NORMAL;
+	switch(hint) {
+		case AccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+		case AccessHint::Random: advice = MADV_RANDOM; break;
+		case AccessHint::WillNeed: advice = MADV_WILLNEED; break;
+		case AccessHint::DontNeed: advice = MADV_DONTNEED; break;
+		default: break;
+	}
+	WARN_IF(madvise(begin, size, advice) != 0, "MappedFileResource: madvise failed: " + std::string(std::strerror(errno)));
+#endif
+}
+
+//---------------
+
+} /* Util */
@@ -0,0 +1,108 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_MAPPEDFILERESOURCE_H_
+#define UTIL_RESOURCES_MAPPEDFILERESOURCE_H_
+
+#include "Resource.h"
+#include "../IO/FileName.h"
+
+namespace Util {
+
+/** MappedFileResource
+	Resource that is backed by a memory mapped region of a local file.
+	The data is paged in by the operating system on access, so resources can be much larger than the available memory.
+	@note Only files of the local file system ("file://") can be mapped.
+	@ingroup resources
+*/
+class MappedFileResource : public Resource {
+public:
+	using Ref = Reference<MappedFileResource>;
+
+	enum class AccessMode : uint8_t {
+		ReadOnly,		//!< The mapping can only be read. Writing to the mapped memory results in an access violation.
+		ReadWrite,		//!< Changes are written back to the file (MAP_SHARED).
+		CopyOnWrite		//!< Changes are private to this mapping and are not written back to the file (MAP_PRIVATE).
+	};
+
+	enum class AccessHint : uint8_t {
+		Normal,			//!< No special treatment (MADV_NORMAL).
+		Sequential,		//!< Pages are accessed in sequential order and can be read ahead aggressively (MADV_SEQUENTIAL).
+		Random,			//!< Pages are accessed in random order; read ahead is disabled (MADV_RANDOM).
+		WillNeed,		//!< The pages will be accessed soon and should be read in advance (MADV_WILLNEED).
+		DontNeed		//!< The pages will not be accessed in the near future and can be evicted (MADV_DONTNEED). Discards the changes of copy-on-write mappings.
+	};
+
+	/**
+	 * Maps a region of an existing file.
+	 * @param file The file name.
+	 * @param format The format of the elements stored in the file.
+	 * @param mode The access mode of the mapping.
+	 * @param offset Byte offset of the mapped region in the file (does not need to be page aligned).
+	 * @param size Size of the mapped region in bytes (0 = up to the end of the file).
+	 * @return The resource, or nullptr if the file could not be mapped.
+	 */
+	UTILAPI static Ref open(const FileName& file, const ResourceFormat& format, AccessMode mode=AccessMode::ReadOnly, uint64_t offset=0, uint64_t size=0);
+
+	/**
+	 * Creates (or truncates) a file with enough space for @p elementCount elements and maps it for reading and writing.
+	 * @return The resource, or nullptr if the file could not be created.
+	 */
+	UTILAPI static Ref create(const FileName& file, const ResourceFormat& format, uint64_t elementCount);
+
+	UTILAPI virtual ~MappedFileResource();
+
+	//! Returns the mapped memory (the mapping stays valid until the resource is released).
+	uint8_t* map() override { return data; }
+
+	//! Synchronously writes all changes of a read-write mapping back to the file (msync).
+	//! If dirty tracking is enabled, only the dirty ranges are written. They are not consumed, so a mirror of the file can still query them.
+	UTILAPI void flush() override;
+
+	//! Writes the changes of the given byte range back to the file, optionally without waiting for completion.
+	UTILAPI void flush(uint64_t offset, uint64_t size, bool async=false);
+
+	//! Unmaps the file. Afterwards, the resource is empty.
+	UTILAPI void release() override;
+
+	/**
+	 * Copies the data into the mapping and schedules the written pages for writing back to the file without waiting.
+	 * Call @p flush to wait until all changes have been written.
+	 */
+	UTILAPI void upload(const uint8_t* srcData, size_t size, size_t offset=0) override;
+	using Resource::upload;
+
+	/**
+	 * Gives the operating system a hint about how the given byte range will be accessed (madvise).
+	 * @param size Size of the range in bytes (0 = up to the end of the mapping).
+	 * @note Hints are ignored on platforms that do not support them.
+	 */
+	UTILAPI void advise(AccessHint hint, uint64_t offset=0, uint64_t size=0);
+
+	bool isValid() const { return data != nullptr; }
+	AccessMode getAccessMode() const { return mode; }
+	const FileName& getFileName() const { return fileName; }
+	//! Returns the byte offset of the mapped region in the file.
+	uint64_t getFileOffset() const { return fileOffset; }
+private:
+	MappedFileResource(const FileName& file, const ResourceFormat& format, AccessMode mode);
+	bool mapRegion(uint64_t offset, uint64_t size, bool createFile);
+
+	const FileName fileName;
+	const AccessMode mode;
+	uint64_t fileOffset = 0;
+	uint8_t* data = nullptr;
+	uint8_t* mappingBase = nullptr; //!< page aligned start of the mapping
+	uint64_t mappingSize = 0;
+	intptr_t fileHandle = -1;
+	intptr_t mappingHandle = 0; //!< file mapping object (Windows only)
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_MAPPEDFILERESOURCE_H_ */
@@ -0,0 +1,35 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "MemoryResource.h"
+
+namespace Util {
+
+//---------------
+
+MemoryResource::Ref MemoryResource::create(const ResourceFormat& format, uint64_t elementCount) {
+	return new MemoryResource(format, elementCount);
+}
+
+//---------------
+
+MemoryResource::MemoryResource(const ResourceFormat& format, uint64_t elementCount) : Resource(format), data(format.getSize() * elementCount) {
+	dataSize = data.size();
+}
+
+//---------------
+
+void MemoryResource::release() {
+	std::vector<uint8_t>().swap(data);
+	dataSize = 0;
+}
+
+//---------------
+
+} /* Util */
@@ -0,0 +1,40 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_MEMORYRESOURCE_H_
+#define UTIL_RESOURCES_MEMORYRESOURCE_H_
+
+#include "Resource.h"
+
+#include <vector>
+
+namespace Util {
+
+/** MemoryResource
+	Resource that is stored in main memory.
+	@ingroup resources
+*/
+class MemoryResource : public Resource {
+public:
+	using Ref = Reference<MemoryResource>;
+
+	//! Creates a resource with space for @p elementCount (zero initialized) elements.
+	UTILAPI static Ref create(const ResourceFormat& format, uint64_t elementCount);
+
+	uint8_t* map() override { return data.data(); }
+
+	//! Frees the memory. Afterwards, the resource is empty.
+	UTILAPI void release() override;
+private:
+	MemoryResource(const ResourceFormat& format, uint64_t elementCount);
+	std::vector<uint8_t> data;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_MEMORYRESOURCE_H_ */
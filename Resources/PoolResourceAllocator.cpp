@@ -0,0 +1,75 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "PoolResourceAllocator.h"
+#include "../Macros.h"
+#include "../Utils.h"
+
+#include <algorithm>
+
+namespace Util {
+
+//-------------------
+
+PoolResourceAllocator::PoolResourceAllocator(uint64_t _blockSize, uint32_t blockCount, uint64_t blockAlignment) :
+		ResourceAllocator(align(_blockSize, blockAlignment) * blockCount), blockSize(align(_blockSize, blockAlignment)), allocated(blockCount, false) {
+	freeBlocks.reserve(blockCount);
+	// the blocks are handed out in increasing order
+	for(uint32_t i=blockCount; i>0; --i)
+		freeBlocks.push_back(i-1);
+}
+
+//-------------------
+
+PoolResourceAllocator::PoolResourceAllocator(const ResourceFormat& format, uint64_t elementsPerBlock, uint32_t blockCount) :
+		PoolResourceAllocator(format.getSize() * elementsPerBlock, blockCount, format.getAlignment()) {}
+
+//-------------------
+
+ResourceAllocator::Allocation PoolResourceAllocator::allocate(uint64_t size, uint64_t alignment) {
+	if(size == 0 || size > blockSize || freeBlocks.empty())
+		return invalidAllocation();
+	if(alignment > 1 && blockSize % alignment != 0)
+		return invalidAllocation();
+	const uint32_t block = freeBlocks.back();
+	freeBlocks.pop_back();
+	allocated[block] = true;
+	requestedSize += size;
+	peakUsedSize = std::max(peakUsedSize, (allocated.size() - freeBlocks.size()) * blockSize);
+	return {block * blockSize, size, block};
+}
+
+//-------------------
+
+void PoolResourceAllocator::free(Allocation&& allocation) {
+	WARN_AND_RETURN_IF(!allocation.isValid() || allocation.handle >= allocated.size(), "PoolResourceAllocator: Cannot free invalid allocation.",);
+	const uint32_t block = static_cast<uint32_t>(allocation.handle);
+	WARN_AND_RETURN_IF(!allocated[block], "PoolResourceAllocator: Cannot free allocation. Block is not allocated.",);
+	allocated[block] = false;
+	requestedSize -= allocation.size;
+	freeBlocks.push_back(block);
+}
+
+//-------------------
+
+ResourceAllocator::Statistics PoolResourceAllocator::getStatistics() const {
+	Statistics stats;
+	stats.capacity = capacity;
+	stats.allocationCount = allocated.size() - freeBlocks.size();
+	stats.usedSize = stats.allocationCount * blockSize;
+	stats.requestedSize = requestedSize;
+	stats.peakUsedSize = peakUsedSize;
+	stats.freeBlockCount = freeBlocks.size();
+	stats.largestFreeBlock = freeBlocks.empty() ? 0 : blockSize;
+	return stats;
+}
+
+//-------------------
+
+} /* Util */
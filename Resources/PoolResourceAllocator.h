@@ -0,0 +1,52 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_POOLRESOURCEALLOCATOR_H_
+#define UTIL_RESOURCES_POOLRESOURCEALLOCATOR_H_
+
+#include "ResourceAllocator.h"
+
+#include <vector>
+
+namespace Util {
+
+/** PoolResourceAllocator
+	Allocator for blocks of a fixed size. Allocation and freeing are O(1).
+	@ingroup resources
+*/
+class PoolResourceAllocator : public ResourceAllocator {
+public:
+	/**
+	 * @param blockSize The size of each block. Allocations may not be larger than a block.
+	 * @param blockCount The number of blocks.
+	 * @param blockAlignment The block size is rounded up to a multiple of this alignment.
+	 */
+	UTILAPI PoolResourceAllocator(uint64_t blockSize, uint32_t blockCount, uint64_t blockAlignment=0);
+
+	//! Creates a pool with blocks that can hold @p elementsPerBlock elements of the given format.
+	UTILAPI PoolResourceAllocator(const ResourceFormat& format, uint64_t elementsPerBlock, uint32_t blockCount);
+
+	using ResourceAllocator::allocate;
+	//! @note Fails if @p size is larger than the block size or if the block size is not a multiple of @p alignment.
+	UTILAPI Allocation allocate(uint64_t size, uint64_t alignment=0) override;
+	UTILAPI void free(Allocation&& allocation) override;
+	UTILAPI Statistics getStatistics() const override;
+
+	uint64_t getBlockSize() const { return blockSize; }
+	uint32_t getBlockCount() const { return static_cast<uint32_t>(allocated.size()); }
+private:
+	const uint64_t blockSize;
+	std::vector<uint32_t> freeBlocks;
+	std::vector<bool> allocated;
+	uint64_t requestedSize = 0;
+	uint64_t peakUsedSize = 0;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_POOLRESOURCEALLOCATOR_H_ */
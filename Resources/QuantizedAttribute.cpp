@@ -0,0 +1,300 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "QuantizedAttribute.h"
+#include "AttributeAccessor.h"
+#include "AttributeConversion.h"
+#include "ResourceFormat.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Util {
+namespace QuantizedAttribute {
+
+static const uint32_t MAX_VALUE_COUNT = 16;
+static const uint64_t BLOCK_SIZE = 256; // number of elements that are decoded/encoded at once
+
+//-------------------------------------------------------------
+// QuantizedAttributeAccessor
+
+/**
+ * Base class for accessors of packed attributes. Subclasses only implement the bulk decoding/encoding
+ * of tightly packed elements to/from floats; all other accesses are mapped onto these functions.
+ */
+class QuantizedAttributeAccessor : public AttributeAccessor {
+public:
+	QuantizedAttributeAccessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride, uint32_t _valueCount) :
+		AttributeAccessor(ptr, size, attr, stride), valueCount(_valueCount) {
+		if(valueCount == 0 || valueCount > MAX_VALUE_COUNT)
+			throw std::invalid_argument("QuantizedAttributeAccessor: Unsupported number of values (" + std::to_string(valueCount) + ").");
+	}
+
+	uint32_t getValueCount() const override { return valueCount; }
+
+	//! Decodes @p count tightly packed elements into @p valueCount floats per element.
+	virtual void decode(const uint8_t* data, float* values, uint64_t count) const = 0;
+	//! Encodes @p count elements with @p valueCount floats per element into tightly packed elements.
+	virtual void encode(const float* values, uint8_t* data, uint64_t count) const = 0;
+
+	template<typename S>
+	void _readValues(uint64_t index, S* values, uint64_t count) const {
+		assertRange(index);
+		count = std::min<uint64_t>(count, valueCount);
+		float buffer[MAX_VALUE_COUNT];
+		decode(_ptr<const uint8_t>(index), buffer, 1);
+		std::transform(buffer, buffer + count, values, [](float v) { return static_cast<S>(v);});
+	}
+
+	template<typename S>
+	void _writeValues(uint64_t index, const S* values, uint64_t count) const {
+		assertRange(index);
+		count = std::min<uint64_t>(count, valueCount);
+		float buffer[MAX_VALUE_COUNT];
+		if(count < valueCount) // keep the remaining values
+			decode(_ptr<const uint8_t>(index), buffer, 1);
+		std::transform(values, values + count, buffer, [](S v) { return static_cast<float>(v);});
+		encode(buffer, _ptr<uint8_t>(index), 1);
+	}
+
+	template<typename S>
+	void _readRange(uint64_t firstIndex, uint64_t elementCount, S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		valueStride = valueStride == 0 ? valueCount : valueStride;
+		const bool packed = getStride() == getAttribute().getDataSize();
+		if(std::is_same<S,float>::value && packed && valueStride == valueCount) {
+			decode(_ptr<const uint8_t>(firstIndex), reinterpret_cast<float*>(values), elementCount);
+			return;
+		}
+		const uint64_t count = std::min<uint64_t>(valueStride, valueCount);
+		std::vector<float> buffer(std::min(elementCount, BLOCK_SIZE) * valueCount);
+		for(uint64_t first=0; first<elementCount; first+=BLOCK_SIZE) {
+			const uint64_t blockCount = std::min(BLOCK_SIZE, elementCount - first);
+			decodeBlock(firstIndex + first, blockCount, buffer.data());
+			for(uint64_t i=0; i<blockCount; ++i, values += valueStride)
+				std::transform(buffer.data() + i*valueCount, buffer.data() + i*valueCount + count, values, [](float v) { return static_cast<S>(v);});
+		}
+	}
+
+	template<typename S>
+	void _writeRange(uint64_t firstIndex, uint64_t elementCount, const S* values, uint64_t valueStride) const {
+		assertRange(firstIndex, elementCount);
+		valueStride = valueStride == 0 ? valueCount : valueStride;
+		const bool packed = getStride() == getAttribute().getDataSize();
+		if(std::is_same<S,float>::value && packed && valueStride == valueCount) {
+			encode(reinterpret_cast<const float*>(values), _ptr<uint8_t>(firstIndex), elementCount);
+			return;
+		}
+		const uint64_t count = std::min<uint64_t>(valueStride, valueCount);
+		std::vector<float> buffer(std::min(elementCount, BLOCK_SIZE) * valueCount);
+		for(uint64_t first=0; first<elementCount; first+=BLOCK_SIZE) {
+			const uint64_t blockCount = std::min(BLOCK_SIZE, elementCount - first);
+			if(count < valueCount) // keep the remaining values
+				decodeBlock(firstIndex + first, blockCount, buffer.data());
+			for(uint64_t i=0; i<blockCount; ++i, values += valueStride)
+				std::transform(values, values + count, buffer.data() + i*valueCount, [](S v) { return static_cast<float>(v);});
+			encodeBlock(firstIndex + first, blockCount, buffer.data());
+		}
+	}
+
+	virtual void readValues(uint64_t index, int8_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, int16_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, int32_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, int64_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint8_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint16_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint32_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, uint64_t* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, float* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void readValues(uint64_t index, double* values, uint64_t count) const { _readValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int8_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int16_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int32_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const int64_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint8_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint16_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint32_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const uint64_t* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const float* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void writeValues(uint64_t index, const double* values, uint64_t count) const { _writeValues(index, values, count); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, int64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint8_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint16_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint32_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, uint64_t* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, float* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void readRange(uint64_t firstIndex, uint64_t elementCount, double* values, uint64_t valueStride) const { _readRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const int64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint8_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint16_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint32_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const uint64_t* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const float* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+	virtual void writeRange(uint64_t firstIndex, uint64_t elementCount, const double* values, uint64_t valueStride) const { _writeRange(firstIndex, elementCount, values, valueStride); }
+private:
+	void decodeBlock(uint64_t firstIndex, uint64_t count, float* buffer) const {
+		if(getStride() == getAttribute().getDataSize()) {
+			decode(_ptr<const uint8_t>(firstIndex), buffer, count);
+			return;
+		}
+		for(uint64_t i=0; i<count; ++i)
+			decode(_ptr<const uint8_t>(firstIndex + i), buffer + i*valueCount, 1);
+	}
+
+	void encodeBlock(uint64_t firstIndex, uint64_t count, const float* buffer) const {
+		if(getStride() == getAttribute().getDataSize()) {
+			encode(buffer, _ptr<uint8_t>(firstIndex), count);
+			return;
+		}
+		for(uint64_t i=0; i<count; ++i)
+			encode(buffer + i*valueCount, _ptr<uint8_t>(firstIndex + i), 1);
+	}
+
+	const uint32_t valueCount;
+};
+
+//-------------------------------------------------------------
+// OctahedralAccessor
+
+class OctahedralAccessor : public QuantizedAttributeAccessor {
+public:
+	OctahedralAccessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) : QuantizedAttributeAccessor(ptr, size, attr, stride, 3) {}
+
+	void decode(const uint8_t* data, float* values, uint64_t count) const override {
+		AttributeConversion::decodeOctahedral(data, getAttribute().getDataType(), values, count);
+	}
+	void encode(const float* values, uint8_t* data, uint64_t count) const override {
+		AttributeConversion::encodeOctahedral(values, data, getAttribute().getDataType(), count);
+	}
+};
+
+static Reference<AttributeAccessor> createOctahedralAccessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) {
+	if(attr.getComponentCount() != 2)
+		throw std::invalid_argument("OctahedralAccessor: Invalid attribute '" + attr.toString() + "'. Expected 2 components.");
+	switch(attr.getDataType()) {
+		case TypeConstant::INT8:
+		case TypeConstant::INT16: return new OctahedralAccessor(ptr, size, attr, stride);
+		default: throw std::invalid_argument("OctahedralAccessor: Invalid attribute '" + attr.toString() + "'. Expected INT8 or INT16.");
+	}
+}
+
+static const bool octahedralAccRegistered = AttributeAccessor::registerAccessor(INTERNAL_TYPE_OCTAHEDRAL, createOctahedralAccessor);
+
+//-------------------------------------------------------------
+// Packed10_10_10_2Accessor
+
+template<bool isSigned>
+class Packed10_10_10_2Accessor : public QuantizedAttributeAccessor {
+public:
+	Packed10_10_10_2Accessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) : QuantizedAttributeAccessor(ptr, size, attr, stride, 4) {
+		if(attr.getDataSize() != 4)
+			throw std::invalid_argument("Packed10_10_10_2Accessor: Invalid attribute '" + attr.toString() + "'. Expected a single 32 bit value.");
+	}
+
+	void decode(const uint8_t* data, float* values, uint64_t count) const override {
+		if(isSigned)
+			AttributeConversion::decodeSnorm10_10_10_2(data, values, count);
+		else
+			AttributeConversion::decodeUnorm10_10_10_2(data, values, count);
+	}
+	void encode(const float* values, uint8_t* data, uint64_t count) const override {
+		if(isSigned)
+			AttributeConversion::encodeSnorm10_10_10_2(values, data, count);
+		else
+			AttributeConversion::encodeUnorm10_10_10_2(values, data, count);
+	}
+};
+
+template<bool isSigned>
+static Reference<AttributeAccessor> createPacked10_10_10_2Accessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) {
+	return new Packed10_10_10_2Accessor<isSigned>(ptr, size, attr, stride);
+}
+
+static const bool snormAccRegistered = AttributeAccessor::registerAccessor(INTERNAL_TYPE_SNORM_10_10_10_2, createPacked10_10_10_2Accessor<true>);
+static const bool unormAccRegistered = AttributeAccessor::registerAccessor(INTERNAL_TYPE_UNORM_10_10_10_2, createPacked10_10_10_2Accessor<false>);
+
+//-------------------------------------------------------------
+// FixedPointAccessor
+
+template<typename T>
+class FixedPointAccessor : public QuantizedAttributeAccessor {
+public:
+	FixedPointAccessor(uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride, const std::vector<float>& min, const std::vector<float>& max) :
+			QuantizedAttributeAccessor(ptr, size, attr, stride, attr.getComponentCount()), offset(min), scale(min.size()), invScale(min.size()) {
+		if(min.size() < attr.getComponentCount() || max.size() < attr.getComponentCount())
+			throw std::invalid_argument("FixedPointAccessor: The range has fewer components than the attribute '" + attr.toString() + "'.");
+		for(size_t c=0; c<min.size(); ++c) {
+			scale[c] = (max[c] - min[c]) / static_cast<float>(std::numeric_limits<T>::max());
+			invScale[c] = scale[c] != 0.0f ? 1.0f / scale[c] : 0.0f;
+		}
+	}
+
+	void decode(const uint8_t* data, float* values, uint64_t count) const override {
+		AttributeConversion::dequantize(data, getAttribute().getDataType(), values, count, getValueCount(), offset.data(), scale.data());
+	}
+	void encode(const float* values, uint8_t* data, uint64_t count) const override {
+		AttributeConversion::quantize(values, data, getAttribute().getDataType(), count, getValueCount(), offset.data(), invScale.data());
+	}
+private:
+	const std::vector<float> offset;
+	std::vector<float> scale;
+	std::vector<float> invScale;
+};
+
+//-------------------------------------------------------------
+
+bool registerFixedPoint(uint32_t internalType, const std::vector<float>& min, const std::vector<float>& max) {
+	if(min.size() != max.size())
+		throw std::invalid_argument("QuantizedAttribute: The minimum and maximum of a fixed point range need the same number of components.");
+	return AttributeAccessor::registerAccessor(internalType, [min, max](uint8_t* ptr, uint64_t size, const AttributeFormat& attr, uint64_t stride) -> Reference<AttributeAccessor> {
+		switch(attr.getDataType()) {
+			case TypeConstant::UINT8: return new FixedPointAccessor<uint8_t>(ptr, size, attr, stride, min, max);
+			case TypeConstant::UINT16: return new FixedPointAccessor<uint16_t>(ptr, size, attr, stride, min, max);
+			case TypeConstant::UINT32: return new FixedPointAccessor<uint32_t>(ptr, size, attr, stride, min, max);
+			default: throw std::invalid_argument("FixedPointAccessor: Invalid attribute '" + attr.toString() + "'. Expected UINT8, UINT16 or UINT32.");
+		}
+	});
+}
+
+//-------------------------------------------------------------
+
+const AttributeFormat& appendOctahedral(ResourceFormat& format, const StringIdentifier& nameId, TypeConstant type) {
+	return format.appendAttribute(nameId, type, 2, true, INTERNAL_TYPE_OCTAHEDRAL);
+}
+
+//-------------------------------------------------------------
+
+const AttributeFormat& appendSnorm10_10_10_2(ResourceFormat& format, const StringIdentifier& nameId) {
+	return format.appendAttribute(nameId, TypeConstant::UINT32, 1, true, INTERNAL_TYPE_SNORM_10_10_10_2);
+}
+
+//-------------------------------------------------------------
+
+const AttributeFormat& appendUnorm10_10_10_2(ResourceFormat& format, const StringIdentifier& nameId) {
+	return format.appendAttribute(nameId, TypeConstant::UINT32, 1, true, INTERNAL_TYPE_UNORM_10_10_10_2);
+}
+
+//-------------------------------------------------------------
+
+const AttributeFormat& appendFixedPoint(ResourceFormat& format, const StringIdentifier& nameId, uint32_t internalType, TypeConstant type, uint32_t components) {
+	return format.appendAttribute(nameId, type, components, false, internalType);
+}
+
+//-------------------------------------------------------------
+
+} /* QuantizedAttribute */
+} /* Util */
@@ -0,0 +1,65 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_QUANTIZEDATTRIBUTE_H_
+#define UTIL_RESOURCES_QUANTIZEDATTRIBUTE_H_
+
+#include "AttributeFormat.h"
+#include "../Hashing.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Util {
+class ResourceFormat;
+
+/**
+ * Quantized (compressed) attribute types, e.g., for compact vertex data.
+ *
+ * The attributes are stored in their packed form and use an internal type with a registered accessor,
+ * so they can be read and written through the AttributeAccessor (e.g., @p readValues<float>) like any other attribute.
+ * The number of values per element differs from the component count of the packed attribute (see @p AttributeAccessor::getValueCount):
+ * - octahedral: unit vector (3 values) encoded in 2 signed normalized INT8 or INT16 components.
+ * - snorm/unorm 10_10_10_2: 4 values ([-1,1] or [0,1]) packed into one UINT32 (x: bits 0-9, y: bits 10-19, z: bits 20-29, w: bits 30-31).
+ * - fixed point: UINT8, UINT16 or UINT32 components relative to a range, which is registered with an internal type (see @p registerFixedPoint).
+ * @ingroup resources
+ */
+namespace QuantizedAttribute {
+
+//! Internal type identifiers for quantized attributes
+enum InternalType_t : uint32_t {
+	INTERNAL_TYPE_OCTAHEDRAL = hash32("OCTAHEDRAL"),
+	INTERNAL_TYPE_SNORM_10_10_10_2 = hash32("SNORM_10_10_10_2"),
+	INTERNAL_TYPE_UNORM_10_10_10_2 = hash32("UNORM_10_10_10_2"),
+};
+
+//! Appends an octahedral encoded unit vector (@p type is INT8 or INT16).
+UTILAPI const AttributeFormat& appendOctahedral(ResourceFormat& format, const StringIdentifier& nameId, TypeConstant type=TypeConstant::INT16);
+
+//! Appends a vector with three signed normalized 10 bit components and a 2 bit w component (e.g., a tangent with its handedness).
+UTILAPI const AttributeFormat& appendSnorm10_10_10_2(ResourceFormat& format, const StringIdentifier& nameId);
+
+//! Appends a vector with three unsigned normalized 10 bit components and a 2 bit w component.
+UTILAPI const AttributeFormat& appendUnorm10_10_10_2(ResourceFormat& format, const StringIdentifier& nameId);
+
+/**
+ * Registers an accessor for fixed point values relative to the range [min,max] (per component) for the given internal type.
+ * Attributes with this internal type map each component of type UINT8, UINT16 or UINT32 linearly to the range,
+ * e.g., 16 bit positions relative to the bounding box of a mesh.
+ * @note Each range needs its own internal type. As for all accessors, only the first registration of an internal type is used.
+ */
+UTILAPI bool registerFixedPoint(uint32_t internalType, const std::vector<float>& min, const std::vector<float>& max);
+
+//! Appends a fixed point attribute with the given (registered) internal type (@p type is UINT8, UINT16 or UINT32).
+UTILAPI const AttributeFormat& appendFixedPoint(ResourceFormat& format, const StringIdentifier& nameId, uint32_t internalType,
+	TypeConstant type=TypeConstant::UINT16, uint32_t components=3);
+
+}
+}
+
+#endif /* end of include guard: UTIL_RESOURCES_QUANTIZEDATTRIBUTE_H_ */
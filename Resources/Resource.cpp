@@ -10,14 +10,30 @@
 #include "Resource.h"
 #include "../Macros.h"
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+
 namespace Util {
 
 //---------------
 
+struct Resource::DirtyRangeSet {
+	std::mutex mutex;
+	std::map<uint64_t, uint64_t> ranges; //!< begin -> end (exclusive)
+	uint64_t mergeGap = 0;
+};
+
+//---------------
+
 Resource::Resource(const ResourceFormat& format, ResourceAllocator* allocator) : format(format), allocator(allocator) {}
 
 //---------------
 
+Resource::~Resource() = default;
+
+//---------------
+
 void Resource::upload(const uint8_t* srcData, size_t size, size_t offset) {
 	WARN_AND_RETURN_IF(!srcData, "Resource: Cannot upload data. Invalid source data pointer.",);
 	WARN_AND_RETURN_IF(!checkRange(offset, size), "Resource: Cannot upload data. Size + offset is out of range.",);
@@ -25,6 +41,7 @@ void Resource::upload(const uint8_t* srcData, size_t size, size_t offset) {
 	WARN_AND_RETURN_IF(!ptr, "Resource: Cannot upload data. map() returned nullptr.",);
 	std::copy(srcData, srcData+size, ptr+offset);
 	unmap();
+	markDirty(offset, size);
 	flush();
 }
 
@@ -41,4 +58,73 @@ void Resource::download(uint8_t* tgtData, size_t size, size_t offset) {
 
 //---------------
 
-} /* Util */
\ No newline at end of file
+void Resource::setDirtyTracking(bool enabled, uint64_t mergeGap) {
+	if(!enabled) {
+		dirtyRanges.reset();
+	} else {
+		if(!dirtyRanges)
+			dirtyRanges.reset(new DirtyRangeSet);
+		dirtyRanges->mergeGap = mergeGap;
+	}
+}
+
+//---------------
+
+void Resource::_markDirty(uint64_t offset, uint64_t size) {
+	WARN_AND_RETURN_IF(!checkRange(offset, size), "Resource: Cannot mark range as dirty. Size + offset is out of range.",);
+	std::lock_guard<std::mutex> lock(dirtyRanges->mutex);
+	auto& ranges = dirtyRanges->ranges;
+	const uint64_t gap = dirtyRanges->mergeGap;
+	uint64_t begin = offset;
+	uint64_t end = offset + size;
+	// merge with all ranges that overlap [begin-gap, end+gap)
+	auto it = ranges.upper_bound(begin);
+	if(it != ranges.begin() && std::prev(it)->second + gap >= begin)
+		--it;
+	while(it != ranges.end() && it->first <= end + gap) {
+		begin = std::min(begin, it->first);
+		end = std::max(end, it->second);
+		it = ranges.erase(it);
+	}
+	ranges.emplace_hint(it, begin, end);
+}
+
+//---------------
+
+std::vector<Resource::DirtyRange> Resource::getDirtyRanges() const {
+	std::vector<DirtyRange> result;
+	if(!dirtyRanges)
+		return result;
+	std::lock_guard<std::mutex> lock(dirtyRanges->mutex);
+	result.reserve(dirtyRanges->ranges.size());
+	for(const auto& range : dirtyRanges->ranges)
+		result.push_back({range.first, range.second - range.first});
+	return result;
+}
+
+//---------------
+
+std::vector<Resource::DirtyRange> Resource::consumeDirtyRanges() {
+	std::vector<DirtyRange> result;
+	if(!dirtyRanges)
+		return result;
+	std::lock_guard<std::mutex> lock(dirtyRanges->mutex);
+	result.reserve(dirtyRanges->ranges.size());
+	for(const auto& range : dirtyRanges->ranges)
+		result.push_back({range.first, range.second - range.first});
+	dirtyRanges->ranges.clear();
+	return result;
+}
+
+//---------------
+
+bool Resource::hasDirtyRanges() const {
+	if(!dirtyRanges)
+		return false;
+	std::lock_guard<std::mutex> lock(dirtyRanges->mutex);
+	return !dirtyRanges->ranges.empty();
+}
+
+//---------------
+
+} /* Util */
@@ -14,13 +14,32 @@
 #include "ResourceFormat.h"
 #include "../ReferenceCounter.h"
 
-#include <vector>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace Util {
+class Resource;
+class ResourcePool;
+
+/**
+ * Release handler of Resource.
+ * Resources that were acquired from a ResourcePool are returned to their pool when the last reference is removed;
+ * all other resources are deleted.
+ */
+struct ResourceReleaseHandler {
+	UTILAPI static void release(Resource* resource);
+};
 
-class Resource : public Util::ReferenceCounter<Resource> {
+class Resource : public Util::ReferenceCounter<Resource, ResourceReleaseHandler> {
 public:
+	//! Byte range of modified data.
+	struct DirtyRange {
+		uint64_t offset;
+		uint64_t size;
+		bool operator==(const DirtyRange& o) const { return offset == o.offset && size == o.size; }
+	};
+
 	UTILAPI explicit Resource(const ResourceFormat& format, ResourceAllocator* allocator=nullptr);
 	UTILAPI virtual ~Resource();
 	Resource(const Resource&) = delete;
@@ -40,7 +59,7 @@ public:
 	template<typename T>
 	std::vector<T> download(size_t numberOfElements, size_t offset=0) {
 		std::vector<T> result(numberOfElements);
-		download(reinterpret_cast<const T*>(result.data()), numberOfElements*sizeof(T), offset);
+		download(reinterpret_cast<uint8_t*>(result.data()), numberOfElements*sizeof(T), offset);
 		return result;
 	}
 
@@ -52,12 +71,69 @@ public:
 
 	size_t getSize() const { return dataSize; }
 	const ResourceFormat& getFormat() const { return format; }
+
+	//! Returns the number of elements that fit into the resource.
+	uint64_t getElementCount() const { return format.getSize() > 0 ? dataSize / format.getSize() : 0; }
+
+	/**
+	 * Returns a view of @p count elements starting at @p firstElement, which shares the storage of this resource (see ResourceView).
+	 * @throws std::range_error if the range exceeds the resource.
+	 */
+	UTILAPI Reference<Resource> view(uint64_t firstElement, uint64_t count);
+
+	/**
+	 * Returns a view of the given attributes of @p count elements starting at @p firstElement.
+	 * The attributes keep their offsets and the view keeps the element size of this resource.
+	 * @throws std::range_error if the range exceeds the resource.
+	 * @throws std::invalid_argument if an attribute does not exist.
+	 */
+	UTILAPI Reference<Resource> view(const std::vector<StringIdentifier>& attributes, uint64_t firstElement, uint64_t count);
+
+	//! Returns a view of the given attributes of all elements.
+	Reference<Resource> view(const std::vector<StringIdentifier>& attributes) { return view(attributes, 0, getElementCount()); }
+
+	/**
+	 * Enables or disables the tracking of modified byte ranges.
+	 * When enabled, uploads and writes through a ResourceAccessor mark the written bytes as dirty,
+	 * so the modified data can be queried with @p consumeDirtyRanges (e.g., to only send the changes to a mirror of the resource).
+	 * @param mergeGap Dirty ranges that are separated by at most this many bytes are merged into a single range.
+	 * @note Disabling the tracking discards all dirty ranges.
+	 */
+	UTILAPI void setDirtyTracking(bool enabled, uint64_t mergeGap=0);
+	virtual bool isDirtyTrackingEnabled() const { return dirtyRanges != nullptr; }
+
+	//! Marks the given byte range as modified (only if dirty tracking is enabled).
+	virtual void markDirty(uint64_t offset, uint64_t size) {
+		if(dirtyRanges && size > 0)
+			_markDirty(offset, size);
+	}
+
+	/**
+	 * Returns the modified byte ranges in increasing order and resets them.
+	 * Overlapping and adjacent ranges (and ranges closer than the merge gap) are combined.
+	 * @note This function is thread-safe.
+	 */
+	UTILAPI std::vector<DirtyRange> consumeDirtyRanges();
+
+	//! Returns the modified byte ranges like @p consumeDirtyRanges, but keeps them (e.g., to write them back before they are consumed).
+	UTILAPI std::vector<DirtyRange> getDirtyRanges() const;
+
+	//! Returns @p true if there are modified bytes since the last call of @p consumeDirtyRanges.
+	UTILAPI bool hasDirtyRanges() const;
 protected:
 	size_t dataSize = 0;
 	bool checkRange(size_t offset, size_t size) const { return offset+size <= dataSize; }
 private:
+	struct DirtyRangeSet;
+	UTILAPI void _markDirty(uint64_t offset, uint64_t size);
+	friend class ResourcePool;
+	friend struct ResourceReleaseHandler;
+
 	ResourceFormat format;
 	ResourceAllocator* allocator = nullptr;
+	std::unique_ptr<DirtyRangeSet> dirtyRanges;
+	ResourcePool* pool = nullptr; //!< Pool the resource is returned to when it is released (if any).
+	uint64_t poolCapacity = 0; //!< Capacity bucket the resource was acquired for (key of the pool's free list).
 };
 
 } /* Util */
@@ -10,21 +10,42 @@
 #include "ResourceAccessor.h"
 #include "Resource.h"
 
+#include <cmath>
+#include <limits>
+
 namespace Util {
 
 //-------------------
 
-ResourceAccessor::ResourceAccessor(uint8_t* ptr, uint64_t size, ResourceFormat format) : resource(nullptr), format(format), dataPtr(ptr), dataSize(size), elementCount(size / format.getSize()) {
-	const auto& attributes = format.getAttributes();
-	accessors.resize(attributes.size());
-	for(uint32_t i=0; i<attributes.size(); ++i) {
-		locations[attributes[i].getNameId()] = i;
-		accessors[i] = AttributeAccessor::create(dataPtr, size, attributes[i], format.getSize());
+ResourceAccessor::ResourceAccessor(uint8_t* ptr, uint64_t size, const ResourceFormat& _format) : resource(nullptr), layout(ResourceLayout::get(_format)), 
+		format(layout->getFormat()), dataPtr(ptr), dataSize(size), elementCount(format.getSize() > 0 ? size / format.getSize() : 0) {
+	for(auto& slot : inlineAccessors)
+		slot.store(nullptr, std::memory_order_relaxed);
+	if(format.getNumAttributes() > INLINE_ACCESSORS) {
+		const uint32_t count = format.getNumAttributes() - INLINE_ACCESSORS;
+		additionalAccessors.reset(new AccessorSlot_t[count]);
+		for(uint32_t i=0; i<count; ++i)
+			additionalAccessors[i].store(nullptr, std::memory_order_relaxed);
 	}
 }
 
 //-------------------
 
+AttributeAccessor* ResourceAccessor::createAccessor(uint32_t location) const {
+	auto accessor = layout->createAccessor(location, dataPtr, dataSize);
+	if(!accessor)
+		return nullptr;
+	// concurrent readers may create the accessor at the same time; the first one is kept
+	AttributeAccessor* expected = nullptr;
+	if(getAccessorSlot(location).compare_exchange_strong(expected, accessor.get(), std::memory_order_acq_rel)) {
+		AttributeAccessor::addReference(accessor.get());
+		return accessor.get();
+	}
+	return expected;
+}
+
+//-------------------
+
 ResourceAccessor::ResourceAccessor(const ResourceRef& _resource) : ResourceAccessor(_resource->map(), _resource->getSize(), _resource->getFormat()) {
 	resource = _resource;
 }
@@ -33,6 +54,8 @@ ResourceAccessor::ResourceAccessor(const ResourceRef& _resource) : ResourceAcces
 //-------------------
 
 ResourceAccessor::~ResourceAccessor() {
+	for(uint32_t i=0; i<format.getNumAttributes(); ++i)
+		AttributeAccessor::removeReference(getAccessorSlot(i).load(std::memory_order_relaxed));
 	if(resource) {
 		resource->unmap();
 	}
@@ -41,7 +64,7 @@ ResourceAccessor::~ResourceAccessor() {
 //-------------------
 
 void ResourceAccessor::readRaw(uint64_t index, uint8_t* targetPtr, uint64_t count) {
-	assertRangeLocation(index+count-1, 0);
+	assertRangeLocation(index, 0, count);
 	const uint8_t* ptr = dataPtr + index*format.getSize();
 	std::copy(ptr, ptr + count*format.getSize(), targetPtr);
 }
@@ -49,9 +72,132 @@ void ResourceAccessor::readRaw(uint64_t index, uint8_t* targetPtr, uint64_t coun
 //-------------------
 
 void ResourceAccessor::writeRaw(uint64_t index, const uint8_t* sourcePtr, uint64_t count) {
-	assertRangeLocation(index+count-1, 0);
+	assertRangeLocation(index, 0, count);
 	uint8_t* ptr = dataPtr + index*format.getSize();
 	std::copy(sourcePtr, sourcePtr + count*format.getSize(), ptr);
+	if(resource)
+		resource->markDirty(index*format.getSize(), count*format.getSize());
+}
+
+//-------------------
+
+void ResourceAccessor::_markDirty(uint64_t index, uint32_t location, uint64_t count) {
+	if(count == 0 || !resource->isDirtyTrackingEnabled())
+		return;
+	const auto& attr = format.getAttribute(location);
+	resource->markDirty(index*format.getSize() + attr.getOffset(), (count-1)*format.getSize() + attr.getDataSize());
+}
+
+//-------------------
+// reductions
+
+// The reduction kernels keep separate accumulators for LANES consecutive elements, so the inner loops
+// run over LANES * valueCount contiguous values without dependencies and can be vectorized.
+static const uint32_t LANES = 4;
+
+//! Folds the accumulators of all lanes into the first lane.
+template<typename Fn>
+static void foldLanes(std::vector<double>& acc, uint32_t valueCount, const Fn& fn) {
+	for(uint32_t l=1; l<LANES; ++l)
+		for(uint32_t c=0; c<valueCount; ++c)
+			acc[c] = fn(acc[c], acc[l*valueCount + c]);
+	acc.resize(valueCount);
+}
+
+//-------------------
+
+ResourceAccessor::Bounds ResourceAccessor::computeBounds(uint32_t location, uint32_t threadCount) const {
+	const uint32_t n = getValueCount(location);
+	const uint32_t width = LANES * n;
+	const double inf = std::numeric_limits<double>::infinity();
+	std::vector<double> identity(2 * width);
+	std::fill(identity.begin(), identity.begin() + width, inf);
+	std::fill(identity.begin() + width, identity.end(), -inf);
+	// comparisons with NaN are false, so NaN values are ignored
+	const auto minFn = [](double a, double b) { return b < a ? b : a; };
+	const auto maxFn = [](double a, double b) { return b > a ? b : a; };
+
+	auto acc = reduce(location, identity, [&](std::vector<double>& result, const double* values, uint64_t count) {
+		double* mins = result.data();
+		double* maxs = result.data() + width;
+		const uint64_t vectorEnd = (count / LANES) * width;
+		for(uint64_t i=0; i<vectorEnd; i+=width) {
+			for(uint32_t j=0; j<width; ++j) {
+				mins[j] = minFn(mins[j], values[i+j]);
+				maxs[j] = maxFn(maxs[j], values[i+j]);
+			}
+		}
+		for(uint64_t i=vectorEnd; i<count*n; i+=n) {
+			for(uint32_t c=0; c<n; ++c) {
+				mins[c] = minFn(mins[c], values[i+c]);
+				maxs[c] = maxFn(maxs[c], values[i+c]);
+			}
+		}
+	}, [&](std::vector<double>& result, const std::vector<double>& partial) {
+		for(uint32_t j=0; j<width; ++j) {
+			result[j] = minFn(result[j], partial[j]);
+			result[width+j] = maxFn(result[width+j], partial[width+j]);
+		}
+	}, threadCount);
+
+	Bounds bounds;
+	bounds.min.assign(acc.begin(), acc.begin() + width);
+	bounds.max.assign(acc.begin() + width, acc.end());
+	foldLanes(bounds.min, n, minFn);
+	foldLanes(bounds.max, n, maxFn);
+	return bounds;
+}
+
+//-------------------
+
+std::pair<double,double> ResourceAccessor::minMax(uint32_t location, uint32_t component, uint32_t threadCount) const {
+	if(component >= getValueCount(location))
+		throw std::range_error("ResourceAccessor: Invalid component " + std::to_string(component) + " of attribute '" + format.getAttribute(location).toString() + "'.");
+	const auto bounds = computeBounds(location, threadCount);
+	return {bounds.min[component], bounds.max[component]};
+}
+
+//-------------------
+
+std::vector<double> ResourceAccessor::sum(uint32_t location, uint32_t threadCount) const {
+	const uint32_t n = getValueCount(location);
+	const uint32_t width = LANES * n;
+	auto acc = reduce(location, std::vector<double>(width, 0.0), [&](std::vector<double>& result, const double* values, uint64_t count) {
+		double* sums = result.data();
+		const uint64_t vectorEnd = (count / LANES) * width;
+		for(uint64_t i=0; i<vectorEnd; i+=width)
+			for(uint32_t j=0; j<width; ++j)
+				sums[j] += values[i+j];
+		for(uint64_t i=vectorEnd; i<count*n; i+=n)
+			for(uint32_t c=0; c<n; ++c)
+				sums[c] += values[i+c];
+	}, [&](std::vector<double>& result, const std::vector<double>& partial) {
+		for(uint32_t j=0; j<width; ++j)
+			result[j] += partial[j];
+	}, threadCount);
+	foldLanes(acc, n, [](double a, double b) { return a + b; });
+	return acc;
+}
+
+//-------------------
+
+std::vector<uint64_t> ResourceAccessor::histogram(uint32_t location, uint32_t bins, double min, double max, uint32_t component, uint32_t threadCount) const {
+	const uint32_t n = getValueCount(location);
+	if(component >= n)
+		throw std::range_error("ResourceAccessor: Invalid component " + std::to_string(component) + " of attribute '" + format.getAttribute(location).toString() + "'.");
+	if(bins == 0 || !(min <= max))
+		return std::vector<uint64_t>(bins, 0);
+	const double scale = max > min ? bins / (max - min) : 0.0;
+	return reduce(location, std::vector<uint64_t>(bins, 0), [&](std::vector<uint64_t>& result, const double* values, uint64_t count) {
+		for(uint64_t i=0; i<count; ++i) {
+			const double v = values[i*n + component];
+			if(v >= min && v <= max) // false for NaN
+				++result[std::min<uint64_t>(bins - 1, static_cast<uint64_t>((v - min) * scale))];
+		}
+	}, [&](std::vector<uint64_t>& result, const std::vector<uint64_t>& partial) {
+		for(uint32_t b=0; b<bins; ++b)
+			result[b] += partial[b];
+	}, threadCount);
 }
 
 //-------------------
@@ -9,15 +9,22 @@
 #ifndef UTIL_RESOURCES_RESOURCEACCESSOR_H_
 #define UTIL_RESOURCES_RESOURCEACCESSOR_H_
 
+#include "../Parallel.h"
 #include "../ReferenceCounter.h"
 #include "../StringIdentifier.h"
 #include "AttributeAccessor.h"
 #include "ResourceFormat.h"
+#include "ResourceLayout.h"
 
 #include <vector>
-#include <unordered_map>
+#include <atomic>
 #include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
 
 namespace Util {
 class Resource;
@@ -28,14 +35,26 @@ using ResourceRef = Util::Reference<Resource>;
 */
 class ResourceAccessor : public ReferenceCounter<ResourceAccessor> {
 protected:
-	UTILAPI void assertRangeLocation(uint64_t index, uint32_t location) const;
+	UTILAPI void assertRangeLocation(uint64_t index, uint32_t location, uint64_t count=1) const;
 	UTILAPI void assertAttribute(const StringIdentifier& id) const;
+	
+	//! Returns the accessor for the given location (or nullptr if there is none). Each attribute accessor is created on first use.
+	AttributeAccessor* getAccessor(uint32_t location) const {
+		AttributeAccessor* accessor = getAccessorSlot(location).load(std::memory_order_acquire);
+		return accessor ? accessor : createAccessor(location);
+	}
+
+	//! Marks the attribute of @p count elements as modified (if the resource tracks modified ranges).
+	void markDirty(uint64_t index, uint32_t location, uint64_t count) {
+		if(resource)
+			_markDirty(index, location, count);
+	}
 public:
 	using Ref = Util::Reference<ResourceAccessor>;
-	static Ref create(uint8_t* ptr, uint64_t size, ResourceFormat format) { return new ResourceAccessor(ptr, size, format); }
+	static Ref create(uint8_t* ptr, uint64_t size, const ResourceFormat& format) { return new ResourceAccessor(ptr, size, format); }
 	static Ref create(const ResourceRef& resource) { return new ResourceAccessor(resource); }
 
-	UTILAPI explicit ResourceAccessor(uint8_t* ptr, uint64_t size, ResourceFormat format);
+	UTILAPI explicit ResourceAccessor(uint8_t* ptr, uint64_t size, const ResourceFormat& format);
 	UTILAPI explicit ResourceAccessor(const ResourceRef& resource);
 	UTILAPI virtual ~ResourceAccessor();
 	
@@ -54,7 +73,7 @@ public:
 	template<typename T>
 	void readValues(uint64_t index, uint32_t location, T* values, uint64_t count) const {
 		assertRangeLocation(index, location);
-		accessors[location]->readValues(index, values, count);
+		getAccessor(location)->readValues(index, values, count);
 	}
 		
 	template<typename T> 
@@ -66,12 +85,12 @@ public:
 	
 	void readRawValue(uint64_t index, uint32_t location, uint8_t* data, uint64_t size) const {
 		assertRangeLocation(index, location);
-		accessors[location]->readRaw(index, data, size);
+		getAccessor(location)->readRaw(index, data, size);
 	}
 	
 	void readRawValue(uint64_t index, const StringIdentifier& id, uint8_t* data, uint64_t size) const {
 		assertAttribute(id);
-		readRawValue(index, locations.at(id), data, size);
+		readRawValue(index, layout->getAttributeLocation(id), data, size);
 	}
 	
 	template<typename T> 
@@ -84,31 +103,69 @@ public:
 	template<typename T>
 	void readValues(uint64_t index, const StringIdentifier& id, T* values, uint64_t count) const {
 		assertAttribute(id);
-		return readValues<T>(index, locations.at(id), values, count);
+		return readValues<T>(index, layout->getAttributeLocation(id), values, count);
 	}
 		
 	template<typename T> 
 	T readValue(uint64_t index, const StringIdentifier& id) const {
 		assertAttribute(id);
-		return readValue<T>(index, locations.at(id));
+		return readValue<T>(index, layout->getAttributeLocation(id));
 	}
 	
 	template<typename T> 
 	std::vector<T> readValues(uint64_t index, const StringIdentifier& id, uint64_t count) const {
 		assertAttribute(id);
-		return readValues<T>(index, locations.at(id), count);
+		return readValues<T>(index, layout->getAttributeLocation(id), count);
+	}
+	
+	/** Reads the values of an attribute for multiple consecutive elements
+		Reads the attribute at the given location of @p elementCount many elements, starting at element @p firstIndex.
+		The range is validated once for the whole batch.
+		@param valueStride Number of values between two consecutive elements in @p values (0 = number of components).
+		@see AttributeAccessor::readRange
+	*/
+	template<typename T>
+	void readRange(uint64_t firstIndex, uint32_t location, uint64_t elementCount, T* values, uint64_t valueStride=0) const {
+		assertRangeLocation(firstIndex, location, elementCount);
+		getAccessor(location)->readRange(firstIndex, elementCount, values, valueStride);
+	}
+	
+	template<typename T>
+	void readRange(uint64_t firstIndex, const StringIdentifier& id, uint64_t elementCount, T* values, uint64_t valueStride=0) const {
+		assertAttribute(id);
+		readRange<T>(firstIndex, layout->getAttributeLocation(id), elementCount, values, valueStride);
 	}
 	
 	template<typename T>
 	void writeValues(uint64_t index, uint32_t location, const T* values, uint64_t count) {
 		if(location >= format.getNumAttributes()) return; // ignore invalid locations
 		assertRangeLocation(index, location);
-		accessors[location]->writeValues(index, values, count);
+		getAccessor(location)->writeValues(index, values, count);
+		markDirty(index, location, 1);
 	}
 	
 	template<typename T>
 	void writeValues(uint64_t index, const StringIdentifier& id, const T* values, uint64_t count) {
-		writeValues(index, locations.find(id) != locations.end() ? locations.at(id) : format.getNumAttributes(), values, count);
+		writeValues(index, layout->getAttributeLocation(id), values, count);
+	}
+	
+	/** Writes the values of an attribute for multiple consecutive elements
+		Writes the attribute at the given location of @p elementCount many elements, starting at element @p firstIndex.
+		The range is validated once for the whole batch.
+		@param valueStride Number of values between two consecutive elements in @p values (0 = number of components).
+		@see AttributeAccessor::writeRange
+	*/
+	template<typename T>
+	void writeRange(uint64_t firstIndex, uint32_t location, uint64_t elementCount, const T* values, uint64_t valueStride=0) {
+		if(location >= format.getNumAttributes()) return; // ignore invalid locations
+		assertRangeLocation(firstIndex, location, elementCount);
+		getAccessor(location)->writeRange(firstIndex, elementCount, values, valueStride);
+		markDirty(firstIndex, location, elementCount);
+	}
+	
+	template<typename T>
+	void writeRange(uint64_t firstIndex, const StringIdentifier& id, uint64_t elementCount, const T* values, uint64_t valueStride=0) {
+		writeRange(firstIndex, layout->getAttributeLocation(id), elementCount, values, valueStride);
 	}
 	
 	template<typename T> 
@@ -118,16 +175,17 @@ public:
 	
 	template<typename T> 
 	void writeValue(uint64_t index, const StringIdentifier& id, const T& value) {
-		writeValues(index, locations.find(id) != locations.end() ? locations.at(id) : format.getNumAttributes(), &value, 1);
+		writeValues(index, layout->getAttributeLocation(id), &value, 1);
 	}
 	
 	void writeRawValue(uint64_t index, uint32_t location, const uint8_t* data, uint64_t size) {
 		if(location >= format.getNumAttributes()) return; // ignore invalid locations
-		accessors[location]->writeRaw(index, data, size);
+		getAccessor(location)->writeRaw(index, data, size);
+		markDirty(index, location, 1);
 	}
 	
 	void writeRawValue(uint64_t index, const StringIdentifier& id, const uint8_t* data, uint64_t size) {
-		writeRawValue(index, locations.find(id) != locations.end() ? locations.at(id) : format.getNumAttributes(), data, size);
+		writeRawValue(index, layout->getAttributeLocation(id), data, size);
 	}
 	
 	template<typename T> 
@@ -137,40 +195,154 @@ public:
 	
 	template<typename T> 
 	void writeValues(uint64_t index, const StringIdentifier& id, const std::vector<T>& values) {
-		writeValues(index, locations.find(id) != locations.end() ? locations.at(id) : format.getNumAttributes(), values.data(), values.size());
+		writeValues(index, layout->getAttributeLocation(id), values.data(), values.size());
 	}
 	
+	//! Per component bounds of an attribute (see @p computeBounds).
+	struct Bounds {
+		std::vector<double> min;
+		std::vector<double> max;
+	};
+
+	/** Reduces the values of an attribute over all elements
+		The elements are split into contiguous chunks, which are processed in parallel. Each chunk is read in blocks
+		and @p accumulate(T& result, const double* values, uint64_t count) folds each block of @p count elements into the
+		partial result of the chunk (@p values holds the values of the elements in the component layout of the attribute,
+		see @p getValueCount). Finally, the partial results are merged in order using @p combine(T& result, const T& partial).
+		@param identity The initial partial result of each chunk.
+		@param threadCount The maximum number of threads (0 = default).
+		@note The values are read as double, i.e., 64 bit integers above 2^53 are rounded.
+	*/
+	template<typename T, typename Accumulate, typename Combine>
+	T reduce(uint32_t location, const T& identity, const Accumulate& accumulate, const Combine& combine, uint32_t threadCount=0) const;
+
+	/** Returns the minimum and maximum of each component of an attribute over all elements (e.g., the bounding box of positions).
+		NaN values are ignored. Without elements, the minimum is +infinity and the maximum is -infinity.
+	*/
+	UTILAPI Bounds computeBounds(uint32_t location, uint32_t threadCount=0) const;
+	Bounds computeBounds(const StringIdentifier& id, uint32_t threadCount=0) const {
+		assertAttribute(id);
+		return computeBounds(layout->getAttributeLocation(id), threadCount);
+	}
+
+	//! Returns the minimum and maximum of a single component of an attribute over all elements.
+	UTILAPI std::pair<double,double> minMax(uint32_t location, uint32_t component=0, uint32_t threadCount=0) const;
+	std::pair<double,double> minMax(const StringIdentifier& id, uint32_t component=0, uint32_t threadCount=0) const {
+		assertAttribute(id);
+		return minMax(layout->getAttributeLocation(id), component, threadCount);
+	}
+
+	//! Returns the sum of each component of an attribute over all elements.
+	UTILAPI std::vector<double> sum(uint32_t location, uint32_t threadCount=0) const;
+	std::vector<double> sum(const StringIdentifier& id, uint32_t threadCount=0) const {
+		assertAttribute(id);
+		return sum(layout->getAttributeLocation(id), threadCount);
+	}
+
+	/** Counts the values of a single component of an attribute in @p bins equally sized bins covering [min, max].
+		Values outside of the range (and NaN values) are not counted.
+	*/
+	UTILAPI std::vector<uint64_t> histogram(uint32_t location, uint32_t bins, double min, double max, uint32_t component=0, uint32_t threadCount=0) const;
+	std::vector<uint64_t> histogram(const StringIdentifier& id, uint32_t bins, double min, double max, uint32_t component=0, uint32_t threadCount=0) const {
+		assertAttribute(id);
+		return histogram(layout->getAttributeLocation(id), bins, min, max, component, threadCount);
+	}
+
+	//! Counts the values of a single component of an attribute in @p bins equally sized bins covering the range of the values.
+	std::vector<uint64_t> histogramAuto(uint32_t location, uint32_t bins, uint32_t component=0, uint32_t threadCount=0) const {
+		const auto range = minMax(location, component, threadCount);
+		return histogram(location, bins, range.first, range.second, component, threadCount);
+	}
+	std::vector<uint64_t> histogramAuto(const StringIdentifier& id, uint32_t bins, uint32_t component=0, uint32_t threadCount=0) const {
+		assertAttribute(id);
+		return histogramAuto(layout->getAttributeLocation(id), bins, component, threadCount);
+	}
+
+	//! Returns the number of values per element of the attribute at the given location (see @p AttributeAccessor::getValueCount).
+	uint32_t getValueCount(uint32_t location) const {
+		assertRangeLocation(0, location, 0);
+		const auto accessor = getAccessor(location);
+		return accessor ? accessor->getValueCount() : format.getAttribute(location).getComponentCount();
+	}
+
 	const ResourceFormat& getFormat() const { return format; }
 	uint64_t getDataSize() const { return dataSize; }
 	uint64_t getElementCount() const { return elementCount; }
-	uint32_t getAttributeLocation(const StringIdentifier& id) const { return format.getAttributeLocation(id); }
+	uint32_t getAttributeLocation(const StringIdentifier& id) const { return layout->getAttributeLocation(id); }
+	const ResourceLayout::Ref& getLayout() const { return layout; }
+	
+	/*! Returns the raw data pointer to the element at the given index. 
+		\note Be careful: No boundary checks are performed! */
+	template<typename number_t=uint8_t>
+	number_t* _ptr(uint64_t index) const { return reinterpret_cast<number_t*>(dataPtr+index*format.getSize()); }
 private:
+	//! Number of attribute accessors that are stored inline; only formats with more attributes allocate additional slots.
+	static const uint32_t INLINE_ACCESSORS = 8;
+	using AccessorSlot_t = std::atomic<AttributeAccessor*>;
+
+	AccessorSlot_t& getAccessorSlot(uint32_t location) const {
+		return location < INLINE_ACCESSORS ? inlineAccessors[location] : additionalAccessors[location - INLINE_ACCESSORS];
+	}
+	UTILAPI AttributeAccessor* createAccessor(uint32_t location) const;
+	UTILAPI void _markDirty(uint64_t index, uint32_t location, uint64_t count);
+
 	ResourceRef resource;
-	const ResourceFormat format;
+	const ResourceLayout::Ref layout;
+	const ResourceFormat& format; //!< owned by the layout
 	uint8_t* const dataPtr;
 	const uint64_t dataSize;
 	const uint64_t elementCount;
-	std::unordered_map<StringIdentifier, uint32_t> locations;
-	std::vector<Reference<AttributeAccessor>> accessors;
+	mutable AccessorSlot_t inlineAccessors[INLINE_ACCESSORS]; //!< owning pointers, bound to dataPtr on first use
+	std::unique_ptr<AccessorSlot_t[]> additionalAccessors;
 };
 
 inline
-void ResourceAccessor::assertRangeLocation(uint64_t index, uint32_t location) const {
+void ResourceAccessor::assertRangeLocation(uint64_t index, uint32_t location, uint64_t count) const {
 	if(location >= format.getNumAttributes()) {
 		std::ostringstream s;
 		s << "Trying to access attribute at location " << location << " of overall " << format.getNumAttributes() << " attributes.";
 		throw std::range_error(s.str());
 	}
-	if(index >= elementCount) {
+	if(count > 0 && (index >= elementCount || count > elementCount - index)) {
 		std::ostringstream s;
-		s << "Trying to access element at index " << index << " of overall " << elementCount << " elements.";
+		if(count == 1)
+			s << "Trying to access element at index " << index << " of overall " << elementCount << " elements.";
+		else
+			s << "Trying to access elements at indices [" << index << ", " << (index+count) << ") of overall " << elementCount << " elements.";
 		throw std::range_error(s.str());
 	}
 }
 
+template<typename T, typename Accumulate, typename Combine>
+T ResourceAccessor::reduce(uint32_t location, const T& identity, const Accumulate& accumulate, const Combine& combine, uint32_t threadCount) const {
+	assertRangeLocation(0, location, 0);
+	const auto accessor = getAccessor(location);
+	if(!accessor)
+		throw std::invalid_argument("ResourceAccessor: Cannot read attribute '" + format.getAttribute(location).toString() + "'. There is no accessor.");
+	const uint64_t valueCount = std::max<uint64_t>(accessor->getValueCount(), 1);
+	const uint64_t blockSize = std::max<uint64_t>(1, 4096 / valueCount); // values per block should fit into the L1 cache
+	std::map<uint64_t, T> partials;
+	std::mutex partialsMutex;
+	parallelFor(0, elementCount, std::max<uint64_t>(blockSize, 64 * 1024), [&](uint64_t begin, uint64_t end) {
+		T result(identity);
+		std::vector<double> values(std::min(blockSize, end - begin) * valueCount);
+		for(uint64_t first = begin; first < end; first += blockSize) {
+			const uint64_t count = std::min(blockSize, end - first);
+			accessor->readRange(first, count, values.data(), valueCount);
+			accumulate(result, static_cast<const double*>(values.data()), count);
+		}
+		std::lock_guard<std::mutex> lock(partialsMutex);
+		partials.emplace(begin, std::move(result));
+	}, threadCount);
+	T result(identity);
+	for(const auto& partial : partials)
+		combine(result, partial.second);
+	return result;
+}
+
 inline
 void ResourceAccessor::assertAttribute(const StringIdentifier& id) const {
-	if(!format.hasAttribute(id)) {
+	if(!layout->hasAttribute(id)) {
 		std::ostringstream s;
 		s << "There is no attribute named '" << id.toString() << "'.";
 		throw std::range_error(s.str());
@@ -13,23 +13,72 @@
 #include "ResourceFormat.h"
 
 #include <memory>
+#include <limits>
 
 namespace Util {
 
-
+/** ResourceAllocator
+	Interface for sub-allocators that manage ranges within a single (externally owned) block of memory.
+	All offsets are relative to the beginning of the managed block.
+	@note Allocators are not thread-safe.
+	@ingroup resources
+*/
 class ResourceAllocator {
 public:
+	static constexpr uint64_t INVALID_HANDLE = std::numeric_limits<uint64_t>::max();
+
 	struct Allocation {
 		const uint64_t offset;
 		const uint64_t size;
 		const uint64_t handle;
+		//! Returns @p false if the allocation failed.
+		bool isValid() const { return handle != INVALID_HANDLE; }
+	};
+
+	struct Statistics {
+		uint64_t capacity = 0; //!< Overall size of the managed block
+		uint64_t usedSize = 0; //!< Size of all allocated blocks (including padding and internal rounding)
+		uint64_t requestedSize = 0; //!< Sum of the requested sizes of all live allocations
+		uint64_t peakUsedSize = 0; //!< Maximum of @p usedSize since the creation of the allocator
+		uint64_t allocationCount = 0; //!< Number of live allocations
+		uint64_t freeBlockCount = 0; //!< Number of free blocks
+		uint64_t largestFreeBlock = 0; //!< Size of the largest allocation that is guaranteed to succeed
+
+		uint64_t getFreeSize() const { return capacity - usedSize; }
+		//! Fraction of the free memory that can not be used for the largest possible allocation (0 = no fragmentation).
+		double getExternalFragmentation() const { return getFreeSize() > 0 ? 1.0 - static_cast<double>(largestFreeBlock) / getFreeSize() : 0.0; }
+		//! Fraction of the used memory that is wasted due to padding and rounding.
+		double getInternalFragmentation() const { return usedSize > 0 ? 1.0 - static_cast<double>(requestedSize) / usedSize : 0.0; }
 	};
 
-	virtual Allocation allocate(uint64_t size) = 0;
+	virtual ~ResourceAllocator() = default;
+
+	/**
+	 * Allocates a range of the given size.
+	 * @param size The size in bytes.
+	 * @param alignment The alignment of the offset in bytes (0 or 1 for no alignment).
+	 * @return The allocation, or an invalid allocation (see @p Allocation::isValid) if there is not enough space.
+	 */
+	virtual Allocation allocate(uint64_t size, uint64_t alignment=0) = 0;
+
+	//! Allocates a range for @p count elements of the given format, using the format's alignment.
 	virtual Allocation allocate(const Util::ResourceFormat& format, uint64_t count) {
-		return allocate(format.getSize()*count);
+		return allocate(format.getSize()*count, format.getAlignment());
 	}
+
+	//! Releases an allocation that has been created by this allocator.
 	virtual void free(Allocation&& allocation) = 0;
+
+	//! Returns the usage statistics of the allocator.
+	virtual Statistics getStatistics() const = 0;
+
+	//! Returns the overall size of the managed block.
+	uint64_t getCapacity() const { return capacity; }
+
+protected:
+	explicit ResourceAllocator(uint64_t _capacity) : capacity(_capacity) {}
+	static Allocation invalidAllocation() { return {0, 0, INVALID_HANDLE}; }
+	const uint64_t capacity;
 };
 
 } /* Util */
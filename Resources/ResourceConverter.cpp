@@ -0,0 +1,101 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ResourceConverter.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace Util {
+
+using FormatPair = std::pair<ResourceFormat, ResourceFormat>;
+
+struct FormatPairHash {
+	size_t operator()(const FormatPair& formats) const {
+		uint64_t result = std::hash<ResourceFormat>()(formats.first);
+		hash_combine(result, std::hash<ResourceFormat>()(formats.second));
+		return static_cast<size_t>(result);
+	}
+};
+
+struct ConverterCache {
+	std::mutex mutex;
+	std::unordered_map<FormatPair, ResourceConverter::Ref, FormatPairHash> converters;
+};
+
+static ConverterCache& getConverterCache() {
+	static ConverterCache cache;
+	return cache;
+}
+
+//-------------------
+
+ResourceConverter::Ref ResourceConverter::compile(const ResourceFormat& srcFormat, const ResourceFormat& tgtFormat) {
+	auto& cache = getConverterCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	FormatPair key(srcFormat, tgtFormat);
+	auto it = cache.converters.find(key);
+	if(it == cache.converters.end())
+		it = cache.converters.emplace(std::move(key), new ResourceConverter(srcFormat, tgtFormat)).first;
+	return it->second;
+}
+
+//-------------------
+
+ResourceConverter::Ref ResourceConverter::compile(const AttributeFormat& srcAttr, const AttributeFormat& tgtAttr) {
+	ResourceFormat srcFormat;
+	srcFormat.appendAttribute(srcAttr.getNameId(), srcAttr.getDataType(), srcAttr.getComponentCount(), srcAttr.isNormalized(), srcAttr.getInternalType());
+	ResourceFormat tgtFormat;
+	tgtFormat.appendAttribute(tgtAttr.getNameId(), tgtAttr.getDataType(), tgtAttr.getComponentCount(), tgtAttr.isNormalized(), tgtAttr.getInternalType());
+	return compile(srcFormat, tgtFormat);
+}
+
+//-------------------
+
+bool ResourceConverter::registerComponentOrder(uint32_t internalType, const std::vector<uint32_t>& order) {
+	ResourceLayoutConverter::setComponentOrder(internalType, order);
+	return true;
+}
+
+//-------------------
+
+void ResourceConverter::trimCache() {
+	auto& cache = getConverterCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	for(auto it = cache.converters.begin(); it != cache.converters.end();) {
+		if(it->second->countReferences() == 1)
+			it = cache.converters.erase(it);
+		else
+			++it;
+	}
+}
+
+//-------------------
+
+size_t ResourceConverter::getCacheSize() {
+	auto& cache = getConverterCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return cache.converters.size();
+}
+
+//-------------------
+
+ResourceConverter::ResourceConverter(const ResourceFormat& srcFormat, const ResourceFormat& tgtFormat) :
+		converter({srcFormat}, {tgtFormat}, true) {}
+
+//-------------------
+
+void ResourceConverter::convert(const uint8_t* srcData, uint8_t* tgtData, uint64_t count, uint32_t threadCount) const {
+	converter.convert(&srcData, &tgtData, count, threadCount);
+}
+
+//-------------------
+
+} /* Util */
@@ -0,0 +1,80 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_RESOURCECONVERTER_H_
+#define UTIL_RESOURCES_RESOURCECONVERTER_H_
+
+#include "ResourceFormat.h"
+#include "ResourceLayoutConverter.h"
+#include "../ReferenceCounter.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Util {
+
+/** ResourceConverter
+	Precompiled plan for converting elements of one ResourceFormat into another.
+
+	The plan is compiled once for each pair of formats and cached. For each attribute of the target format,
+	the attribute of the source format with the same name is used (if both formats consist of a single attribute,
+	the attributes are matched regardless of their names, e.g., for pixel formats).
+	The conversion is done by a single-stream ResourceLayoutConverter, which chooses a copy, swizzle, shuffle,
+	(un)normalize or generic conversion kernel for each attribute (see ResourceLayoutConverter).
+
+	Target attributes without a matching source attribute are left untouched.
+	@ingroup resources
+*/
+class ResourceConverter : public ReferenceCounter<ResourceConverter> {
+public:
+	using Ref = Reference<ResourceConverter>;
+
+	/**
+	 * Returns the (cached) conversion plan between the given formats.
+	 * @note This function is thread-safe.
+	 */
+	UTILAPI static Ref compile(const ResourceFormat& srcFormat, const ResourceFormat& tgtFormat);
+
+	//! Returns the (cached) conversion plan between two single-attribute formats.
+	UTILAPI static Ref compile(const AttributeFormat& srcAttr, const AttributeFormat& tgtAttr);
+
+	/**
+	 * Registers the order in which the components of attributes with the given internal type are stored.
+	 * Stored component @p i corresponds to the logical component @p order[i] (e.g., {2,1,0,3} for BGRA).
+	 * Attributes with fewer components use the order only if it is a valid permutation of their components.
+	 * @note Should be called before compiling any conversion (e.g., during static initialization).
+	 */
+	UTILAPI static bool registerComponentOrder(uint32_t internalType, const std::vector<uint32_t>& order);
+
+	//! Removes all plans from the cache that are not referenced anymore.
+	UTILAPI static void trimCache();
+
+	//! Returns the number of plans in the cache.
+	UTILAPI static size_t getCacheSize();
+
+	/**
+	 * Converts @p count consecutive elements.
+	 * @param threadCount The maximum number of threads (0 = default). Small conversions are always done by the calling thread.
+	 * @note The source and target data may not overlap.
+	 */
+	UTILAPI void convert(const uint8_t* srcData, uint8_t* tgtData, uint64_t count, uint32_t threadCount=0) const;
+
+	const ResourceFormat& getSourceFormat() const { return converter.getSourceStreams().front(); }
+	const ResourceFormat& getTargetFormat() const { return converter.getTargetStreams().front(); }
+
+	//! Returns @p true if the conversion consists only of plain copies.
+	bool isCopyOnly() const { return converter.isCopyOnly(); }
+private:
+	ResourceConverter(const ResourceFormat& srcFormat, const ResourceFormat& tgtFormat);
+
+	const ResourceLayoutConverter converter;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_RESOURCECONVERTER_H_ */
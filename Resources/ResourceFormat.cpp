@@ -12,6 +12,8 @@
 
 #include "ResourceFormat.h"
 
+#include <algorithm>
+#include <numeric>
 #include <sstream>
 
 namespace Util {
@@ -110,6 +112,58 @@ void ResourceFormat::merge(const ResourceFormat& other) {
 
 //------------------
 
+static TypeConstant getNarrowedType(const AttributeFormat& attr, uint8_t narrowing) {
+	const TypeConstant type = attr.getDataType();
+	if(attr.getInternalType() != 0)
+		return type;
+	if(type == TypeConstant::DOUBLE && (narrowing & ResourceFormat::NARROW_DOUBLE_TO_FLOAT))
+		return (narrowing & ResourceFormat::NARROW_FLOAT_TO_HALF) && !attr.isNormalized() ? TypeConstant::HALF : TypeConstant::FLOAT;
+	if(type == TypeConstant::FLOAT && !attr.isNormalized() && (narrowing & ResourceFormat::NARROW_FLOAT_TO_HALF))
+		return TypeConstant::HALF;
+	if(attr.isNormalized() && (narrowing & ResourceFormat::NARROW_NORMALIZED_TO_8BIT)) {
+		switch(type) {
+			case TypeConstant::UINT16:
+			case TypeConstant::UINT32:
+				return TypeConstant::UINT8;
+			case TypeConstant::INT16:
+			case TypeConstant::INT32:
+				return TypeConstant::INT8;
+			default: break;
+		}
+	}
+	return type;
+}
+
+//------------------
+
+ResourceFormat::OptimizedLayout ResourceFormat::optimized(uint8_t narrowing) const {
+	std::vector<TypeConstant> types;
+	for(const auto& attr : attributes)
+		types.emplace_back(getNarrowedType(attr, narrowing));
+
+	// Sizes of attributes are multiples of their component sizes, so sorting by decreasing component size
+	// keeps every attribute naturally aligned without padding.
+	std::vector<uint32_t> order(attributes.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		return getNumBytes(types[a]) > getNumBytes(types[b]);
+	});
+
+	OptimizedLayout result{ResourceFormat(attributeAlignment), std::vector<uint32_t>(attributes.size())};
+	uint64_t offset = 0;
+	for(uint32_t location : order) {
+		const auto& attr = attributes[location];
+		offset = align(offset, attributeAlignment);
+		result.locations[location] = result.format.getNumAttributes();
+		const auto& newAttr = result.format._appendAttribute(attr.getNameId(), types[location], attr.getComponentCount(), attr.isNormalized(), attr.getInternalType(), offset);
+		offset += newAttr.getDataSize();
+	}
+	result.format.setSize(align(offset, attributeAlignment));
+	return result;
+}
+
+//------------------
+
 bool ResourceFormat::operator==(const ResourceFormat& other) const {
 	return size == other.size && attributeAlignment == other.attributeAlignment && attributes == other.attributes;
 }
@@ -18,6 +18,7 @@
 #include "../Utils.h"
 
 #include <deque>
+#include <vector>
 
 namespace Util {
 	
@@ -118,6 +119,31 @@ public:
 
 	uint64_t getAlignment() const { return attributeAlignment; }
 
+	//! Flags for narrowing attribute types in @p optimized (attributes with an internal type are never narrowed).
+	enum Narrowing : uint8_t {
+		NARROW_NONE = 0,
+		NARROW_DOUBLE_TO_FLOAT = 1 << 0,		//!< DOUBLE -> FLOAT
+		NARROW_FLOAT_TO_HALF = 1 << 1,			//!< (non-normalized) FLOAT -> HALF
+		NARROW_NORMALIZED_TO_8BIT = 1 << 2,		//!< normalized 16 and 32 bit integers -> 8 bit integers of the same signedness
+	};
+
+	//! Result of @p optimized.
+	struct OptimizedLayout;
+
+	/**
+	 * Returns a format with the same attributes that has the smallest possible stride.
+	 *
+	 * Attributes are sorted by decreasing component size (and by location for equal sizes) and packed without gaps,
+	 * so each attribute is naturally aligned within the element and unused bytes between attributes (e.g., from merged formats
+	 * or manually set offsets and sizes) are removed. The attribute alignment is kept, i.e., with an alignment each attribute starts
+	 * at a multiple of it and the stride is a multiple of it.
+	 * Optionally, the attribute types are narrowed (see @p Narrowing).
+	 *
+	 * The data can be converted to the new format with a ResourceLayoutConverter (attributes are matched by name).
+	 * @param narrowing Combination of @p Narrowing flags.
+	 */
+	UTILAPI OptimizedLayout optimized(uint8_t narrowing=NARROW_NONE) const;
+
 	UTILAPI std::string toString(bool formatted=false) const;
 	UTILAPI bool operator==(const ResourceFormat& other) const;
 	UTILAPI bool operator!=(const ResourceFormat& other) const;
@@ -128,6 +154,12 @@ private:
 	uint64_t attributeAlignment;
 };
 
+struct ResourceFormat::OptimizedLayout {
+	ResourceFormat format;
+	//! The new location of each attribute of the original format.
+	std::vector<uint32_t> locations;
+};
+
 } /* Util */
 
 
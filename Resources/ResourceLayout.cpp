@@ -0,0 +1,83 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ResourceLayout.h"
+
+#include <mutex>
+
+namespace Util {
+
+//-------------------
+
+struct LayoutCache {
+	std::mutex mutex;
+	std::unordered_map<ResourceFormat, ResourceLayout::Ref> layouts;
+};
+
+static LayoutCache& getLayoutCache() {
+	static LayoutCache cache;
+	return cache;
+}
+
+//-------------------
+
+ResourceLayout::ResourceLayout(const ResourceFormat& _format) : format(_format) {
+	const auto& attributes = format.getAttributes();
+	locations.reserve(attributes.size());
+	factories.reserve(attributes.size());
+	for(uint32_t i=0; i<attributes.size(); ++i) {
+		locations.emplace(attributes[i].getNameId(), i); // the first attribute with a name wins (same as ResourceFormat::getAttributeLocation)
+		factories.emplace_back(AttributeAccessor::getAccessorFactory(attributes[i]));
+	}
+}
+
+//-------------------
+
+//! The layout that was returned last on this thread; consecutive accessors mostly share their format.
+static thread_local ResourceLayout::Ref lastLayout;
+
+ResourceLayout::Ref ResourceLayout::get(const ResourceFormat& format) {
+	if(lastLayout && lastLayout->getFormat() == format)
+		return lastLayout;
+	auto& cache = getLayoutCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	auto it = cache.layouts.find(format);
+	if(it == cache.layouts.end())
+		it = cache.layouts.emplace(format, new ResourceLayout(format)).first;
+	lastLayout = it->second;
+	return it->second;
+}
+
+//-------------------
+
+void ResourceLayout::trimCache() {
+	lastLayout = nullptr;
+	auto& cache = getLayoutCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	// a layout that is still referenced anywhere (including the last layout of another thread) stays in the cache,
+	// so no thread can hold a layout that was removed and layouts stay unique
+	for(auto it = cache.layouts.begin(); it != cache.layouts.end();) {
+		if(it->second->countReferences() == 1)
+			it = cache.layouts.erase(it);
+		else
+			++it;
+	}
+}
+
+//-------------------
+
+size_t ResourceLayout::getCacheSize() {
+	auto& cache = getLayoutCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return cache.layouts.size();
+}
+
+//-------------------
+
+} /* Util */
@@ -0,0 +1,86 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_RESOURCELAYOUT_H_
+#define UTIL_RESOURCES_RESOURCELAYOUT_H_
+
+#include "AttributeAccessor.h"
+#include "ResourceFormat.h"
+#include "../ReferenceCounter.h"
+#include "../StringIdentifier.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Util {
+
+/** ResourceLayout
+	Immutable lookup table for a ResourceFormat.
+
+	Layouts are interned: All equal resource formats share a single layout, which contains
+	a hashed name to location lookup table and the resolved accessor factories of all attributes.
+	Obtaining the layout of a known format requires no allocation. ResourceAccessor binds the
+	factories of a layout to its data lazily, one attribute at a time.
+	@ingroup resources
+*/
+class ResourceLayout : public ReferenceCounter<ResourceLayout> {
+public:
+	using Ref = Reference<ResourceLayout>;
+
+	/**
+	 * Returns the shared layout for the given format.
+	 * Each thread remembers the layout it obtained last, so repeated lookups of the same format
+	 * neither hash the format nor lock the global cache.
+	 * @note This function is thread-safe.
+	 */
+	UTILAPI static Ref get(const ResourceFormat& format);
+
+	/**
+	 * Removes all layouts from the cache that are not referenced anymore.
+	 * Layouts that are still referenced stay in the cache, so equal formats keep sharing a single layout and
+	 * layouts can still be compared by identity after trimming.
+	 * @note The layout that another thread obtained last is still referenced by that thread. It is released
+	 *	when that thread looks up a different format or exits.
+	 * @note This function is thread-safe.
+	 */
+	UTILAPI static void trimCache();
+
+	//! Returns the number of layouts in the cache.
+	UTILAPI static size_t getCacheSize();
+
+	const ResourceFormat& getFormat() const { return format; }
+	uint32_t getNumAttributes() const { return format.getNumAttributes(); }
+
+	//! Returns the location of the attribute with the given name, or the number of attributes if there is no such attribute.
+	uint32_t getAttributeLocation(const StringIdentifier& nameId) const {
+		const auto it = locations.find(nameId);
+		return it != locations.end() ? it->second : format.getNumAttributes();
+	}
+
+	bool hasAttribute(const StringIdentifier& nameId) const { return locations.count(nameId) > 0; }
+
+	//! Returns the factory that creates accessors for the attribute at the given location (might be empty).
+	const AttributeAccessor::AccessorFactory_t& getAccessorFactory(uint32_t location) const { return factories.at(location); }
+
+	//! Creates an accessor for the attribute at the given location.
+	Reference<AttributeAccessor> createAccessor(uint32_t location, uint8_t* ptr, uint64_t size) const {
+		const auto& factory = factories.at(location);
+		return factory ? factory(ptr, size, format.getAttribute(location), format.getSize()) : nullptr;
+	}
+
+private:
+	explicit ResourceLayout(const ResourceFormat& format);
+
+	const ResourceFormat format;
+	std::unordered_map<StringIdentifier, uint32_t> locations;
+	std::vector<AttributeAccessor::AccessorFactory_t> factories;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_RESOURCELAYOUT_H_ */
@@ -0,0 +1,372 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ResourceLayoutConverter.h"
+#include "AttributeConversion.h"
+#include "../Macros.h"
+#include "../Parallel.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace Util {
+
+static const uint64_t BLOCK_BYTES = 64 * 1024; // data per block (source and target); should fit into the L2 cache
+static const uint64_t MIN_BLOCK_SIZE = 64;
+static const uint64_t MIN_PARALLEL_BYTES = 1024 * 1024; // minimum amount of data per thread
+
+//-------------------
+
+using ComponentOrders_t = std::unordered_map<uint32_t, std::vector<uint32_t>>;
+
+struct ComponentOrderRegistry {
+	std::mutex mutex;
+	ComponentOrders_t orders;
+};
+
+static ComponentOrderRegistry& getComponentOrderRegistry() {
+	static ComponentOrderRegistry registry;
+	return registry;
+}
+
+void ResourceLayoutConverter::setComponentOrder(uint32_t internalType, const std::vector<uint32_t>& order) {
+	auto& registry = getComponentOrderRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.orders[internalType] = order;
+}
+
+//-------------------
+
+//! Returns the logical component of each stored component of the attribute.
+static std::vector<uint32_t> getComponentOrder(const AttributeFormat& attr, const ComponentOrders_t& componentOrders) {
+	const uint32_t count = attr.getComponentCount();
+	std::vector<uint32_t> order(count);
+	for(uint32_t i=0; i<count; ++i)
+		order[i] = i;
+	if(attr.getInternalType() == 0)
+		return order;
+	const auto it = componentOrders.find(attr.getInternalType());
+	if(it == componentOrders.end() || it->second.size() < count)
+		return {};
+	std::vector<uint32_t> registered(it->second.begin(), it->second.begin() + count);
+	std::vector<uint32_t> sorted(registered);
+	std::sort(sorted.begin(), sorted.end());
+	return sorted == order ? registered : order; // fall back to the identity if the order is no permutation of the components
+}
+
+/**
+ * Creates the byte pattern for converting the 8 bit components of @p srcAttr (starting at byte @p srcOffset) into the components of @p tgtAttr.
+ * As in the generic conversion, the components are matched by their logical order; missing components are set to 0, except for the fourth one,
+ * which is set to @p one. Returns false if the component order of one of the attributes is unknown.
+ */
+static bool createShufflePattern(const AttributeFormat& srcAttr, uint64_t srcOffset, const AttributeFormat& tgtAttr, uint8_t one,
+		const ComponentOrders_t& componentOrders, std::vector<int8_t>& pattern, std::vector<uint8_t>& fill) {
+	const auto srcOrder = getComponentOrder(srcAttr, componentOrders);
+	const auto tgtOrder = getComponentOrder(tgtAttr, componentOrders);
+	if(srcOrder.empty() || tgtOrder.empty() || srcOffset + srcOrder.size() > 127)
+		return false;
+	std::vector<uint32_t> inverse(srcOrder.size());
+	for(uint32_t i=0; i<srcOrder.size(); ++i)
+		inverse[srcOrder[i]] = i;
+	pattern.assign(tgtOrder.size(), -1);
+	fill.assign(tgtOrder.size(), 0);
+	for(uint32_t i=0; i<tgtOrder.size(); ++i) {
+		if(tgtOrder[i] < inverse.size())
+			pattern[i] = static_cast<int8_t>(srcOffset + inverse[tgtOrder[i]]);
+		else if(tgtOrder[i] == 3)
+			fill[i] = one;
+	}
+	return true;
+}
+
+//! Returns true if the pattern copies all @p size bytes of an element unchanged.
+static bool isIdentityPattern(const std::vector<int8_t>& pattern, uint64_t size) {
+	if(pattern.size() != size)
+		return false;
+	for(uint32_t i=0; i<pattern.size(); ++i)
+		if(pattern[i] != static_cast<int8_t>(i))
+			return false;
+	return true;
+}
+
+//-------------------
+
+ResourceLayoutConverter::ResourceLayoutConverter(const ResourceFormat& srcFormat, const ResourceFormat& tgtFormat) :
+		srcStreams({srcFormat}), tgtStreams({tgtFormat}) {
+	buildPlan(false);
+}
+
+//-------------------
+
+ResourceLayoutConverter::ResourceLayoutConverter(const StreamFormats_t& _srcStreams, const StreamFormats_t& _tgtStreams) :
+		srcStreams(_srcStreams), tgtStreams(_tgtStreams) {
+	buildPlan(false);
+}
+
+//-------------------
+
+ResourceLayoutConverter::ResourceLayoutConverter(const StreamFormats_t& _srcStreams, const StreamFormats_t& _tgtStreams, bool matchSingleAttributes) :
+		srcStreams(_srcStreams), tgtStreams(_tgtStreams) {
+	buildPlan(matchSingleAttributes);
+}
+
+//-------------------
+
+void ResourceLayoutConverter::buildPlan(bool matchSingleAttributes) {
+	std::lock_guard<std::mutex> lock(getComponentOrderRegistry().mutex);
+	const bool matchByName = !matchSingleAttributes || srcStreams.size() != 1 || tgtStreams.size() != 1
+		|| srcStreams[0].getNumAttributes() != 1 || tgtStreams[0].getNumAttributes() != 1;
+	std::vector<Operation> copies;
+	for(uint32_t t=0; t<tgtStreams.size(); ++t) {
+		for(const auto& tgtAttr : tgtStreams[t].getAttributes()) {
+			if(!matchByName) {
+				addOperation(0, srcStreams[0].getAttribute(0u), t, tgtAttr, copies);
+				continue;
+			}
+			uint32_t s = 0;
+			while(s < srcStreams.size() && !srcStreams[s].hasAttribute(tgtAttr.getNameId()))
+				++s;
+			if(s < srcStreams.size())
+				addOperation(s, srcStreams[s].getAttribute(tgtAttr.getNameId()), t, tgtAttr, copies);
+		}
+	}
+
+	// combine copies of adjacent attributes
+	std::sort(copies.begin(), copies.end(), [](const Operation& a, const Operation& b) {
+		return std::tie(a.srcStream, a.tgtStream, a.tgtOffset) < std::tie(b.srcStream, b.tgtStream, b.tgtOffset);
+	});
+	std::vector<Operation> combined;
+	for(auto& op : copies) {
+		if(!combined.empty()) {
+			auto& prev = combined.back();
+			if(prev.srcStream == op.srcStream && prev.tgtStream == op.tgtStream
+					&& prev.srcOffset + prev.size == op.srcOffset && prev.tgtOffset + prev.size == op.tgtOffset) {
+				prev.size += op.size;
+				continue;
+			}
+		}
+		combined.emplace_back(std::move(op));
+	}
+	operations.insert(operations.begin(), combined.begin(), combined.end());
+
+	bytesPerElement = 0;
+	for(const auto& format : srcStreams)
+		bytesPerElement += format.getSize();
+	for(const auto& format : tgtStreams)
+		bytesPerElement += format.getSize();
+	blockSize = std::max(MIN_BLOCK_SIZE, BLOCK_BYTES / std::max<uint64_t>(bytesPerElement, 1));
+}
+
+//-------------------
+
+void ResourceLayoutConverter::addOperation(uint32_t s, const AttributeFormat& srcAttr, uint32_t t, const AttributeFormat& tgtAttr, std::vector<Operation>& copies) {
+	Operation op{Kernel::Copy, s, t, srcAttr.getOffset(), tgtAttr.getOffset(), 0, {}, srcAttr, tgtAttr, nullptr, nullptr, TypeConstant::FLOAT, {}, {}};
+	const bool sameType = srcAttr.getDataType() == tgtAttr.getDataType() && srcAttr.getComponentCount() == tgtAttr.getComponentCount()
+		&& srcAttr.isNormalized() == tgtAttr.isNormalized();
+	if(sameType && srcAttr.getInternalType() == tgtAttr.getInternalType()) {
+		op.size = srcAttr.getDataSize();
+		copies.emplace_back(std::move(op));
+		return;
+	}
+	const auto& componentOrders = getComponentOrderRegistry().orders; // locked by buildPlan
+	// 8 bit fast paths
+	const bool srcIsElement = srcAttr.getOffset() == 0 && srcAttr.getDataSize() == srcStreams[s].getSize();
+	const bool tgtIsElement = tgtAttr.getOffset() == 0 && tgtAttr.getDataSize() == tgtStreams[t].getSize();
+	const bool srcIsUnorm8 = srcAttr.getDataType() == TypeConstant::UINT8 && srcAttr.isNormalized();
+	const bool tgtIsUnorm8 = tgtAttr.getDataType() == TypeConstant::UINT8 && tgtAttr.isNormalized();
+	const bool srcIsFloat = srcAttr.getDataType() == TypeConstant::FLOAT && !srcAttr.isNormalized();
+	const bool tgtIsFloat = tgtAttr.getDataType() == TypeConstant::FLOAT && !tgtAttr.isNormalized();
+	if(tgtIsElement && srcAttr.getDataType() == tgtAttr.getDataType() && srcAttr.isNormalized() == tgtAttr.isNormalized()
+			&& (srcAttr.getDataType() == TypeConstant::UINT8 || srcAttr.getDataType() == TypeConstant::INT8)) {
+		const uint8_t one = !srcAttr.isNormalized() ? 1 : (srcAttr.getDataType() == TypeConstant::UINT8 ? 255 : 127);
+		if(createShufflePattern(srcAttr, srcAttr.getOffset(), tgtAttr, one, componentOrders, op.pattern, op.fill)) {
+			op.kernel = Kernel::Shuffle;
+			operations.emplace_back(std::move(op));
+			return;
+		}
+	}
+	if(tgtIsElement && srcIsUnorm8 && tgtIsFloat && createShufflePattern(srcAttr, srcAttr.getOffset(), tgtAttr, 255, componentOrders, op.pattern, op.fill)) {
+		op.kernel = Kernel::Normalize;
+		if(srcIsElement && isIdentityPattern(op.pattern, srcAttr.getDataSize()))
+			op.pattern.clear();
+		operations.emplace_back(std::move(op));
+		return;
+	}
+	if(tgtIsElement && srcIsElement && srcIsFloat && tgtIsUnorm8 && createShufflePattern(srcAttr, 0, tgtAttr, 255, componentOrders, op.pattern, op.fill)) {
+		op.kernel = Kernel::Unnormalize;
+		if(isIdentityPattern(op.pattern, srcAttr.getComponentCount()))
+			op.pattern.clear();
+		operations.emplace_back(std::move(op));
+		return;
+	}
+	if(sameType) {
+		const auto srcOrder = getComponentOrder(srcAttr, componentOrders);
+		const auto tgtOrder = getComponentOrder(tgtAttr, componentOrders);
+		if(!srcOrder.empty() && !tgtOrder.empty()) {
+			// target component i holds the logical component tgtOrder[i], which is stored in the source at position inv(srcOrder)[tgtOrder[i]]
+			std::vector<uint32_t> inverse(srcOrder.size());
+			for(uint32_t i=0; i<srcOrder.size(); ++i)
+				inverse[srcOrder[i]] = i;
+			op.kernel = Kernel::Swizzle;
+			op.size = getNumBytes(srcAttr.getDataType());
+			for(uint32_t i=0; i<tgtOrder.size(); ++i)
+				op.order.emplace_back(inverse[tgtOrder[i]]);
+			operations.emplace_back(std::move(op));
+			return;
+		}
+	}
+	op.kernel = Kernel::Convert;
+	op.srcFactory = AttributeAccessor::getAccessorFactory(srcAttr);
+	op.tgtFactory = AttributeAccessor::getAccessorFactory(tgtAttr);
+	if(!op.srcFactory || !op.tgtFactory) {
+		WARN("ResourceLayoutConverter: Cannot convert attribute '" + srcAttr.toString() + "' to '" + tgtAttr.toString() + "'. There is no accessor.");
+		return;
+	}
+	op.intermediateType = AttributeConversion::getIntermediateType(srcAttr, tgtAttr);
+	operations.emplace_back(std::move(op));
+}
+
+//-------------------
+
+ResourceLayoutConverter::StreamFormats_t ResourceLayoutConverter::createPlanarFormats(const ResourceFormat& format) {
+	StreamFormats_t streams;
+	for(const auto& attr : format.getAttributes()) {
+		streams.emplace_back();
+		streams.back().appendAttribute(attr.getNameId(), attr.getDataType(), attr.getComponentCount(), attr.isNormalized(), attr.getInternalType());
+	}
+	return streams;
+}
+
+//-------------------
+
+ResourceFormat ResourceLayoutConverter::createInterleavedFormat(const StreamFormats_t& streams, uint64_t attributeAlignment) {
+	ResourceFormat format(attributeAlignment);
+	for(const auto& stream : streams)
+		for(const auto& attr : stream.getAttributes())
+			format.appendAttribute(attr.getNameId(), attr.getDataType(), attr.getComponentCount(), attr.isNormalized(), attr.getInternalType());
+	return format;
+}
+
+//-------------------
+
+uint64_t ResourceLayoutConverter::getStreamOffset(const StreamFormats_t& streams, uint32_t streamIndex, uint64_t count) {
+	if(streamIndex > streams.size())
+		throw std::range_error("ResourceLayoutConverter: Invalid stream index " + std::to_string(streamIndex) + ".");
+	uint64_t offset = 0;
+	for(uint32_t i=0; i<streamIndex; ++i)
+		offset += streams[i].getSize() * count;
+	return offset;
+}
+
+//-------------------
+
+bool ResourceLayoutConverter::isCopyOnly() const {
+	return std::all_of(operations.begin(), operations.end(), [](const Operation& op) { return op.kernel == Kernel::Copy; });
+}
+
+//-------------------
+
+void ResourceLayoutConverter::convert(const std::vector<const uint8_t*>& srcData, const std::vector<uint8_t*>& tgtData, uint64_t count, uint32_t threadCount) const {
+	if(srcData.size() != srcStreams.size() || tgtData.size() != tgtStreams.size())
+		throw std::invalid_argument("ResourceLayoutConverter: The number of data pointers does not match the number of streams.");
+	convert(srcData.data(), tgtData.data(), count, threadCount);
+}
+
+//-------------------
+
+void ResourceLayoutConverter::convert(const uint8_t* const* srcData, uint8_t* const* tgtData, uint64_t count, uint32_t threadCount) const {
+	if(count == 0)
+		return;
+
+	// accessors for the conversions are created once for the whole range
+	std::vector<std::pair<AttributeAccessor::Ref, AttributeAccessor::Ref>> accessors(operations.size());
+	for(uint32_t i=0; i<operations.size(); ++i) {
+		const auto& op = operations[i];
+		if(op.kernel != Kernel::Convert)
+			continue;
+		const uint64_t srcStride = srcStreams[op.srcStream].getSize();
+		const uint64_t tgtStride = tgtStreams[op.tgtStream].getSize();
+		accessors[i].first = op.srcFactory(const_cast<uint8_t*>(srcData[op.srcStream]), srcStride * count, op.srcAttr, srcStride);
+		accessors[i].second = op.tgtFactory(tgtData[op.tgtStream], tgtStride * count, op.tgtAttr, tgtStride);
+	}
+
+	const auto convertChunk = [&](uint64_t chunkBegin, uint64_t chunkEnd) {
+		std::vector<uint64_t> buffer;
+		std::vector<uint8_t> bytes;
+		for(uint64_t first = chunkBegin; first < chunkEnd; first += blockSize) {
+			const uint64_t blockCount = std::min(blockSize, chunkEnd - first);
+			for(uint32_t i=0; i<operations.size(); ++i) {
+				const auto& op = operations[i];
+				const uint64_t srcStride = srcStreams[op.srcStream].getSize();
+				const uint64_t tgtStride = tgtStreams[op.tgtStream].getSize();
+				const uint8_t* src = srcData[op.srcStream] + first * srcStride;
+				uint8_t* tgt = tgtData[op.tgtStream] + first * tgtStride;
+				switch(op.kernel) {
+					case Kernel::Copy:
+						AttributeConversion::copyStrided(src + op.srcOffset, srcStride, tgt + op.tgtOffset, tgtStride, blockCount, op.size);
+						break;
+					case Kernel::Swizzle:
+						AttributeConversion::swizzleStrided(src + op.srcOffset, srcStride, tgt + op.tgtOffset, tgtStride, blockCount,
+							static_cast<uint32_t>(op.size), op.order.data(), static_cast<uint32_t>(op.order.size()));
+						break;
+					case Kernel::Shuffle:
+						AttributeConversion::shuffleBytes(src, static_cast<uint32_t>(srcStride), tgt, static_cast<uint32_t>(tgtStride), blockCount, op.pattern.data(), op.fill.data());
+						break;
+					case Kernel::Normalize: {
+						const uint32_t components = op.tgtAttr.getComponentCount();
+						const uint8_t* values = src;
+						if(!op.pattern.empty()) {
+							bytes.resize(blockCount * components);
+							AttributeConversion::shuffleBytes(src, static_cast<uint32_t>(srcStride), bytes.data(), components, blockCount, op.pattern.data(), op.fill.data());
+							values = bytes.data();
+						}
+						AttributeConversion::normalizeUnsigned(values, reinterpret_cast<float*>(tgt), blockCount * components);
+						break;
+					}
+					case Kernel::Unnormalize: {
+						const uint32_t components = op.srcAttr.getComponentCount();
+						const float* values = reinterpret_cast<const float*>(src);
+						if(op.pattern.empty()) {
+							AttributeConversion::unnormalizeUnsigned(values, tgt, blockCount * components);
+						} else {
+							bytes.resize(blockCount * components);
+							AttributeConversion::unnormalizeUnsigned(values, bytes.data(), blockCount * components);
+							AttributeConversion::shuffleBytes(bytes.data(), components, tgt, static_cast<uint32_t>(tgtStride), blockCount, op.pattern.data(), op.fill.data());
+						}
+						break;
+					}
+					case Kernel::Convert:
+						AttributeConversion::convertRange(*accessors[i].first.get(), *accessors[i].second.get(), first, blockCount, op.intermediateType, buffer);
+						break;
+				}
+			}
+		}
+	};
+	const uint64_t grainSize = std::max(blockSize, MIN_PARALLEL_BYTES / std::max<uint64_t>(bytesPerElement, 1));
+	parallelFor(0, count, grainSize, convertChunk, threadCount);
+}
+
+//-------------------
+
+void ResourceLayoutConverter::convert(const uint8_t* srcData, uint8_t* tgtData, uint64_t count, uint32_t threadCount) const {
+	std::vector<const uint8_t*> srcPtrs;
+	for(uint32_t i=0; i<srcStreams.size(); ++i)
+		srcPtrs.emplace_back(srcData + getStreamOffset(srcStreams, i, count));
+	std::vector<uint8_t*> tgtPtrs;
+	for(uint32_t i=0; i<tgtStreams.size(); ++i)
+		tgtPtrs.emplace_back(tgtData + getStreamOffset(tgtStreams, i, count));
+	convert(srcPtrs, tgtPtrs, count, threadCount);
+}
+
+//-------------------
+
+} /* Util */
@@ -0,0 +1,125 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_RESOURCELAYOUTCONVERTER_H_
+#define UTIL_RESOURCES_RESOURCELAYOUTCONVERTER_H_
+
+#include "AttributeAccessor.h"
+#include "ResourceFormat.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Util {
+
+/** ResourceLayoutConverter
+	Converts resource data between different memory layouts, e.g., from an interleaved layout (array of structures)
+	to a planar layout with one stream per attribute (structure of arrays) and vice versa.
+
+	The source and target layouts are each described by a list of streams, where each stream has its own ResourceFormat.
+	Attributes are matched by name. A conversion plan is built once on construction. Depending on the attributes,
+	one of the following kernels is chosen for each target attribute:
+	- copy: Both attributes have the same representation. Copies of adjacent attributes are combined.
+	- swizzle: Both attributes only differ in the order of their components (see @p ResourceConverter::registerComponentOrder).
+	- shuffle: Both attributes have 8 bit components of the same type, which are reordered, dropped or expanded
+	  with byte shuffles (e.g., RGBA -> BGRA, RGB -> RGBA or RGBA -> MONO). The target attribute has to span the whole element.
+	- normalize/unnormalize: Normalized UINT8 values are converted from or to FLOAT values with the vectorized kernels
+	  (e.g., RGBA -> RGBA_FLOAT), combined with a byte shuffle if the components differ.
+	  The FLOAT attribute and the target attribute have to span the whole element of their streams.
+	- convert: The values are converted through the attribute accessors. Missing components are set to (0,0,0,1).
+
+	The shuffle and (un)normalize kernels produce the same results as the generic conversion through the attribute accessors.
+	Target attributes without a matching source attribute are left untouched.
+
+	The data is processed in cache sized blocks, so all attributes of a block are converted while the block is still
+	in the cache. Large conversions are split across multiple threads.
+	@ingroup resources
+*/
+class ResourceLayoutConverter {
+public:
+	using StreamFormats_t = std::vector<ResourceFormat>;
+
+	//! Creates a converter between two interleaved formats.
+	UTILAPI ResourceLayoutConverter(const ResourceFormat& srcFormat, const ResourceFormat& tgtFormat);
+
+	//! Creates a converter between two multi-stream layouts.
+	UTILAPI ResourceLayoutConverter(const StreamFormats_t& srcStreams, const StreamFormats_t& tgtStreams);
+
+	//! Splits a format into one single-attribute format per attribute (planar layout).
+	UTILAPI static StreamFormats_t createPlanarFormats(const ResourceFormat& format);
+
+	//! Combines the attributes of all streams into one interleaved format.
+	UTILAPI static ResourceFormat createInterleavedFormat(const StreamFormats_t& streams, uint64_t attributeAlignment=0);
+
+	/**
+	 * Returns the byte offset of a stream, when all streams of a layout are stored consecutively in a single buffer.
+	 * @param count The number of elements.
+	 */
+	UTILAPI static uint64_t getStreamOffset(const StreamFormats_t& streams, uint32_t streamIndex, uint64_t count);
+
+	//! Returns the size of @p count elements, when all streams of a layout are stored consecutively in a single buffer.
+	static uint64_t getDataSize(const StreamFormats_t& streams, uint64_t count) { return getStreamOffset(streams, static_cast<uint32_t>(streams.size()), count); }
+
+	/**
+	 * Converts @p count elements.
+	 * @param srcData One data pointer for each source stream.
+	 * @param tgtData One data pointer for each target stream.
+	 * @param threadCount The maximum number of threads (0 = default).
+	 * @note The source and target data may not overlap.
+	 */
+	UTILAPI void convert(const std::vector<const uint8_t*>& srcData, const std::vector<uint8_t*>& tgtData, uint64_t count, uint32_t threadCount=0) const;
+
+	//! Converts @p count elements, where the streams of each layout are stored consecutively in a single buffer (see @p getStreamOffset).
+	UTILAPI void convert(const uint8_t* srcData, uint8_t* tgtData, uint64_t count, uint32_t threadCount=0) const;
+
+	const StreamFormats_t& getSourceStreams() const { return srcStreams; }
+	const StreamFormats_t& getTargetStreams() const { return tgtStreams; }
+
+	//! Returns the number of elements that are processed at once.
+	uint64_t getBlockSize() const { return blockSize; }
+
+	//! Returns @p true if the conversion consists only of plain copies.
+	UTILAPI bool isCopyOnly() const;
+private:
+	friend class ResourceConverter;
+	enum class Kernel : uint8_t { Copy, Swizzle, Shuffle, Normalize, Unnormalize, Convert };
+	struct Operation {
+		Kernel kernel;
+		uint32_t srcStream;
+		uint32_t tgtStream;
+		uint64_t srcOffset;
+		uint64_t tgtOffset;
+		uint64_t size; //!< number of bytes per element (copy) or per component (swizzle)
+		std::vector<uint32_t> order; //!< source component of each target component (swizzle)
+		AttributeFormat srcAttr;
+		AttributeFormat tgtAttr;
+		AttributeAccessor::AccessorFactory_t srcFactory;
+		AttributeAccessor::AccessorFactory_t tgtFactory;
+		TypeConstant intermediateType;
+		std::vector<int8_t> pattern; //!< source byte of each target byte or -1 (shuffle, normalize, unnormalize; empty if not needed)
+		std::vector<uint8_t> fill; //!< value of the target bytes without source byte
+	};
+	//! @param matchSingleAttributes Match the attributes of two single-attribute formats regardless of their names (see ResourceConverter).
+	ResourceLayoutConverter(const StreamFormats_t& srcStreams, const StreamFormats_t& tgtStreams, bool matchSingleAttributes);
+	void buildPlan(bool matchSingleAttributes);
+	void addOperation(uint32_t srcStream, const AttributeFormat& srcAttr, uint32_t tgtStream, const AttributeFormat& tgtAttr, std::vector<Operation>& copies);
+	void convert(const uint8_t* const* srcData, uint8_t* const* tgtData, uint64_t count, uint32_t threadCount) const;
+
+	//! Registers a component order (see @p ResourceConverter::registerComponentOrder).
+	static void setComponentOrder(uint32_t internalType, const std::vector<uint32_t>& order);
+
+	const StreamFormats_t srcStreams;
+	const StreamFormats_t tgtStreams;
+	std::vector<Operation> operations;
+	uint64_t blockSize = 0;
+	uint64_t bytesPerElement = 0;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_RESOURCELAYOUTCONVERTER_H_ */
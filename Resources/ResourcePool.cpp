@@ -0,0 +1,196 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ResourcePool.h"
+#include "MemoryResource.h"
+#include "../Macros.h"
+
+#include <stdexcept>
+
+namespace Util {
+
+//---------------
+
+void ResourceReleaseHandler::release(Resource* resource) {
+	ResourcePool* pool = resource->pool;
+	if(!pool) {
+		delete resource;
+		return;
+	}
+	pool->recycle(resource);
+	// the resource no longer keeps the pool alive
+	ResourcePool::removeReference(pool);
+}
+
+//---------------
+
+size_t ResourcePool::KeyHash::operator()(const Key& key) const {
+	uint64_t result = std::hash<ResourceFormat>()(key.format);
+	hash_combine(result, key.capacity);
+	return static_cast<size_t>(result);
+}
+
+//---------------
+
+ResourcePool::Ref ResourcePool::create(uint64_t budget, Factory_t factory) {
+	return new ResourcePool(budget, std::move(factory));
+}
+
+//---------------
+
+ResourcePool::ResourcePool(uint64_t budget, Factory_t factory) : factory(std::move(factory)), budget(budget) {
+	if(!this->factory) {
+		this->factory = [](const ResourceFormat& format, uint64_t elementCount) -> Reference<Resource> {
+			return MemoryResource::create(format, elementCount).get();
+		};
+	}
+}
+
+//---------------
+
+ResourcePool::~ResourcePool() {
+	// only free resources remain, as all resources in use hold a reference to the pool
+	for(auto& entry : lru)
+		delete entry.resource;
+}
+
+//---------------
+
+uint64_t ResourcePool::getCapacityBucket(uint64_t elementCount) {
+	// keep the 3 most significant bits and round up the rest
+	uint32_t bits = 0;
+	for(uint64_t v = elementCount; v > 0; v >>= 1)
+		++bits;
+	if(bits <= 3)
+		return elementCount;
+	const uint64_t mask = (uint64_t(1) << (bits - 3)) - 1;
+	return (elementCount + mask) & ~mask;
+}
+
+//---------------
+
+Reference<Resource> ResourcePool::acquire(const ResourceFormat& format, uint64_t elementCount) {
+	if(format.getSize() == 0)
+		throw std::invalid_argument("ResourcePool: Cannot acquire resource with an empty format.");
+	const Key key{format, getCapacityBucket(elementCount)};
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = freeLists.find(key);
+		if(it != freeLists.end() && !it->second.empty()) {
+			auto entry = it->second.back();
+			it->second.pop_back();
+			Resource* resource = entry->resource;
+			stats.freeBytes -= resource->getSize();
+			--stats.freeCount;
+			++stats.hits;
+			lru.erase(entry);
+			if(it->second.empty())
+				freeLists.erase(it);
+			addReference(this);
+			return resource;
+		}
+		++stats.misses;
+	}
+	Reference<Resource> resource = factory(format, key.capacity);
+	WARN_AND_RETURN_IF(!resource, "ResourcePool: Factory failed to create a resource.", nullptr);
+	WARN_AND_RETURN_IF(resource->pool, "ResourcePool: Factory returned a resource that already belongs to a pool.", resource);
+	WARN_IF(!(resource->getFormat() == format) || resource->getSize() < format.getSize() * elementCount,
+		"ResourcePool: Factory returned a resource with a different format or an insufficient size.");
+	resource->pool = this;
+	resource->poolCapacity = key.capacity;
+	addReference(this);
+	return resource;
+}
+
+//---------------
+
+void ResourcePool::recycle(Resource* resource) {
+	const uint64_t size = resource->getSize();
+	std::vector<Resource*> evicted;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(size == 0 || size > budget) {
+			evicted.emplace_back(resource);
+		} else {
+			resource->consumeDirtyRanges();
+			// the factory may have created a larger resource, so the bucket of the request is used as key
+			auto it = freeLists.emplace(Key{resource->getFormat(), resource->poolCapacity}, std::vector<FreeList_t::iterator>()).first;
+			it->second.emplace_back(lru.insert(lru.end(), {resource, &it->first}));
+			stats.freeBytes += size;
+			++stats.freeCount;
+			evict(budget, evicted);
+		}
+	}
+	for(auto r : evicted)
+		delete r;
+}
+
+//---------------
+
+void ResourcePool::evict(uint64_t targetBytes, std::vector<Resource*>& evicted) {
+	while(stats.freeBytes > targetBytes && !lru.empty()) {
+		const FreeEntry entry = lru.front();
+		auto it = freeLists.find(*entry.key);
+		auto& entries = it->second;
+		// the oldest entry of a key is always at the front of its free list
+		entries.erase(entries.begin());
+		if(entries.empty())
+			freeLists.erase(it);
+		lru.pop_front();
+		stats.freeBytes -= entry.resource->getSize();
+		--stats.freeCount;
+		++stats.evictions;
+		evicted.emplace_back(entry.resource);
+	}
+}
+
+//---------------
+
+void ResourcePool::trim(uint64_t targetBytes) {
+	std::vector<Resource*> evicted;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		evict(targetBytes, evicted);
+	}
+	for(auto r : evicted)
+		delete r;
+}
+
+//---------------
+
+void ResourcePool::setBudget(uint64_t value) {
+	std::vector<Resource*> evicted;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		budget = value;
+		evict(budget, evicted);
+	}
+	for(auto r : evicted)
+		delete r;
+}
+
+//---------------
+
+ResourcePool::Statistics ResourcePool::getStatistics() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+//---------------
+
+void ResourcePool::resetStatistics() {
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.hits = 0;
+	stats.misses = 0;
+	stats.evictions = 0;
+}
+
+//---------------
+
+} /* Util */
@@ -0,0 +1,113 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_RESOURCEPOOL_H_
+#define UTIL_RESOURCES_RESOURCEPOOL_H_
+
+#include "Resource.h"
+#include "../ReferenceCounter.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Util {
+
+/** ResourcePool
+	Recycles released resources with the same format and a similar capacity instead of deleting them.
+
+	Resources are acquired for a format and an element count. When the last reference to an acquired
+	resource is removed (see ResourceReleaseHandler), it is put back to a free list of the pool,
+	which is keyed on the format and the capacity bucket of the resource.
+	The element count of a request is rounded up to its capacity bucket (at most 25% larger), so requests with
+	slightly different sizes can share resources.
+	The free resources are limited by a memory budget; when it is exceeded, the least recently released resources are deleted.
+
+	@note Resources that are still in use keep the pool alive.
+	@note This class is thread-safe.
+	@ingroup resources
+*/
+class ResourcePool : public ReferenceCounter<ResourcePool> {
+public:
+	using Ref = Reference<ResourcePool>;
+	//! Creates a new resource with space for (at least) the given number of elements.
+	using Factory_t = std::function<Reference<Resource>(const ResourceFormat&, uint64_t)>;
+
+	struct Statistics {
+		uint64_t hits = 0; //!< Number of acquisitions that reused a free resource.
+		uint64_t misses = 0; //!< Number of acquisitions that created a new resource.
+		uint64_t evictions = 0; //!< Number of free resources that were deleted to stay within the budget.
+		uint64_t freeCount = 0; //!< Number of currently free resources.
+		uint64_t freeBytes = 0; //!< Size of all currently free resources.
+	};
+
+	/**
+	 * Creates a new resource pool.
+	 * @param budget Maximum size in bytes of all free resources held by the pool.
+	 * @param factory Function used to create new resources (defaults to MemoryResource).
+	 */
+	UTILAPI static Ref create(uint64_t budget=64*1024*1024, Factory_t factory=nullptr);
+	UTILAPI ~ResourcePool();
+
+	/**
+	 * Returns a resource with the given format and space for at least @p elementCount elements.
+	 * The resource is either recycled from the free list or created by the factory.
+	 * The content of a recycled resource is undefined.
+	 */
+	UTILAPI Reference<Resource> acquire(const ResourceFormat& format, uint64_t elementCount);
+
+	//! Deletes the least recently released free resources until the free resources occupy at most @p targetBytes.
+	UTILAPI void trim(uint64_t targetBytes=0);
+
+	//! Deletes all free resources.
+	void clear() { trim(0); }
+
+	//! Sets the memory budget for free resources (and trims the pool if necessary).
+	UTILAPI void setBudget(uint64_t value);
+	uint64_t getBudget() const { return budget; }
+
+	UTILAPI Statistics getStatistics() const;
+	UTILAPI void resetStatistics();
+
+	//! Returns the element count that is allocated for a request of @p elementCount elements.
+	UTILAPI static uint64_t getCapacityBucket(uint64_t elementCount);
+private:
+	friend struct ResourceReleaseHandler;
+	ResourcePool(uint64_t budget, Factory_t factory);
+	void recycle(Resource* resource);
+	void evict(uint64_t targetBytes, std::vector<Resource*>& evicted);
+
+	struct Key {
+		ResourceFormat format;
+		uint64_t capacity;
+		bool operator==(const Key& o) const { return capacity == o.capacity && format == o.format; }
+	};
+	struct KeyHash {
+		size_t operator()(const Key& key) const;
+	};
+	struct FreeEntry {
+		Resource* resource;
+		const Key* key;
+	};
+	using FreeList_t = std::list<FreeEntry>;
+
+	mutable std::mutex mutex;
+	Factory_t factory;
+	uint64_t budget;
+	FreeList_t lru; //!< Free resources in the order they were released (oldest first).
+	std::unordered_map<Key, std::vector<FreeList_t::iterator>, KeyHash> freeLists;
+	Statistics stats;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_RESOURCEPOOL_H_ */
@@ -0,0 +1,579 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ResourceUtils.h"
+#include "MemoryResource.h"
+#include "ResourceAccessor.h"
+#include "../IO/FileName.h"
+#include "../IO/FileUtils.h"
+#include "../Macros.h"
+#include "../Parallel.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace Util {
+namespace ResourceUtils {
+
+const StringIdentifier INDEX("index");
+
+static const uint64_t GRAIN_SIZE = 16 * 1024;
+
+//---------------
+// weld
+
+//! 64 bit hash of a key (processed in words of 8 bytes).
+static uint64_t hashKey(const uint8_t* key, uint64_t size) {
+	uint64_t h = 0x9e3779b97f4a7c15ull ^ size;
+	uint64_t i = 0;
+	for(; i + 8 <= size; i += 8) {
+		uint64_t w;
+		std::memcpy(&w, key + i, 8);
+		h = (h ^ w) * 0xff51afd7ed558ccdull;
+		h ^= h >> 32;
+	}
+	if(i < size) {
+		uint64_t w = 0;
+		std::memcpy(&w, key + i, size - i);
+		h = (h ^ w) * 0xff51afd7ed558ccdull;
+	}
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ull;
+	h ^= h >> 33;
+	return h;
+}
+
+//! Builds the comparison key of an element from the selected attributes.
+class KeyBuilder {
+public:
+	KeyBuilder(const Reference<Resource>& resource, uint8_t* data, const std::vector<StringIdentifier>& attributeIds, double epsilon) :
+			data(data), stride(resource->getFormat().getSize()), accessor(ResourceAccessor::create(data, resource->getSize(), resource->getFormat())) {
+		const auto& format = resource->getFormat();
+		std::vector<uint32_t> locations;
+		if(attributeIds.empty()) {
+			for(uint32_t location = 0; location < format.getNumAttributes(); ++location)
+				locations.emplace_back(location);
+		} else {
+			for(const auto& id : attributeIds) {
+				if(!format.hasAttribute(id))
+					throw std::invalid_argument("ResourceUtils::weld: There is no attribute '" + id.toString() + "'.");
+				locations.emplace_back(format.getAttributeLocation(id));
+			}
+		}
+		for(uint32_t location : locations) {
+			const auto& attr = format.getAttribute(location);
+			Part part{location, attr.getOffset(), attr.getDataSize(), attr.getComponentCount(), false};
+			if(epsilon > 0 && isFloatType(attr.getDataType()) && attr.getInternalType() == 0) {
+				part.quantized = true;
+				keySize += part.components * sizeof(int64_t);
+			} else {
+				keySize += part.size;
+			}
+			parts.emplace_back(part);
+		}
+		invEpsilon = epsilon > 0 ? 1.0 / epsilon : 0.0;
+	}
+
+	uint64_t getKeySize() const { return keySize; }
+
+	void build(uint64_t index, uint8_t* key) const {
+		const uint8_t* element = data + index * stride;
+		static thread_local std::vector<double> values;
+		for(const auto& part : parts) {
+			if(!part.quantized) {
+				std::memcpy(key, element + part.offset, part.size);
+				key += part.size;
+				continue;
+			}
+			if(values.size() < part.components)
+				values.resize(part.components);
+			accessor->readValues(index, part.location, values.data(), part.components);
+			for(uint32_t i = 0; i < part.components; ++i) {
+				const int64_t cell = quantize(values[i]);
+				std::memcpy(key, &cell, sizeof(int64_t));
+				key += sizeof(int64_t);
+			}
+		}
+	}
+private:
+	//! Returns the grid cell of @p value; values outside of the int64 range are clamped (NaN is mapped to the maximum).
+	int64_t quantize(double value) const {
+		const double cell = std::floor(value * invEpsilon);
+		const double limit = 9223372036854775808.0; // 2^63
+		if(std::isnan(cell) || cell >= limit)
+			return std::numeric_limits<int64_t>::max();
+		if(cell < -limit)
+			return std::numeric_limits<int64_t>::min();
+		return static_cast<int64_t>(cell);
+	}
+
+	struct Part {
+		uint32_t location;
+		uint64_t offset;
+		uint64_t size;
+		uint32_t components;
+		bool quantized;
+	};
+	const uint8_t* data;
+	const uint64_t stride;
+	ResourceAccessor::Ref accessor;
+	std::vector<Part> parts;
+	uint64_t keySize = 0;
+	double invEpsilon = 0;
+};
+
+//---------------
+
+WeldResult weld(const Reference<Resource>& resource, const std::vector<StringIdentifier>& attributes, double epsilon, uint32_t threadCount) {
+	const auto& format = resource->getFormat();
+	const uint64_t stride = format.getSize();
+	const uint64_t elementCount = resource->getElementCount();
+	if(elementCount >= std::numeric_limits<uint32_t>::max())
+		throw std::invalid_argument("ResourceUtils::weld: Too many elements.");
+	threadCount = threadCount == 0 ? getDefaultThreadCount() : threadCount;
+
+	ResourceFormat indexFormat;
+	indexFormat.appendUInt(INDEX, 1);
+	WeldResult result;
+	result.indices = MemoryResource::create(indexFormat, elementCount).get();
+	if(elementCount == 0) {
+		result.resource = MemoryResource::create(format, 0).get();
+		return result;
+	}
+
+	uint8_t* data = resource->map();
+	const KeyBuilder keys(resource, data, attributes, epsilon);
+	const uint64_t keySize = keys.getKeySize();
+
+	// Table entries store the upper 32 bits of the hash and the element index + 1 (0 = empty).
+	// Equal keys follow the same probe sequence, so they always meet in the same entry,
+	// which keeps the smallest index (i.e., the first occurrence) of the key.
+	uint64_t capacity = 16;
+	while(capacity < elementCount + elementCount / 2)
+		capacity *= 2;
+	const uint64_t mask = capacity - 1;
+	std::unique_ptr<std::atomic<uint64_t>[]> table(new std::atomic<uint64_t>[capacity]);
+	parallelFor(0, capacity, GRAIN_SIZE, [&](uint64_t begin, uint64_t end) {
+		for(uint64_t i = begin; i < end; ++i)
+			table[i].store(0, std::memory_order_relaxed);
+	}, threadCount);
+
+	// Returns the entry of @p key or 0 if the key is not in the table.
+	const auto find = [&](const uint8_t* key, uint8_t* otherKey) -> uint64_t {
+		const uint64_t hash = hashKey(key, keySize);
+		for(uint64_t slot = hash & mask;; slot = (slot + 1) & mask) {
+			const uint64_t entry = table[slot].load(std::memory_order_acquire);
+			if(entry == 0)
+				return 0;
+			if((entry >> 32) == (hash >> 32)) {
+				keys.build((entry & 0xffffffffull) - 1, otherKey);
+				if(std::memcmp(key, otherKey, keySize) == 0)
+					return entry;
+			}
+		}
+	};
+
+	parallelFor(0, elementCount, GRAIN_SIZE, [&](uint64_t begin, uint64_t end) {
+		std::vector<uint8_t> key(keySize), otherKey(keySize);
+		for(uint64_t i = begin; i < end; ++i) {
+			keys.build(i, key.data());
+			const uint64_t hash = hashKey(key.data(), keySize);
+			const uint64_t newEntry = (hash & ~0xffffffffull) | (i + 1);
+			for(uint64_t slot = hash & mask;; slot = (slot + 1) & mask) {
+				uint64_t entry = table[slot].load(std::memory_order_acquire);
+				if(entry == 0 && table[slot].compare_exchange_strong(entry, newEntry, std::memory_order_acq_rel))
+					break;
+				// the entry is occupied (possibly just now by another thread)
+				if((entry >> 32) != (hash >> 32))
+					continue;
+				keys.build((entry & 0xffffffffull) - 1, otherKey.data());
+				if(std::memcmp(key.data(), otherKey.data(), keySize) != 0)
+					continue;
+				// same key: keep the smallest index
+				while((entry & 0xffffffffull) > i + 1 && !table[slot].compare_exchange_weak(entry, newEntry, std::memory_order_acq_rel)) {}
+				break;
+			}
+		}
+	}, threadCount);
+
+	// representative (first occurrence) of each element
+	std::vector<uint32_t> representatives(elementCount);
+	parallelFor(0, elementCount, GRAIN_SIZE, [&](uint64_t begin, uint64_t end) {
+		std::vector<uint8_t> key(keySize), otherKey(keySize);
+		for(uint64_t i = begin; i < end; ++i) {
+			keys.build(i, key.data());
+			representatives[i] = static_cast<uint32_t>((find(key.data(), otherKey.data()) & 0xffffffffull) - 1);
+		}
+	}, threadCount);
+	table.reset();
+
+	// compact the unique elements (prefix sum over fixed chunks)
+	const uint64_t chunkCount = std::max<uint64_t>(1, std::min<uint64_t>(threadCount, elementCount / GRAIN_SIZE));
+	const uint64_t chunkSize = (elementCount + chunkCount - 1) / chunkCount;
+	std::vector<uint64_t> chunkOffsets(chunkCount + 1, 0);
+	parallelFor(0, chunkCount, 1, [&](uint64_t chunkBegin, uint64_t chunkEnd) {
+		for(uint64_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+			uint64_t count = 0;
+			for(uint64_t i = chunk * chunkSize; i < std::min(elementCount, (chunk + 1) * chunkSize); ++i)
+				count += representatives[i] == i;
+			chunkOffsets[chunk + 1] = count;
+		}
+	}, threadCount);
+	for(uint64_t chunk = 0; chunk < chunkCount; ++chunk)
+		chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+
+	result.resource = MemoryResource::create(format, chunkOffsets[chunkCount]).get();
+	uint8_t* target = result.resource->map();
+	uint32_t* indices = reinterpret_cast<uint32_t*>(result.indices->map());
+	parallelFor(0, chunkCount, 1, [&](uint64_t chunkBegin, uint64_t chunkEnd) {
+		for(uint64_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+			uint64_t newIndex = chunkOffsets[chunk];
+			for(uint64_t i = chunk * chunkSize; i < std::min(elementCount, (chunk + 1) * chunkSize); ++i) {
+				if(representatives[i] != i)
+					continue;
+				std::memcpy(target + newIndex * stride, data + i * stride, stride);
+				indices[i] = static_cast<uint32_t>(newIndex++);
+			}
+		}
+	}, threadCount);
+	// representatives precede their duplicates, but may lie in other chunks
+	parallelFor(0, elementCount, GRAIN_SIZE, [&](uint64_t begin, uint64_t end) {
+		for(uint64_t i = begin; i < end; ++i) {
+			if(representatives[i] != i)
+				indices[i] = indices[representatives[i]];
+		}
+	}, threadCount);
+
+	result.resource->unmap();
+	result.indices->unmap();
+	resource->unmap();
+	return result;
+}
+
+//---------------
+// sortBySpaceFillingCurve
+
+static const uint32_t CURVE_BITS = 21; //!< bits per axis of the curve keys
+
+//! Spreads the lower 21 bits of @p v to every third bit.
+static uint64_t spreadBits3(uint64_t v) {
+	v &= 0x1fffff;
+	v = (v | v << 32) & 0x1f00000000ffffull;
+	v = (v | v << 16) & 0x1f0000ff0000ffull;
+	v = (v | v << 8) & 0x100f00f00f00f00full;
+	v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+	v = (v | v << 2) & 0x1249249249249249ull;
+	return v;
+}
+
+static uint64_t mortonKey(uint32_t x, uint32_t y, uint32_t z) {
+	return (spreadBits3(x) << 2) | (spreadBits3(y) << 1) | spreadBits3(z);
+}
+
+//! Hilbert key based on J. Skilling, "Programming the Hilbert curve" (AIP Conf. Proc. 707, 2004).
+static uint64_t hilbertKey(uint32_t x, uint32_t y, uint32_t z) {
+	uint32_t v[3] = {x, y, z};
+	// inverse undo excess work
+	for(uint32_t q = 1u << (CURVE_BITS - 1); q > 1; q >>= 1) {
+		const uint32_t p = q - 1;
+		for(uint32_t i = 0; i < 3; ++i) {
+			if(v[i] & q) {
+				v[0] ^= p;
+			} else {
+				const uint32_t t = (v[0] ^ v[i]) & p;
+				v[0] ^= t;
+				v[i] ^= t;
+			}
+		}
+	}
+	// gray encode
+	v[1] ^= v[0];
+	v[2] ^= v[1];
+	uint32_t t = 0;
+	for(uint32_t q = 1u << (CURVE_BITS - 1); q > 1; q >>= 1) {
+		if(v[2] & q)
+			t ^= q - 1;
+	}
+	// the transposed key has the same bit layout as a morton key
+	return mortonKey(v[0] ^ t, v[1] ^ t, v[2] ^ t);
+}
+
+/**
+ * Stable parallel LSD radix sort of @p keys (with 8 bit digits) that applies the same permutation to @p values.
+ * Digits that are equal for all keys are skipped.
+ */
+static void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, uint32_t threadCount) {
+	const uint64_t count = keys.size();
+	const uint64_t chunkCount = std::max<uint64_t>(1, std::min<uint64_t>(threadCount, count / GRAIN_SIZE));
+	const uint64_t chunkSize = (count + chunkCount - 1) / chunkCount;
+	std::vector<uint64_t> tmpKeys(count);
+	std::vector<uint32_t> tmpValues(count);
+	std::vector<uint64_t> offsets(chunkCount * 256);
+	for(uint32_t shift = 0; shift < 64; shift += 8) {
+		std::fill(offsets.begin(), offsets.end(), 0);
+		parallelFor(0, chunkCount, 1, [&](uint64_t chunkBegin, uint64_t chunkEnd) {
+			for(uint64_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+				uint64_t* histogram = offsets.data() + chunk * 256;
+				for(uint64_t i = chunk * chunkSize; i < std::min(count, (chunk + 1) * chunkSize); ++i)
+					++histogram[(keys[i] >> shift) & 0xff];
+			}
+		}, threadCount);
+		// exclusive prefix sum in the order (digit, chunk)
+		uint64_t sum = 0;
+		bool skip = false;
+		for(uint32_t digit = 0; digit < 256; ++digit) {
+			uint64_t digitCount = 0;
+			for(uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+				const uint64_t n = offsets[chunk * 256 + digit];
+				offsets[chunk * 256 + digit] = sum;
+				sum += n;
+				digitCount += n;
+			}
+			if(digitCount == count)
+				skip = true;
+		}
+		if(skip)
+			continue;
+		parallelFor(0, chunkCount, 1, [&](uint64_t chunkBegin, uint64_t chunkEnd) {
+			for(uint64_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+				uint64_t* offset = offsets.data() + chunk * 256;
+				for(uint64_t i = chunk * chunkSize; i < std::min(count, (chunk + 1) * chunkSize); ++i) {
+					const uint64_t target = offset[(keys[i] >> shift) & 0xff]++;
+					tmpKeys[target] = keys[i];
+					tmpValues[target] = values[i];
+				}
+			}
+		}, threadCount);
+		keys.swap(tmpKeys);
+		values.swap(tmpValues);
+	}
+}
+
+//---------------
+
+void sortBySpaceFillingCurve(const Reference<Resource>& resource, const StringIdentifier& positionAttribute, SpaceFillingCurve curve,
+		std::vector<uint32_t>* permutation, uint32_t threadCount) {
+	const auto& format = resource->getFormat();
+	const uint64_t stride = format.getSize();
+	const uint64_t elementCount = resource->getElementCount();
+	if(!format.hasAttribute(positionAttribute))
+		throw std::invalid_argument("ResourceUtils::sortBySpaceFillingCurve: There is no attribute '" + positionAttribute.toString() + "'.");
+	if(elementCount > std::numeric_limits<uint32_t>::max())
+		throw std::invalid_argument("ResourceUtils::sortBySpaceFillingCurve: Too many elements.");
+	threadCount = threadCount == 0 ? getDefaultThreadCount() : threadCount;
+
+	uint8_t* data = resource->map();
+	std::vector<uint64_t> keys(elementCount);
+	std::vector<uint32_t> order(elementCount);
+	{
+		auto accessor = ResourceAccessor::create(data, resource->getSize(), format);
+		const uint32_t location = format.getAttributeLocation(positionAttribute);
+		const uint32_t valueCount = accessor->getValueCount(location);
+		const uint32_t dimensions = std::min<uint32_t>(3, valueCount);
+		// quantize the positions within the bounding cube
+		const auto bounds = accessor->computeBounds(location, threadCount);
+		double extent = 0;
+		for(uint32_t d = 0; d < dimensions; ++d)
+			extent = std::max(extent, bounds.max[d] - bounds.min[d]);
+		const double scale = extent > 0 && std::isfinite(extent) ? static_cast<double>(1u << CURVE_BITS) / extent : 0.0;
+		const uint32_t maxCell = (1u << CURVE_BITS) - 1;
+
+		parallelFor(0, elementCount, GRAIN_SIZE, [&](uint64_t begin, uint64_t end) {
+			const uint64_t blockSize = 1024;
+			std::vector<double> values(blockSize * valueCount);
+			for(uint64_t block = begin; block < end; block += blockSize) {
+				const uint64_t n = std::min(blockSize, end - block);
+				accessor->readRange(block, location, n, values.data());
+				for(uint64_t i = 0; i < n; ++i) {
+					uint32_t cell[3] = {0, 0, 0};
+					for(uint32_t d = 0; d < dimensions; ++d) {
+						const double v = (values[i * valueCount + d] - bounds.min[d]) * scale;
+						cell[d] = v > 0 ? static_cast<uint32_t>(std::min<double>(v, maxCell)) : 0; // NaN -> 0
+					}
+					keys[block + i] = curve == SpaceFillingCurve::Hilbert ? hilbertKey(cell[0], cell[1], cell[2]) : mortonKey(cell[0], cell[1], cell[2]);
+					order[block + i] = static_cast<uint32_t>(block + i);
+				}
+			}
+		}, threadCount);
+	}
+
+	radixSort(keys, order, threadCount);
+	std::vector<uint64_t>().swap(keys);
+
+	// gather the elements in their new order and copy them back
+	std::vector<uint8_t> sorted(elementCount * stride);
+	parallelFor(0, elementCount, GRAIN_SIZE, [&](uint64_t begin, uint64_t end) {
+		for(uint64_t i = begin; i < end; ++i)
+			std::memcpy(sorted.data() + i * stride, data + order[i] * stride, stride);
+	}, threadCount);
+	std::memcpy(data, sorted.data(), sorted.size());
+	resource->unmap();
+	resource->markDirty(0, sorted.size());
+
+	if(permutation)
+		permutation->swap(order);
+}
+
+//---------------
+// saveResource / loadResource
+
+static const char CONTAINER_MAGIC[8] = {'U', 'T', 'I', 'L', 'R', 'E', 'S', '\0'};
+static const uint32_t CONTAINER_VERSION = 1;
+static const uint32_t CONTAINER_BYTE_ORDER = 0x01020304;
+static const uint64_t CONTAINER_PAYLOAD_ALIGNMENT = 4096;
+
+/*
+	Container layout (native byte order):
+	char[8]  magic ("UTILRES")
+	uint32   version
+	uint32   byte order mark (0x01020304)
+	uint64   payload offset (multiple of 4096)
+	uint64   element count
+	uint64   element size
+	uint64   attribute alignment
+	uint32   attribute count
+	per attribute:
+		uint32   name length, followed by the name
+		uint32   type, components, normalized, internal type
+		uint64   offset
+	zero padding up to the payload offset
+	element data
+*/
+
+template<typename T>
+static void writeValue(std::string& out, const T& value) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+static bool readValue(std::istream& in, T& value) {
+	return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+struct ContainerHeader {
+	ResourceFormat format;
+	uint64_t payloadOffset = 0;
+	uint64_t elementCount = 0;
+	uint64_t headerSize = 0; //!< number of bytes read from the stream
+};
+
+static bool readContainerHeader(std::istream& in, ContainerHeader& header, const FileName& fileName) {
+	const std::string fileString = "ResourceUtils::loadResource: '" + fileName.toString() + "' ";
+	char magic[8];
+	uint32_t version = 0, byteOrder = 0, attributeCount = 0;
+	uint64_t elementSize = 0, alignment = 0;
+	WARN_AND_RETURN_IF(!in.read(magic, sizeof(magic)) || std::memcmp(magic, CONTAINER_MAGIC, sizeof(magic)) != 0, fileString + "is not a resource container.", false);
+	WARN_AND_RETURN_IF(!readValue(in, version) || version != CONTAINER_VERSION, fileString + "has an unsupported version.", false);
+	WARN_AND_RETURN_IF(!readValue(in, byteOrder) || byteOrder != CONTAINER_BYTE_ORDER, fileString + "has a different byte order.", false);
+	WARN_AND_RETURN_IF(!readValue(in, header.payloadOffset) || !readValue(in, header.elementCount) || !readValue(in, elementSize)
+		|| !readValue(in, alignment) || !readValue(in, attributeCount), fileString + "has an invalid header.", false);
+	header.format = ResourceFormat(alignment);
+	for(uint32_t i = 0; i < attributeCount; ++i) {
+		uint32_t nameLength = 0, type = 0, components = 0, normalized = 0, internalType = 0;
+		uint64_t offset = 0;
+		WARN_AND_RETURN_IF(!readValue(in, nameLength) || nameLength > 4096, fileString + "has an invalid attribute.", false);
+		std::string name(nameLength, '\0');
+		WARN_AND_RETURN_IF(!in.read(&name[0], nameLength) || !readValue(in, type) || !readValue(in, components) || !readValue(in, normalized)
+			|| !readValue(in, internalType) || !readValue(in, offset), fileString + "has an invalid attribute.", false);
+		WARN_AND_RETURN_IF(type > static_cast<uint32_t>(TypeConstant::BFLOAT16), fileString + "has an attribute with an unknown type.", false);
+		header.format._appendAttribute(StringIdentifier(name), static_cast<TypeConstant>(type), components, normalized != 0, internalType, offset);
+		header.headerSize += sizeof(uint32_t) * 5 + nameLength + sizeof(uint64_t);
+	}
+	header.headerSize += sizeof(magic) + sizeof(uint32_t) * 3 + sizeof(uint64_t) * 4;
+	WARN_AND_RETURN_IF(header.payloadOffset < header.headerSize, fileString + "has an invalid header.", false);
+	WARN_AND_RETURN_IF(header.format.getSize() > elementSize, fileString + "has an invalid element size.", false);
+	header.format.setSize(elementSize);
+	return true;
+}
+
+//---------------
+
+bool saveResource(const Reference<Resource>& resource, const FileName& fileName) {
+	WARN_AND_RETURN_IF(!resource, "ResourceUtils::saveResource: Invalid resource.", false);
+	const auto& format = resource->getFormat();
+	const uint64_t elementCount = resource->getElementCount();
+	const uint64_t payloadSize = elementCount * format.getSize();
+
+	std::string header(CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+	writeValue(header, CONTAINER_VERSION);
+	writeValue(header, CONTAINER_BYTE_ORDER);
+	const size_t payloadOffsetPosition = header.size();
+	writeValue(header, uint64_t(0));
+	writeValue(header, elementCount);
+	writeValue(header, format.getSize());
+	writeValue(header, format.getAlignment());
+	writeValue(header, format.getNumAttributes());
+	for(const auto& attr : format.getAttributes()) {
+		const std::string name = attr.getName();
+		writeValue(header, static_cast<uint32_t>(name.size()));
+		header.append(name);
+		writeValue(header, static_cast<uint32_t>(attr.getDataType()));
+		writeValue(header, attr.getComponentCount());
+		writeValue(header, static_cast<uint32_t>(attr.isNormalized()));
+		writeValue(header, attr.getInternalType());
+		writeValue(header, attr.getOffset());
+	}
+	const uint64_t payloadOffset = (header.size() + CONTAINER_PAYLOAD_ALIGNMENT - 1) / CONTAINER_PAYLOAD_ALIGNMENT * CONTAINER_PAYLOAD_ALIGNMENT;
+	std::memcpy(&header[payloadOffsetPosition], &payloadOffset, sizeof(uint64_t));
+	header.resize(payloadOffset, '\0');
+
+	auto out = FileUtils::openForWriting(fileName);
+	WARN_AND_RETURN_IF(!out, "ResourceUtils::saveResource: Could not open '" + fileName.toString() + "' for writing.", false);
+	out->write(header.data(), header.size());
+	const uint8_t* data = resource->map();
+	if(payloadSize > 0) {
+		WARN_AND_RETURN_IF(!data, "ResourceUtils::saveResource: Could not map the resource.", false);
+		// write in blocks to keep the footprint of buffering streams small
+		const uint64_t blockSize = 8 * 1024 * 1024;
+		for(uint64_t offset = 0; offset < payloadSize && out->good(); offset += blockSize)
+			out->write(reinterpret_cast<const char*>(data + offset), static_cast<std::streamsize>(std::min(blockSize, payloadSize - offset)));
+	}
+	resource->unmap();
+	out->flush();
+	WARN_AND_RETURN_IF(!out->good(), "ResourceUtils::saveResource: Could not write '" + fileName.toString() + "'.", false);
+	return true;
+}
+
+//---------------
+
+Reference<Resource> loadResource(const FileName& fileName, MappedFileResource::AccessMode mode) {
+	auto in = FileUtils::openForReading(fileName);
+	WARN_AND_RETURN_IF(!in, "ResourceUtils::loadResource: Could not open '" + fileName.toString() + "'.", nullptr);
+	ContainerHeader header;
+	if(!readContainerHeader(*in, header, fileName))
+		return nullptr;
+	const uint64_t payloadSize = header.elementCount * header.format.getSize();
+
+	if(fileName.getFSName().empty() || fileName.getFSName() == "file") {
+		in.reset();
+		if(payloadSize == 0)
+			return MemoryResource::create(header.format, 0).get();
+		return MappedFileResource::open(fileName, header.format, mode, header.payloadOffset, payloadSize).get();
+	}
+
+	// fallback for file systems without memory mapping: copy the data
+	Reference<Resource> resource = MemoryResource::create(header.format, header.elementCount).get();
+	WARN_AND_RETURN_IF(!in->ignore(static_cast<std::streamsize>(header.payloadOffset - header.headerSize))
+		|| !in->read(reinterpret_cast<char*>(resource->map()), static_cast<std::streamsize>(payloadSize)),
+		"ResourceUtils::loadResource: '" + fileName.toString() + "' is truncated.", nullptr);
+	resource->unmap();
+	return resource;
+}
+
+//---------------
+
+}
+}
@@ -0,0 +1,96 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_RESOURCEUTILS_H_
+#define UTIL_RESOURCES_RESOURCEUTILS_H_
+
+#include "MappedFileResource.h"
+#include "Resource.h"
+#include "../References.h"
+#include "../StringIdentifier.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Util {
+class FileName;
+
+/**
+ * Collection of Resource related operations.
+ * @ingroup resources
+ */
+namespace ResourceUtils {
+
+//! Name of the attribute of index resources (UINT32).
+UTILAPI extern const StringIdentifier INDEX;
+
+struct WeldResult {
+	//! The unique elements in the order of their first occurrence (same format as the input).
+	Reference<Resource> resource;
+	//! One @p INDEX value per input element with the index of its element in @p resource.
+	Reference<Resource> indices;
+};
+
+/**
+ * Removes duplicate elements of a resource (e.g., vertices of an imported mesh).
+ *
+ * Two elements are duplicates if the given attributes (all attributes if @p attributes is empty) are equal.
+ * The first occurrence of an element is kept with all of its attributes.
+ * If @p epsilon is greater than zero, the values of floating point attributes are quantized to a grid with the cell size @p epsilon
+ * before they are compared, i.e., values that fall into the same cell are considered equal (values that are closer than @p epsilon, but
+ * lie in different cells, are not merged). All other attributes are compared bitwise.
+ *
+ * The elements are inserted into a lock-free open-addressing hash table in parallel, so the result does not depend on the thread count.
+ * @param threadCount The maximum number of threads (0 = @p getDefaultThreadCount()).
+ * @throws std::invalid_argument if an attribute does not exist or the resource has 2^32-1 or more elements.
+ */
+UTILAPI WeldResult weld(const Reference<Resource>& resource, const std::vector<StringIdentifier>& attributes={}, double epsilon=0, uint32_t threadCount=0);
+
+//! Space-filling curves for @p sortBySpaceFillingCurve.
+enum class SpaceFillingCurve : uint8_t {
+	Morton,		//!< Z-order curve (interleaved coordinate bits).
+	Hilbert		//!< Hilbert curve (better locality, consecutive cells are always adjacent).
+};
+
+/**
+ * Reorders the elements of a resource along a space-filling curve to improve the memory locality of spatially close elements.
+ *
+ * The first (up to) three components of the position attribute are read through its attribute accessor (so any position type is supported),
+ * quantized to 21 bits per axis within the bounding cube of all positions, and mapped to a 63 bit curve key.
+ * The elements are then sorted by their keys with a parallel LSD radix sort (stable, so elements with equal keys keep their order)
+ * and all attributes are moved to their new position.
+ * @param permutation If not null, receives the old index of each element in the new order.
+ * @param threadCount The maximum number of threads (0 = @p getDefaultThreadCount()).
+ * @throws std::invalid_argument if the position attribute does not exist or the resource has 2^32 or more elements.
+ */
+UTILAPI void sortBySpaceFillingCurve(const Reference<Resource>& resource, const StringIdentifier& positionAttribute, SpaceFillingCurve curve=SpaceFillingCurve::Morton,
+	std::vector<uint32_t>* permutation=nullptr, uint32_t threadCount=0);
+
+/**
+ * Saves a resource together with its format to a self-describing binary file.
+ *
+ * The file starts with a header that contains the serialized ResourceFormat (names, types, offsets, internal types, alignment and element size)
+ * followed by the raw element data at a page aligned (4096 bytes) offset. The data is written in native byte order.
+ * The data is streamed to the file through @p FileUtils::openForWriting, so all file systems that support writing can be used.
+ * @return @p true on success.
+ */
+UTILAPI bool saveResource(const Reference<Resource>& resource, const FileName& fileName);
+
+/**
+ * Loads a resource that was saved with @p saveResource.
+ *
+ * Local files are mapped with a MappedFileResource (zero-copy) using the given access mode.
+ * Files of other file systems (e.g., "zip://" or "dbfs://") are read through @p FileUtils::openForReading into a MemoryResource.
+ * @return The resource, or nullptr if the file could not be loaded.
+ */
+UTILAPI Reference<Resource> loadResource(const FileName& fileName, MappedFileResource::AccessMode mode=MappedFileResource::AccessMode::ReadOnly);
+
+}
+}
+
+#endif /* end of include guard: UTIL_RESOURCES_RESOURCEUTILS_H_ */
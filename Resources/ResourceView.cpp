@@ -0,0 +1,103 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ResourceView.h"
+#include "../Macros.h"
+
+#include <stdexcept>
+
+namespace Util {
+
+//---------------
+
+ResourceView::Ref ResourceView::create(const Reference<Resource>& parent, const ResourceFormat& format, uint64_t offset, uint64_t size) {
+	if(!parent || offset > parent->getSize() || size > parent->getSize() - offset)
+		throw std::range_error("ResourceView: Range [" + std::to_string(offset) + ", " + std::to_string(offset+size) + ") exceeds the parent resource.");
+	// refer directly to the underlying resource
+	if(auto parentView = dynamic_cast<ResourceView*>(parent.get())) {
+		if(!parentView->parent)
+			throw std::range_error("ResourceView: Cannot create a view of a released view.");
+		return new ResourceView(parentView->parent, format, parentView->byteOffset + offset, size);
+	}
+	return new ResourceView(parent, format, offset, size);
+}
+
+//---------------
+
+ResourceView::ResourceView(const Reference<Resource>& parent, const ResourceFormat& format, uint64_t offset, uint64_t size) :
+		Resource(format), parent(parent), byteOffset(offset) {
+	dataSize = size;
+}
+
+//---------------
+
+uint8_t* ResourceView::map() {
+	uint8_t* ptr = parent ? parent->map() : nullptr;
+	return ptr ? ptr + byteOffset : nullptr;
+}
+
+//---------------
+
+void ResourceView::release() {
+	parent = nullptr;
+	dataSize = 0;
+}
+
+//---------------
+
+void ResourceView::upload(const uint8_t* srcData, size_t size, size_t offset) {
+	WARN_AND_RETURN_IF(!parent, "ResourceView: Cannot upload data. The view has been released.",);
+	WARN_AND_RETURN_IF(!checkRange(offset, size), "ResourceView: Cannot upload data. Size + offset is out of range.",);
+	parent->upload(srcData, size, byteOffset + offset);
+}
+
+//---------------
+
+void ResourceView::download(uint8_t* tgtData, size_t size, size_t offset) {
+	WARN_AND_RETURN_IF(!parent, "ResourceView: Cannot download data. The view has been released.",);
+	WARN_AND_RETURN_IF(!checkRange(offset, size), "ResourceView: Cannot download data. Size + offset is out of range.",);
+	parent->download(tgtData, size, byteOffset + offset);
+}
+
+//---------------
+// Resource::view
+
+static void assertElementRange(uint64_t firstElement, uint64_t count, uint64_t elementCount) {
+	if(firstElement > elementCount || count > elementCount - firstElement)
+		throw std::range_error("Resource: Cannot create view. Element range [" + std::to_string(firstElement) + ", " + std::to_string(firstElement+count) + ") is out of range.");
+}
+
+//---------------
+
+Reference<Resource> Resource::view(uint64_t firstElement, uint64_t count) {
+	const uint64_t stride = format.getSize();
+	assertElementRange(firstElement, count, getElementCount());
+	return ResourceView::create(this, format, firstElement * stride, count * stride).get();
+}
+
+//---------------
+
+Reference<Resource> Resource::view(const std::vector<StringIdentifier>& attributes, uint64_t firstElement, uint64_t count) {
+	assertElementRange(firstElement, count, getElementCount());
+	ResourceFormat subFormat(format.getAlignment());
+	for(const auto& nameId : attributes) {
+		const auto& attr = format.getAttribute(nameId);
+		if(!attr.isValid())
+			throw std::invalid_argument("Resource: Cannot create view. There is no attribute '" + nameId.toString() + "'.");
+		subFormat._appendAttribute(nameId, attr.getDataType(), attr.getComponentCount(), attr.isNormalized(), attr.getInternalType(), attr.getOffset());
+	}
+	// keep the stride of the elements
+	subFormat.setSize(format.getSize());
+	const uint64_t stride = format.getSize();
+	return ResourceView::create(this, subFormat, firstElement * stride, count * stride).get();
+}
+
+//---------------
+
+} /* Util */
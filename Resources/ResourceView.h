@@ -0,0 +1,62 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_RESOURCEVIEW_H_
+#define UTIL_RESOURCES_RESOURCEVIEW_H_
+
+#include "Resource.h"
+
+namespace Util {
+
+/** ResourceView
+	Zero-copy view of a byte range of another resource (see @p Resource::view).
+
+	The view keeps its parent alive and forwards mapping, flushing and dirty range tracking to it,
+	so modified ranges are tracked (in parent byte offsets) by the parent.
+	Views of views refer directly to the underlying resource.
+	@ingroup resources
+*/
+class ResourceView : public Resource {
+public:
+	using Ref = Reference<ResourceView>;
+
+	/**
+	 * Creates a view of @p size bytes starting at byte @p offset of @p parent.
+	 * The size of @p format should be a divisor of @p size.
+	 * @throws std::range_error if the range exceeds the parent resource.
+	 */
+	UTILAPI static Ref create(const Reference<Resource>& parent, const ResourceFormat& format, uint64_t offset, uint64_t size);
+
+	UTILAPI uint8_t* map() override;
+	void unmap() override { if(parent) parent->unmap(); }
+	void flush() override { if(parent) parent->flush(); }
+
+	//! Releases the reference to the parent resource. Afterwards, the view is empty.
+	UTILAPI void release() override;
+
+	UTILAPI void upload(const uint8_t* srcData, size_t size, size_t offset=0) override;
+	UTILAPI void download(uint8_t* tgtData, size_t size, size_t offset=0) override;
+	using Resource::upload;
+	using Resource::download;
+
+	void markDirty(uint64_t offset, uint64_t size) override { if(parent) parent->markDirty(byteOffset + offset, size); }
+	bool isDirtyTrackingEnabled() const override { return parent && parent->isDirtyTrackingEnabled(); }
+
+	const Reference<Resource>& getParent() const { return parent; }
+	//! Returns the byte offset of the view in the parent resource.
+	uint64_t getByteOffset() const { return byteOffset; }
+private:
+	ResourceView(const Reference<Resource>& parent, const ResourceFormat& format, uint64_t offset, uint64_t size);
+
+	Reference<Resource> parent;
+	uint64_t byteOffset;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_RESOURCEVIEW_H_ */
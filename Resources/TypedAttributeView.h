@@ -0,0 +1,183 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef UTIL_RESOURCES_TYPEDATTRIBUTEVIEW_H_
+#define UTIL_RESOURCES_TYPEDATTRIBUTEVIEW_H_
+
+#include "ResourceAccessor.h"
+#include "../TypeConstant.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Util {
+
+/** TypedAttributeView
+	Strided view of a single attribute with a statically known type and number of components.
+
+	The attribute format is checked once on construction. Afterwards, all accesses are plain
+	pointer arithmetic without any virtual dispatch or conversion, e.g.:
+	\code
+		TypedAttributeView<float,3> positions(accessor, StringIdentifier("position"));
+		for(float* p : positions)
+			p[1] += 1.0f;
+	\endcode
+	\note The view keeps a reference to the ResourceAccessor (and thereby to its resource).
+	@ingroup resources
+*/
+template<typename T, uint32_t N>
+class TypedAttributeView {
+	static_assert(std::is_arithmetic<T>::value, "TypedAttributeView requires a primitive type.");
+	static_assert(N > 0, "TypedAttributeView requires at least one component.");
+public:
+	using Value_t = T;
+	using Element_t = std::array<T,N>;
+	static constexpr uint32_t components = N;
+
+	//! Random access iterator over the elements. Dereferencing yields a pointer to the first component.
+	class Iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T*;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T**;
+		using reference = T*;
+
+		Iterator() = default;
+		Iterator(uint8_t* _ptr, uint64_t _stride) : ptr(_ptr), stride(_stride) {}
+
+		T* operator*() const { return reinterpret_cast<T*>(ptr); }
+		T* operator[](difference_type n) const { return reinterpret_cast<T*>(ptr + n*static_cast<difference_type>(stride)); }
+		Iterator& operator++() { ptr += stride; return *this; }
+		Iterator operator++(int) { Iterator tmp(*this); ptr += stride; return tmp; }
+		Iterator& operator--() { ptr -= stride; return *this; }
+		Iterator operator--(int) { Iterator tmp(*this); ptr -= stride; return tmp; }
+		Iterator& operator+=(difference_type n) { ptr += n*static_cast<difference_type>(stride); return *this; }
+		Iterator& operator-=(difference_type n) { ptr -= n*static_cast<difference_type>(stride); return *this; }
+		Iterator operator+(difference_type n) const { return Iterator(*this) += n; }
+		Iterator operator-(difference_type n) const { return Iterator(*this) -= n; }
+		difference_type operator-(const Iterator& o) const { return (ptr - o.ptr) / static_cast<difference_type>(stride); }
+		bool operator==(const Iterator& o) const { return ptr == o.ptr; }
+		bool operator!=(const Iterator& o) const { return ptr != o.ptr; }
+		bool operator<(const Iterator& o) const { return ptr < o.ptr; }
+		bool operator>(const Iterator& o) const { return ptr > o.ptr; }
+		bool operator<=(const Iterator& o) const { return ptr <= o.ptr; }
+		bool operator>=(const Iterator& o) const { return ptr >= o.ptr; }
+	private:
+		uint8_t* ptr = nullptr;
+		uint64_t stride = 0;
+	};
+
+	//! Returns @p true if the given attribute can be accessed by a view of this type.
+	static bool isCompatible(const AttributeFormat& attr) {
+		return attr.isValid() && attr.getDataType() == TypeConstantTrait<T>::value && attr.getComponentCount() == N
+			&& !attr.isNormalized() && attr.getInternalType() == 0;
+	}
+
+	TypedAttributeView() = default;
+
+	//! Creates a view of the attribute at the given @p location. Throws an std::invalid_argument exception if the attribute is not compatible.
+	TypedAttributeView(const ResourceAccessor::Ref& _accessor, uint32_t location) : accessor(_accessor) {
+		if(!accessor)
+			throw std::invalid_argument("TypedAttributeView: Invalid resource accessor.");
+		const auto& format = accessor->getFormat();
+		if(location >= format.getNumAttributes()) {
+			std::ostringstream s;
+			s << "TypedAttributeView: Invalid attribute location " << location << ".";
+			throw std::invalid_argument(s.str());
+		}
+		const auto& attr = format.getAttribute(location);
+		if(!isCompatible(attr)) {
+			std::ostringstream s;
+			s << "TypedAttributeView: Attribute '" << attr.toString() << "' does not match " << N << " " << getTypeString(TypeConstantTrait<T>::value) << ".";
+			throw std::invalid_argument(s.str());
+		}
+		dataPtr = accessor->_ptr<uint8_t>(0) + attr.getOffset();
+		stride = format.getSize();
+		elementCount = accessor->getElementCount();
+		if(reinterpret_cast<uintptr_t>(dataPtr) % alignof(T) != 0 || stride % alignof(T) != 0)
+			throw std::invalid_argument("TypedAttributeView: Attribute '" + attr.toString() + "' is not properly aligned.");
+	}
+
+	//! Creates a view of the attribute with the given name. Throws an std::invalid_argument exception if the attribute is not compatible.
+	TypedAttributeView(const ResourceAccessor::Ref& _accessor, const StringIdentifier& name) :
+		TypedAttributeView(_accessor, _accessor ? _accessor->getAttributeLocation(name) : 0) {}
+
+	//! Creates a view of the attribute with the given name of the resource. The resource stays mapped during the lifetime of the view.
+	TypedAttributeView(const ResourceRef& resource, const StringIdentifier& name) :
+		TypedAttributeView(ResourceAccessor::create(resource), name) {}
+
+	//! Unchecked access to the components of the element at the given index.
+	T* operator[](uint64_t index) const { return reinterpret_cast<T*>(dataPtr + index*stride); }
+
+	//! Checked access to the components of the element at the given index.
+	T* at(uint64_t index) const {
+		if(index >= elementCount) {
+			std::ostringstream s;
+			s << "Trying to access element at index " << index << " of overall " << elementCount << " elements.";
+			throw std::range_error(s.str());
+		}
+		return (*this)[index];
+	}
+
+	//! Unchecked copy of the element at the given index.
+	Element_t read(uint64_t index) const {
+		Element_t value;
+		const T* src = (*this)[index];
+		for(uint32_t c=0; c<N; ++c)
+			value[c] = src[c];
+		return value;
+	}
+
+	//! Unchecked write of the element at the given index.
+	void write(uint64_t index, const Element_t& value) const {
+		T* tgt = (*this)[index];
+		for(uint32_t c=0; c<N; ++c)
+			tgt[c] = value[c];
+	}
+
+	//! Returns a view of @p count elements starting at element @p first.
+	TypedAttributeView subview(uint64_t first, uint64_t count) const {
+		if(first > elementCount || count > elementCount - first) {
+			std::ostringstream s;
+			s << "Trying to create a view of elements [" << first << ", " << (first+count) << ") of overall " << elementCount << " elements.";
+			throw std::range_error(s.str());
+		}
+		TypedAttributeView view(*this);
+		view.dataPtr += first*stride;
+		view.elementCount = count;
+		return view;
+	}
+
+	Iterator begin() const { return Iterator(dataPtr, stride); }
+	Iterator end() const { return Iterator(dataPtr + elementCount*stride, stride); }
+
+	//! Returns @p true if all elements are tightly packed (i.e., the view can be used as a plain array of T).
+	bool isContiguous() const { return stride == sizeof(T)*N; }
+	T* data() const { return reinterpret_cast<T*>(dataPtr); }
+	uint64_t size() const { return elementCount; }
+	bool empty() const { return elementCount == 0; }
+	//! Returns the number of bytes between two consecutive elements.
+	uint64_t getStride() const { return stride; }
+	bool isValid() const { return dataPtr != nullptr; }
+	const ResourceAccessor::Ref& getAccessor() const { return accessor; }
+private:
+	ResourceAccessor::Ref accessor;
+	uint8_t* dataPtr = nullptr;
+	uint64_t stride = 0;
+	uint64_t elementCount = 0;
+};
+
+} /* Util */
+
+#endif /* end of include guard: UTIL_RESOURCES_TYPEDATTRIBUTEVIEW_H_ */
@@ -127,14 +127,13 @@ Reference<Bitmap> StreamerPNG::loadBitmap(std::istream & input) {
 		png_set_strip_16(png_ptr);
 	}
 
-	// Create the bitmap to store the data.
-	Reference<Bitmap> bitmap = new Bitmap(width, height, pixelFormat);
+	// Create the bitmap to store the data (every row is overwritten by the decoder).
+	Reference<Bitmap> bitmap = Bitmap::createUninitialized(width, height, pixelFormat);
 
 	auto row_pointers = new png_bytep[height];
-	const uint8_t bytes = pixelFormat.getBytesPerPixel();
 	for (uint_fast32_t row = 0; row < height; ++row) {
 		// Take over rows in the same order.
-		row_pointers[row] = reinterpret_cast<png_bytep>(bitmap->data() + row * width * bytes);
+		row_pointers[row] = reinterpret_cast<png_bytep>(bitmap->data() + row * bitmap->getPitch());
 	}
 
 	// This function automatically handles interlacing.
@@ -213,10 +212,9 @@ bool StreamerPNG::saveBitmap(const Bitmap & bitmap, std::ostream & output) {
 	// Write the image.
 	std::vector<png_bytep> row_pointers;
 	row_pointers.reserve(height);
-	const uint8_t bytes = pixelFormat.getDataSize();
 	for (uint_fast32_t row = 0; row < height; ++row) {
 		// Take over rows in the same order.
-		row_pointers.push_back(reinterpret_cast<png_bytep>(const_cast<uint8_t *>(bitmap.data()) + row * width * bytes));
+		row_pointers.push_back(reinterpret_cast<png_bytep>(const_cast<uint8_t *>(bitmap.data()) + row * bitmap.getPitch()));
 	}
 	png_set_rows(png_ptr, info_ptr, row_pointers.data());
 
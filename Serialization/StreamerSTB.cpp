@@ -73,11 +73,8 @@ Reference<Bitmap> StreamerSTB::loadBitmap(std::istream & input) {
 
 	Util::AttributeFormat pixelFormat({"rgba"}, type, components, normalized);
 
-	// Create the bitmap to store the data.
-	Reference<Bitmap> bitmap = new Bitmap(width, height, pixelFormat);
-	std::copy(img, img + bitmap->getDataSize(), bitmap->data());	
-	stbi_image_free(img);
-	return bitmap;
+	// The bitmap takes over the decoded data.
+	return Bitmap::createFromData(width, height, pixelFormat, img, 0, [](uint8_t * data) { stbi_image_free(data); });
 }
 
 struct WriteContext {
@@ -96,7 +93,7 @@ bool StreamerSTB::saveBitmap(const Bitmap & bitmap, std::ostream & output) {
 	int components = bitmap.getHeight();
 	const int width = bitmap.getWidth();
 	const int height = bitmap.getHeight();
-	const int stride = pixelFormat.getDataSize() * width;
+	const int stride = static_cast<int>(bitmap.getPitch());
 	if(pixelFormat == PixelFormat::RGBA) {
 		components = 4;
 	} else if(pixelFormat == PixelFormat::BGRA) {
@@ -127,8 +124,8 @@ bool StreamerHDR::saveBitmap(const Bitmap & bitmap, std::ostream & output) {
 	int components = pixelFormat.getComponentCount();
 	const int width = bitmap.getWidth();
 	const int height = bitmap.getHeight();
-	const int stride = pixelFormat.getDataSize() * width;
-	if(pixelFormat.getDataType() != TypeConstant::FLOAT) {
+	if(pixelFormat.getDataType() != TypeConstant::FLOAT || !bitmap.isPacked()) {
+		// the HDR writer expects packed rows of floats
 		AttributeFormat newFormat(pixelFormat.getNameId(), TypeConstant::FLOAT, components, false);
 		Reference<Bitmap> tmp = BitmapUtils::convertBitmap(bitmap, newFormat);
 		return saveBitmap(*tmp.get(), output);
@@ -9,7 +9,7 @@
 #include "TypeConstant.h"
 #include <stdexcept>
 
-static const uint8_t byteSizes[] = { 1,2,4,8,1,2,4,8,4,8,2,4 };
+static const uint8_t byteSizes[] = { 1,2,4,8,1,2,4,8,4,8,2,4,2 };
 	
 uint8_t Util::getNumBytes(TypeConstant t){
 	const uint8_t index = static_cast<uint8_t>(t);
@@ -32,6 +32,7 @@ std::string Util::getTypeString(TypeConstant t) {
 		case TypeConstant::DOUBLE: return "double";
 		case TypeConstant::HALF: return "half";
 		case TypeConstant::BOOL: return "bool";
+		case TypeConstant::BFLOAT16: return "bfloat16";
 		default: return "";
 	}
 }
\ No newline at end of file
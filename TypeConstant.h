@@ -32,7 +32,8 @@ enum class TypeConstant : uint8_t{
 	FLOAT	= 8,
 	DOUBLE = 9,
 	HALF = 10,
-	BOOL = 11
+	BOOL = 11,
+	BFLOAT16 = 12
 };
 
 //---------------------
@@ -50,6 +51,7 @@ inline bool isFloatType(Util::TypeConstant type) {
 		case Util::TypeConstant::FLOAT:
 		case Util::TypeConstant::DOUBLE:
 		case Util::TypeConstant::HALF:
+		case Util::TypeConstant::BFLOAT16:
 			return true;
 		default: return false;
 	}
@@ -81,6 +83,21 @@ inline bool isUnsignedIntegerType(Util::TypeConstant type) {
 	}
 }
 
+//---------------------
+
+//! Maps a primitive type to its TypeConstant, e.g., TypeConstantTrait<float>::value == TypeConstant::FLOAT
+template<typename T> struct TypeConstantTrait;
+template<> struct TypeConstantTrait<uint8_t> { static constexpr TypeConstant value = TypeConstant::UINT8; };
+template<> struct TypeConstantTrait<uint16_t> { static constexpr TypeConstant value = TypeConstant::UINT16; };
+template<> struct TypeConstantTrait<uint32_t> { static constexpr TypeConstant value = TypeConstant::UINT32; };
+template<> struct TypeConstantTrait<uint64_t> { static constexpr TypeConstant value = TypeConstant::UINT64; };
+template<> struct TypeConstantTrait<int8_t> { static constexpr TypeConstant value = TypeConstant::INT8; };
+template<> struct TypeConstantTrait<int16_t> { static constexpr TypeConstant value = TypeConstant::INT16; };
+template<> struct TypeConstantTrait<int32_t> { static constexpr TypeConstant value = TypeConstant::INT32; };
+template<> struct TypeConstantTrait<int64_t> { static constexpr TypeConstant value = TypeConstant::INT64; };
+template<> struct TypeConstantTrait<float> { static constexpr TypeConstant value = TypeConstant::FLOAT; };
+template<> struct TypeConstantTrait<double> { static constexpr TypeConstant value = TypeConstant::DOUBLE; };
+
 //! @}
 	
 }
@@ -230,7 +230,7 @@ static GLFWcursor * convertBitmapToglfwCursor(const Reference<Bitmap> & image, u
 	if(image == nullptr)
 		throw std::invalid_argument("No bitmap given.");	
 	Reference<Bitmap> converted = image;
-	if(image->getPixelFormat() != PixelFormat::RGBA)
+	if(image->getPixelFormat() != PixelFormat::RGBA || !image->isPacked())
 		converted = BitmapUtils::convertBitmap(*image.get(), PixelFormat::RGBA);	
 	GLFWimage glfwImage;
 	glfwImage.width = static_cast<int>(image->getWidth());
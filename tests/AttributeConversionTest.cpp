@@ -0,0 +1,358 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "Resources/AttributeConversion.h"
+#include "Resources/AttributeAccessor.h"
+#include "Resources/ResourceFormat.h"
+#include "Resources/QuantizedAttribute.h"
+#include "Resources/ResourceConverter.h"
+#include "Utils.h"
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+template<typename T>
+static std::vector<T> createAllValues() {
+	std::vector<T> values;
+	for(int64_t v = std::numeric_limits<T>::min(); v <= std::numeric_limits<T>::max(); ++v)
+		values.push_back(static_cast<T>(v));
+	values.push_back(std::numeric_limits<T>::max()); // odd count to test the scalar tail
+	return values;
+}
+
+static std::vector<float> createFloatValues() {
+	std::vector<float> values{0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.0f, -2.0f, 1e-10f, -1e-10f,
+		std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+		std::numeric_limits<float>::quiet_NaN(), std::nextafter(1.0f, 0.0f), std::nextafter(-1.0f, 0.0f)};
+	for(uint32_t i=0; i<=65535; ++i)
+		values.push_back(static_cast<float>(i) / 65535.0f);
+	std::default_random_engine engine;
+	std::uniform_real_distribution<float> distribution(-1.2f, 1.2f);
+	for(uint32_t i=0; i<100001; ++i)
+		values.push_back(distribution(engine));
+	return values;
+}
+
+static bool bitwiseEqual(const std::vector<float>& a, const std::vector<float>& b) {
+	return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+TEST_CASE("AttributeConversionTest_testNormalize", "[AttributeConversionTest]") {
+	INFO("Kernel: " << Util::AttributeConversion::getKernelName());
+	{
+		const auto values = createAllValues<uint8_t>();
+		std::vector<float> result(values.size()), expected(values.size());
+		Util::AttributeConversion::normalizeUnsigned(values.data(), result.data(), values.size());
+		for(size_t i=0; i<values.size(); ++i)
+			expected[i] = Util::unnormalizeUnsigned<float>(Util::normalizeUnsigned<uint8_t>(values[i]));
+		REQUIRE(bitwiseEqual(result, expected));
+	}
+	{
+		const auto values = createAllValues<uint16_t>();
+		std::vector<float> result(values.size()), expected(values.size());
+		Util::AttributeConversion::normalizeUnsigned(values.data(), result.data(), values.size());
+		for(size_t i=0; i<values.size(); ++i)
+			expected[i] = Util::unnormalizeUnsigned<float>(Util::normalizeUnsigned<uint16_t>(values[i]));
+		REQUIRE(bitwiseEqual(result, expected));
+	}
+	{
+		const auto values = createAllValues<int8_t>();
+		std::vector<float> result(values.size()), expected(values.size());
+		Util::AttributeConversion::normalizeSigned(values.data(), result.data(), values.size());
+		for(size_t i=0; i<values.size(); ++i)
+			expected[i] = Util::unnormalizeSigned<float>(Util::normalizeSigned<int8_t>(values[i]));
+		REQUIRE(bitwiseEqual(result, expected));
+	}
+	{
+		const auto values = createAllValues<int16_t>();
+		std::vector<float> result(values.size()), expected(values.size());
+		Util::AttributeConversion::normalizeSigned(values.data(), result.data(), values.size());
+		for(size_t i=0; i<values.size(); ++i)
+			expected[i] = Util::unnormalizeSigned<float>(Util::normalizeSigned<int16_t>(values[i]));
+		REQUIRE(bitwiseEqual(result, expected));
+	}
+}
+
+template<typename T>
+static void testUnnormalizeUnsigned(const std::vector<float>& values) {
+	std::vector<T> result(values.size()), expected(values.size());
+	Util::AttributeConversion::unnormalizeUnsigned(values.data(), result.data(), values.size());
+	for(size_t i=0; i<values.size(); ++i)
+		expected[i] = Util::unnormalizeUnsigned<T>(Util::normalizeUnsigned<float>(values[i]));
+	REQUIRE(result == expected);
+}
+
+template<typename T>
+static void testUnnormalizeSigned(const std::vector<float>& values) {
+	std::vector<T> result(values.size()), expected(values.size());
+	Util::AttributeConversion::unnormalizeSigned(values.data(), result.data(), values.size());
+	for(size_t i=0; i<values.size(); ++i)
+		expected[i] = Util::unnormalizeSigned<T>(Util::normalizeSigned<float>(values[i]));
+	REQUIRE(result == expected);
+}
+
+TEST_CASE("AttributeConversionTest_testUnnormalize", "[AttributeConversionTest]") {
+	INFO("Kernel: " << Util::AttributeConversion::getKernelName());
+	const auto values = createFloatValues();
+	testUnnormalizeUnsigned<uint8_t>(values);
+	testUnnormalizeUnsigned<uint16_t>(values);
+	testUnnormalizeSigned<int8_t>(values);
+	testUnnormalizeSigned<int16_t>(values);
+}
+
+static uint16_t toHalf(float value) {
+	uint16_t result;
+	Util::AttributeConversion::floatToHalf(&value, &result, 1); // single values use the scalar code
+	return result;
+}
+
+TEST_CASE("AttributeConversionTest_testShuffle", "[AttributeConversionTest]") {
+	INFO("Kernel: " << Util::AttributeConversion::getShuffleKernelName());
+	std::default_random_engine engine;
+	std::uniform_int_distribution<uint32_t> distribution(0, 255);
+	// RGB -> BGRA, RGBA -> BGR, RGBA -> MONO, MONO -> RGBA, RG -> RGB, 16 byte elements
+	const std::vector<std::pair<uint32_t, std::vector<int8_t>>> patterns{
+		{3, {2, 1, 0, -1}}, {4, {2, 1, 0}}, {4, {0}}, {1, {0, -1, -1, -1}}, {2, {1, 0, -1}},
+		{16, {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0}}
+	};
+	for(const auto& entry : patterns) {
+		const uint32_t sourceStride = entry.first;
+		const auto& pattern = entry.second;
+		const uint32_t targetStride = static_cast<uint32_t>(pattern.size());
+		std::vector<uint8_t> fill(targetStride);
+		for(auto& f : fill)
+			f = static_cast<uint8_t>(distribution(engine));
+		for(uint64_t count : {0, 1, 5, 17, 64, 1001}) {
+			std::vector<uint8_t> source(count * sourceStride);
+			for(auto& v : source)
+				v = static_cast<uint8_t>(distribution(engine));
+			std::vector<uint8_t> expected(count * targetStride);
+			for(uint64_t i=0; i<count; ++i)
+				for(uint32_t c=0; c<targetStride; ++c)
+					expected[i*targetStride + c] = pattern[c] < 0 ? fill[c] : source[i*sourceStride + pattern[c]];
+			std::vector<uint8_t> target(count * targetStride + 1, 42);
+			Util::AttributeConversion::shuffleBytes(source.data(), sourceStride, target.data(), targetStride, count, pattern.data(), fill.data());
+			REQUIRE(target.back() == 42); // nothing is written behind the range
+			target.pop_back();
+			REQUIRE(target == expected);
+		}
+	}
+}
+
+TEST_CASE("AttributeConversionTest_testFloat16", "[AttributeConversionTest]") {
+	INFO("Kernel: " << Util::AttributeConversion::getFloat16KernelName());
+	// half -> float is exact, and converting back yields the original value
+	std::vector<uint16_t> halfs;
+	for(uint32_t i=0; i<=65535; ++i)
+		halfs.push_back(static_cast<uint16_t>(i));
+	halfs.push_back(0x3c00);
+	std::vector<float> floats(halfs.size());
+	Util::AttributeConversion::halfToFloat(halfs.data(), floats.data(), halfs.size());
+	std::vector<uint16_t> result(halfs.size());
+	Util::AttributeConversion::floatToHalf(floats.data(), result.data(), floats.size());
+	for(size_t i=0; i<halfs.size(); ++i) {
+		const uint32_t exponent = (halfs[i] >> 10) & 0x1f;
+		const uint32_t mantissa = halfs[i] & 0x3ff;
+		if(exponent == 0x1f && mantissa != 0) {
+			REQUIRE(std::isnan(floats[i]));
+			REQUIRE(result[i] == (halfs[i] | 0x200)); // quieted NaN
+			continue;
+		}
+		const float magnitude = exponent == 0x1f ? std::numeric_limits<float>::infinity() :
+			(exponent == 0 ? std::ldexp(static_cast<float>(mantissa), -24) : std::ldexp(static_cast<float>(mantissa | 0x400), static_cast<int>(exponent) - 25));
+		REQUIRE(floats[i] == ((halfs[i] & 0x8000) ? -magnitude : magnitude));
+		REQUIRE(result[i] == halfs[i]);
+	}
+
+	// rounding (to nearest even) and range
+	REQUIRE(toHalf(1.0f) == 0x3c00);
+	REQUIRE(toHalf(-2.0f) == 0xc000);
+	REQUIRE(toHalf(65504.0f) == 0x7bff);
+	REQUIRE(toHalf(65519.0f) == 0x7bff);
+	REQUIRE(toHalf(65520.0f) == 0x7c00);
+	REQUIRE(toHalf(1e10f) == 0x7c00);
+	REQUIRE(toHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3c00); // tie -> even
+	REQUIRE(toHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3c02); // tie -> even
+	REQUIRE(toHalf(std::ldexp(1.0f, -24)) == 0x0001);
+	REQUIRE(toHalf(std::ldexp(1.0f, -25)) == 0x0000); // tie -> even
+	REQUIRE(toHalf(std::ldexp(1.5f, -25)) == 0x0001);
+	REQUIRE(toHalf(std::ldexp(1.0f, -30)) == 0x0000);
+	REQUIRE(toHalf(-std::ldexp(1.0f, -30)) == 0x8000);
+
+	// the bulk kernels match the scalar code
+	const auto values = createFloatValues();
+	std::vector<float> scaled(values);
+	for(size_t i=0; i<scaled.size(); ++i)
+		scaled[i] *= std::ldexp(1.0f, static_cast<int>(i % 40) - 20);
+	std::vector<uint16_t> bulk(scaled.size()), expected(scaled.size());
+	Util::AttributeConversion::floatToHalf(scaled.data(), bulk.data(), scaled.size());
+	for(size_t i=0; i<scaled.size(); ++i)
+		Util::AttributeConversion::floatToHalf(&scaled[i], &expected[i], 1);
+	REQUIRE(bulk == expected);
+	Util::AttributeConversion::floatToBfloat16(scaled.data(), bulk.data(), scaled.size());
+	for(size_t i=0; i<scaled.size(); ++i)
+		Util::AttributeConversion::floatToBfloat16(&scaled[i], &expected[i], 1);
+	REQUIRE(bulk == expected);
+
+	// bfloat16
+	std::vector<float> bfloats(halfs.size());
+	Util::AttributeConversion::bfloat16ToFloat(halfs.data(), bfloats.data(), halfs.size());
+	Util::AttributeConversion::floatToBfloat16(bfloats.data(), result.data(), bfloats.size());
+	for(size_t i=0; i<halfs.size(); ++i) {
+		uint32_t bits;
+		std::memcpy(&bits, &bfloats[i], sizeof(bits));
+		REQUIRE(bits == static_cast<uint32_t>(halfs[i]) << 16);
+		REQUIRE(result[i] == (std::isnan(bfloats[i]) ? (halfs[i] | 0x40) : halfs[i]));
+	}
+	const float bfloatValues[] = {1.0f, 1.0f + std::ldexp(1.0f, -8), 1.0f + 3.0f * std::ldexp(1.0f, -8), 1.0f + 1.5f * std::ldexp(1.0f, -8)};
+	uint16_t bfloatResult[4];
+	Util::AttributeConversion::floatToBfloat16(bfloatValues, bfloatResult, 4);
+	REQUIRE(bfloatResult[0] == 0x3f80);
+	REQUIRE(bfloatResult[1] == 0x3f80); // tie -> even
+	REQUIRE(bfloatResult[2] == 0x3f82); // tie -> even
+	REQUIRE(bfloatResult[3] == 0x3f81);
+}
+
+TEST_CASE("AttributeConversionTest_testFloat16Accessor", "[AttributeConversionTest]") {
+	using namespace Util;
+	for(auto type : {TypeConstant::HALF, TypeConstant::BFLOAT16}) {
+		ResourceFormat format;
+		const auto& attr = format.appendAttribute({"color"}, type, 3, false);
+		format.appendAttribute({"id"}, TypeConstant::UINT32, 1, false);
+		REQUIRE(getNumBytes(type) == 2);
+		REQUIRE(attr.getDataSize() == 6);
+		REQUIRE(AttributeAccessor::hasAccessor(attr));
+
+		const uint64_t count = 300;
+		std::vector<uint8_t> data(format.getSize() * count);
+		auto acc = AttributeAccessor::create(data.data(), data.size(), format, {"color"});
+		REQUIRE(acc);
+		std::vector<double> values(count * 3);
+		for(size_t i=0; i<values.size(); ++i)
+			values[i] = static_cast<double>(i) * 0.25 - 100.0;
+		acc->writeRange(0, count, values.data());
+		std::vector<float> floats(count * 4, 42.0f);
+		acc->readRange(0, count, floats.data(), 4);
+		for(uint64_t i=0; i<count; ++i) {
+			for(uint32_t c=0; c<3; ++c)
+				REQUIRE(floats[i*4+c] == Approx(values[i*3+c]).epsilon(0.01));
+			REQUIRE(floats[i*4+3] == 42.0f);
+		}
+		acc->writeValues(7, std::vector<int32_t>{1, -2, 3}.data(), 3);
+		REQUIRE(acc->readValues<float>(7) == std::vector<float>{1.0f, -2.0f, 3.0f});
+	}
+}
+
+TEST_CASE("AttributeConversionTest_testQuantized", "[AttributeConversionTest]") {
+	using namespace Util;
+	std::default_random_engine engine;
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	const uint64_t count = 1000;
+
+	ResourceFormat format;
+	QuantizedAttribute::appendOctahedral(format, {"normal"}, TypeConstant::INT16);
+	QuantizedAttribute::appendOctahedral(format, {"normal8"}, TypeConstant::INT8);
+	QuantizedAttribute::appendSnorm10_10_10_2(format, {"tangent"});
+	QuantizedAttribute::appendUnorm10_10_10_2(format, {"color"});
+	const uint32_t fixedPointType = hash32("AttributeConversionTest_FixedPoint");
+	QuantizedAttribute::registerFixedPoint(fixedPointType, {-10.0f, 0.0f, 5.0f}, {10.0f, 1.0f, 6.0f});
+	QuantizedAttribute::appendFixedPoint(format, {"position"}, fixedPointType, TypeConstant::UINT16, 3);
+	REQUIRE(format.getSize() == 4 + 2 + 4 + 4 + 6);
+
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto normal = AttributeAccessor::create(data.data(), data.size(), format, {"normal"});
+	auto normal8 = AttributeAccessor::create(data.data(), data.size(), format, {"normal8"});
+	auto tangent = AttributeAccessor::create(data.data(), data.size(), format, {"tangent"});
+	auto color = AttributeAccessor::create(data.data(), data.size(), format, {"color"});
+	auto position = AttributeAccessor::create(data.data(), data.size(), format, {"position"});
+	REQUIRE(normal->getValueCount() == 3);
+	REQUIRE(normal8->getValueCount() == 3);
+	REQUIRE(tangent->getValueCount() == 4);
+	REQUIRE(position->getValueCount() == 3);
+
+	std::vector<float> normals(count * 3), tangents(count * 4), colors(count * 4), positions(count * 3);
+	for(uint64_t i=0; i<count; ++i) {
+		float* n = normals.data() + i*3;
+		do {
+			for(uint32_t c=0; c<3; ++c)
+				n[c] = distribution(engine);
+		} while(n[0]*n[0] + n[1]*n[1] + n[2]*n[2] < 0.01f);
+		const float length = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+		for(uint32_t c=0; c<3; ++c) {
+			n[c] /= length;
+			tangents[i*4+c] = n[c];
+			colors[i*4+c] = std::abs(n[c]);
+		}
+		tangents[i*4+3] = i % 2 ? 1.0f : -1.0f;
+		colors[i*4+3] = 1.0f;
+		positions[i*3+0] = distribution(engine) * 10.0f;
+		positions[i*3+1] = distribution(engine) * 0.5f + 0.5f;
+		positions[i*3+2] = distribution(engine) * 0.5f + 5.5f;
+	}
+	normal->writeRange(0, count, normals.data());
+	normal8->writeRange(0, count, normals.data());
+	tangent->writeRange(0, count, tangents.data());
+	color->writeRange(0, count, colors.data());
+	position->writeRange(0, count, positions.data());
+
+	std::vector<float> result(count * 4);
+	normal->readRange(0, count, result.data(), 4);
+	for(uint64_t i=0; i<count; ++i)
+		for(uint32_t c=0; c<3; ++c)
+			REQUIRE(result[i*4+c] == Approx(normals[i*3+c]).margin(1e-4));
+	normal8->readRange(0, count, result.data(), 3);
+	for(uint64_t i=0; i<count*3; ++i)
+		REQUIRE(result[i] == Approx(normals[i]).margin(0.02));
+	tangent->readRange(0, count, result.data());
+	for(uint64_t i=0; i<count*4; ++i)
+		REQUIRE(result[i] == Approx(tangents[i]).margin(1.0 / 511.0));
+	color->readRange(0, count, result.data());
+	for(uint64_t i=0; i<count*4; ++i)
+		REQUIRE(result[i] == Approx(colors[i]).margin(0.5 / 1023.0 + 1e-6));
+	position->readRange(0, count, result.data());
+	for(uint64_t i=0; i<count*3; ++i)
+		REQUIRE(result[i] == Approx(positions[i]).margin(20.0 / 65535.0));
+
+	// single values (through readValues<float>) and partial writes
+	const auto n = normal->readValues<float>(7);
+	REQUIRE(n.size() == 3);
+	REQUIRE(n[2] == Approx(normals[7*3+2]).margin(1e-4));
+	REQUIRE(tangent->readValues<float>(3).size() == 4);
+	tangent->writeValues(3, std::vector<double>{0.0, 1.0}.data(), 2);
+	const auto t = tangent->readValues<float>(3);
+	REQUIRE(t[0] == 0.0f);
+	REQUIRE(t[1] == 1.0f);
+	REQUIRE(t[2] == Approx(tangents[3*4+2]).margin(1.0 / 511.0));
+	REQUIRE(t[3] == 1.0f);
+	position->writeValue(0, 100.0f); // clamped to the range
+	REQUIRE(position->readValue<float>(0) == 10.0f);
+
+	// octahedral encoding handles the poles and both hemispheres
+	const float axes[] = {0,0,1, 0,0,-1, 1,0,0, -1,0,0, 0,1,0, 0,-1,0};
+	int16_t encoded[12];
+	float decoded[18];
+	AttributeConversion::encodeOctahedral(axes, reinterpret_cast<uint8_t*>(encoded), TypeConstant::INT16, 6);
+	AttributeConversion::decodeOctahedral(reinterpret_cast<const uint8_t*>(encoded), TypeConstant::INT16, decoded, 6);
+	for(uint32_t i=0; i<18; ++i)
+		REQUIRE(decoded[i] == Approx(axes[i]).margin(1e-6));
+
+	// conversion to a plain float format
+	ResourceFormat floatFormat;
+	floatFormat.appendFloat({"normal"}, 3);
+	floatFormat.appendFloat({"tangent"}, 4);
+	const auto converter = ResourceConverter::compile(format, floatFormat);
+	std::vector<float> converted(count * 7);
+	converter->convert(data.data(), reinterpret_cast<uint8_t*>(converted.data()), count);
+	REQUIRE(converted[10*7+2] == Approx(normals[10*3+2]).margin(1e-4));
+	REQUIRE(converted[10*7+6] == tangents[10*4+3]);
+}
@@ -0,0 +1,531 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "Graphics/Bitmap.h"
+#include "Graphics/BitmapUtils.h"
+#include "Graphics/PixelAccessor.h"
+#include "Graphics/PixelFormat.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+TEST_CASE("BitmapUtilsTest_testPixelRows", "[BitmapUtilsTest]") {
+	using namespace Util;
+	const uint32_t width = 37;
+	const uint32_t height = 5;
+	for(const auto& pixelFormat : {PixelFormat::RGBA, PixelFormat::BGRA, PixelFormat::RGB_FLOAT, PixelFormat::MONO, PixelFormat::RGBA_HALF, PixelFormat::R11G11B10_FLOAT}) {
+		Reference<Bitmap> bitmap = new Bitmap(width, height, pixelFormat);
+		Reference<PixelAccessor> pixels = PixelAccessor::create(bitmap);
+		REQUIRE(pixels->getRowStride() == width * pixelFormat.getDataSize());
+		REQUIRE(pixels->_rowPtr(2) == bitmap->data() + 2 * pixels->getRowStride());
+		std::vector<Color4f> row(width);
+		for(uint32_t y=0; y<height; ++y) {
+			for(uint32_t x=0; x<width; ++x)
+				row[x] = Color4f(x / 64.0f, y / 8.0f, 0.5f, 0.25f);
+			pixels->writeRow(y, 0, width, row.data());
+		}
+		// rows and single pixels are consistent
+		std::vector<Color4f> colors(width - 3);
+		std::vector<Color4ub> bytes(width - 3);
+		for(uint32_t y=0; y<height; ++y) {
+			pixels->readRow(y, 3, width - 3, colors.data());
+			pixels->readRow(y, 3, width - 3, bytes.data());
+			for(uint32_t x=3; x<width; ++x) {
+				REQUIRE(colors[x-3] == pixels->readColor4f(x, y));
+				REQUIRE(bytes[x-3] == pixels->readColor4ub(x, y));
+				REQUIRE(colors[x-3].r() == Approx(x / 64.0f).margin(0.01));
+			}
+		}
+		pixels->writeRow(1, 10, 2, bytes.data());
+		REQUIRE(pixels->readColor4ub(11, 1) == bytes[1]);
+	}
+
+	// BitmapUtils on top of the row accessors
+	Reference<Bitmap> mono = new Bitmap(width, height, PixelFormat::MONO_FLOAT);
+	BitmapUtils::alterBitmap(*mono.get(), [](const BitmapUtils::BitmapAlteringContext& ctxt) { return Color4f(static_cast<float>(ctxt.x + ctxt.y), 0, 0, 0); });
+	BitmapUtils::normalizeBitmap(*mono.get());
+	auto expanded = BitmapUtils::expandChannels(*mono.get(), 4);
+	Reference<PixelAccessor> expandedPixels = PixelAccessor::create(expanded);
+	const float maxValue = static_cast<float>(width - 1 + height - 1);
+	for(uint32_t y=0; y<height; ++y) {
+		for(uint32_t x=0; x<width; ++x) {
+			const float value = (x + y) / maxValue;
+			REQUIRE(expandedPixels->readColor4f(x, y) == Color4f(value, value, value, 1.0f));
+		}
+	}
+	auto blended = BitmapUtils::blendTogether(PixelFormat::RGBA_FLOAT, {expanded, expanded});
+	REQUIRE(PixelAccessor::create(blended)->readColor4f(5, 3).r() == Approx((5 + 3) / maxValue));
+}
+
+TEST_CASE("BitmapUtilsTest_testBitmapUtilsThreads", "[BitmapUtilsTest]") {
+	using namespace Util;
+	// large enough to be split into several tiles and threads; the results do not depend on the number of threads
+	const uint32_t width = 301;
+	const uint32_t height = 517;
+	Reference<Bitmap> source = new Bitmap(width, height, PixelFormat::RGBA_FLOAT);
+	BitmapUtils::alterBitmap(*source.get(), [](const BitmapUtils::BitmapAlteringContext& ctxt) {
+		return Color4f(static_cast<float>(ctxt.x % 17) * 0.3f, static_cast<float>(ctxt.y), 0.1f * static_cast<float>(ctxt.x ^ ctxt.y), 2.0f);
+	}, 1);
+	const auto equal = [](const Reference<Bitmap>& a, const Reference<Bitmap>& b) {
+		return a->getDataSize() == b->getDataSize() && std::equal(a->data(), a->data() + a->getDataSize(), b->data());
+	};
+
+	std::vector<Reference<Bitmap>> results;
+	for(uint32_t threads : {1u, 4u}) {
+		// op reads the original values of the neighboring pixel, independent of the processing order
+		Reference<Bitmap> altered = new Bitmap(*source.get());
+		BitmapUtils::alterBitmap(*altered.get(), [](const BitmapUtils::BitmapAlteringContext& ctxt) {
+			return ctxt.pixels->readColor4f(ctxt.x, ctxt.y > 0 ? ctxt.y - 1 : 0) + Color4f(1.0f, 0.0f, 0.0f, 0.0f);
+		}, threads);
+		Reference<PixelAccessor> pixels = PixelAccessor::create(altered);
+		REQUIRE(pixels->readColor4f(3, 10).g() == 9.0f);
+		REQUIRE(pixels->readColor4f(3, 10).r() == Approx(1.9f));
+
+		Reference<Bitmap> normalized = new Bitmap(*source.get());
+		BitmapUtils::normalizeBitmap(*normalized.get(), threads);
+		REQUIRE(PixelAccessor::create(normalized)->readColor4f(0, height - 1).g() == 1.0f);
+
+		results.push_back(altered);
+		results.push_back(normalized);
+		results.push_back(BitmapUtils::blendTogether(PixelFormat::RGBA_FLOAT, {source, altered, normalized}, threads));
+		results.push_back(BitmapUtils::combineInterleaved(PixelFormat::RGBA, {source, altered, normalized, source}, threads));
+		results.push_back(BitmapUtils::expandChannels(*BitmapUtils::convertBitmap(*source.get(), PixelFormat::MONO_FLOAT).get(), 3, threads));
+	}
+	const size_t count = results.size() / 2;
+	for(size_t i=0; i<count; ++i)
+		REQUIRE(equal(results[i], results[i + count]));
+}
+
+TEST_CASE("BitmapUtilsTest_testBitmapStorage", "[BitmapUtilsTest]") {
+	using namespace Util;
+	const auto isAligned = [](const uint8_t* ptr) { return reinterpret_cast<uintptr_t>(ptr) % Bitmap::DATA_ALIGNMENT == 0; };
+
+	Reference<Bitmap> packed = new Bitmap(5, 4, PixelFormat::RGB);
+	REQUIRE(isAligned(packed->data()));
+	REQUIRE(packed->isPacked());
+	REQUIRE(packed->getPitch() == 15);
+	REQUIRE(std::all_of(packed->data(), packed->data() + packed->getDataSize(), [](uint8_t v) { return v == 0; }));
+
+	// padded rows
+	REQUIRE_THROWS_AS(Bitmap::createUninitialized(5, 4, PixelFormat::RGB, 20), std::invalid_argument); // no multiple of the pixel size
+	REQUIRE_THROWS_AS(Bitmap::createUninitialized(5, 4, PixelFormat::RGB, 12), std::invalid_argument); // too small
+	Reference<Bitmap> padded = Bitmap::createUninitialized(5, 4, PixelFormat::RGB, 21);
+	REQUIRE(isAligned(padded->data()));
+	REQUIRE(!padded->isPacked());
+	REQUIRE(padded->getDataSize() == 3 * 21 + 15);
+	Reference<PixelAccessor> pixels = PixelAccessor::create(padded);
+	REQUIRE(pixels->getRowStride() == 21);
+	for(uint32_t y=0; y<4; ++y)
+		for(uint32_t x=0; x<5; ++x)
+			pixels->writeColor(x, y, Color4ub(static_cast<uint8_t>(x), static_cast<uint8_t>(y), 7, 255));
+	REQUIRE(padded->data()[2 * 21 + 3 * 3 + 0] == 3);
+	REQUIRE(padded->data()[2 * 21 + 3 * 3 + 1] == 2);
+	REQUIRE(pixels->_rowPtr(2) == padded->data() + 42);
+
+	auto converted = BitmapUtils::convertBitmap(*padded.get(), PixelFormat::RGBA);
+	REQUIRE(converted->isPacked());
+	Reference<PixelAccessor> convertedPixels = PixelAccessor::create(converted);
+	Reference<Bitmap> copy = new Bitmap(*padded.get());
+	REQUIRE(copy->isPacked());
+	copy->flipVertically();
+	Reference<PixelAccessor> copyPixels = PixelAccessor::create(copy);
+	for(uint32_t y=0; y<4; ++y) {
+		for(uint32_t x=0; x<5; ++x) {
+			REQUIRE(convertedPixels->readColor4ub(x, y) == pixels->readColor4ub(x, y));
+			REQUIRE(copyPixels->readColor4ub(x, 3 - y) == pixels->readColor4ub(x, y));
+		}
+	}
+
+	// external data
+	std::vector<float> external(2 * 8, 0.5f);
+	uint32_t released = 0;
+	{
+		Reference<Bitmap> adopted = Bitmap::createFromData(3, 2, PixelFormat::RG_FLOAT, reinterpret_cast<uint8_t*>(external.data()), 8 * sizeof(float),
+			[&](uint8_t* data) { REQUIRE(data == reinterpret_cast<uint8_t*>(external.data())); ++released; });
+		REQUIRE(adopted->getDataSize() == (8 + 6) * sizeof(float));
+		PixelAccessor::create(adopted)->writeColor(1, 1, Color4f(2.0f, 3.0f, 0.0f, 0.0f));
+		REQUIRE(external[8 + 2] == 2.0f);
+		REQUIRE(external[8 + 3] == 3.0f);
+		REQUIRE(released == 0);
+	}
+	REQUIRE(released == 1);
+	{
+		Reference<Bitmap> borrowed = Bitmap::createFromData(2, 2, PixelFormat::RGBA_FLOAT, reinterpret_cast<uint8_t*>(external.data()));
+		REQUIRE(PixelAccessor::create(borrowed)->readColor4f(1, 0) == Color4f(0.5f, 0.5f, 0.5f, 0.5f));
+		std::vector<uint8_t> data(borrowed->getDataSize(), 1);
+		borrowed->swapData(data); // the bitmap takes over the vector; the external data is copied
+		REQUIRE(data.size() == borrowed->getDataSize());
+		REQUIRE(data[0] == reinterpret_cast<uint8_t*>(external.data())[0]);
+		REQUIRE(borrowed->data()[5] == 1);
+		borrowed->setData(std::vector<uint8_t>(borrowed->getDataSize(), 2));
+		REQUIRE(borrowed->data()[5] == 2);
+	}
+	REQUIRE(external[0] == 0.5f);
+
+	// a vector taken over by swapData is handed back without copying
+	Reference<Bitmap> swapped = new Bitmap(4, 4, PixelFormat::RGBA);
+	std::vector<uint8_t> first(swapped->getDataSize(), 1);
+	std::vector<uint8_t> second(swapped->getDataSize(), 2);
+	const uint8_t* firstData = first.data();
+	const uint8_t* secondData = second.data();
+	swapped->swapData(first); // the allocated data is copied
+	REQUIRE(swapped->data() == firstData);
+	REQUIRE(first[0] == 0);
+	swapped->swapData(second);
+	REQUIRE(swapped->data() == secondData);
+	REQUIRE(second.data() == firstData);
+	REQUIRE(second[0] == 1);
+}
+
+TEST_CASE("BitmapUtilsTest_testBitmapView", "[BitmapUtilsTest]") {
+	using namespace Util;
+	Reference<Bitmap> atlas = new Bitmap(16, 12, PixelFormat::RGBA);
+	Reference<PixelAccessor> atlasPixels = PixelAccessor::create(atlas);
+	for(uint32_t y=0; y<12; ++y)
+		for(uint32_t x=0; x<16; ++x)
+			atlasPixels->writeColor(x, y, Color4ub(static_cast<uint8_t>(x), static_cast<uint8_t>(y), 0, 255));
+
+	REQUIRE_THROWS_AS(atlas->createView(10, 0, 7, 4), std::range_error);
+	REQUIRE_THROWS_AS(atlas->createView(0, 12, 1, 1), std::range_error);
+	REQUIRE_THROWS_AS(Reference<Bitmap>(new Bitmap(4, 4, static_cast<size_t>(64)))->createView(0, 0, 1, 1), std::invalid_argument);
+
+	Reference<Bitmap> view = atlas->createView(4, 2, 5, 3);
+	REQUIRE(view->getParent() == atlas.get());
+	REQUIRE(view->data() == atlas->data() + 2 * 64 + 4 * 4);
+	REQUIRE(view->getPitch() == atlas->getPitch());
+	REQUIRE(!view->isPacked());
+	REQUIRE(view->getDataSize() == 2 * 64 + 5 * 4);
+
+	// reading and writing through the view
+	Reference<PixelAccessor> viewPixels = PixelAccessor::create(view);
+	REQUIRE(viewPixels->readColor4ub(1, 2) == Color4ub(5, 4, 0, 255));
+	viewPixels->writeColor(4, 2, Color4ub(1, 2, 3, 4));
+	REQUIRE(atlasPixels->readColor4ub(8, 4) == Color4ub(1, 2, 3, 4));
+	Reference<Bitmap> subView = view->createView(1, 1, 2, 2);
+	REQUIRE(subView->getParent() == view.get());
+	PixelAccessor::create(subView)->fill(0, 0, 2, 2, Color4ub(9, 9, 9, 9));
+	REQUIRE(atlasPixels->readColor4ub(5, 3) == Color4ub(9, 9, 9, 9));
+	REQUIRE(atlasPixels->readColor4ub(6, 4) == Color4ub(9, 9, 9, 9));
+	REQUIRE(atlasPixels->readColor4ub(7, 4) == Color4ub(7, 4, 0, 255));
+
+	// BitmapUtils and copies only use the pixels of the view
+	BitmapUtils::alterBitmap(*view.get(), [](const BitmapUtils::BitmapAlteringContext & ctx) {
+		return Color4f(ctx.pixels->readColor4f(ctx.x, ctx.y).getR(), 0.0f, 0.0f, 1.0f);
+	});
+	REQUIRE(atlasPixels->readColor4ub(3, 2) == Color4ub(3, 2, 0, 255));
+	REQUIRE(atlasPixels->readColor4ub(4, 2) == Color4ub(4, 0, 0, 255));
+	REQUIRE(atlasPixels->readColor4ub(8, 4) == Color4ub(1, 0, 0, 255));
+	REQUIRE(atlasPixels->readColor4ub(9, 4) == Color4ub(9, 4, 0, 255));
+	REQUIRE(atlasPixels->readColor4ub(4, 5) == Color4ub(4, 5, 0, 255));
+	auto converted = BitmapUtils::convertBitmap(*view.get(), PixelFormat::RGB);
+	Reference<Bitmap> copy = new Bitmap(*view.get());
+	REQUIRE(copy->isPacked());
+	REQUIRE(copy->getParent() == nullptr);
+	Reference<PixelAccessor> convertedPixels = PixelAccessor::create(converted);
+	Reference<PixelAccessor> copyPixels = PixelAccessor::create(copy);
+	for(uint32_t y=0; y<3; ++y) {
+		for(uint32_t x=0; x<5; ++x) {
+			REQUIRE(convertedPixels->readColor4ub(x, y) == viewPixels->readColor4ub(x, y));
+			REQUIRE(copyPixels->readColor4ub(x, y) == viewPixels->readColor4ub(x, y));
+		}
+	}
+	view->flipVertically();
+	REQUIRE(atlasPixels->readColor4ub(4, 2) == Color4ub(4, 0, 0, 255));
+	REQUIRE(atlasPixels->readColor4ub(4, 4) == copyPixels->readColor4ub(0, 0));
+	REQUIRE(atlasPixels->readColor4ub(4, 5) == Color4ub(4, 5, 0, 255));
+
+	// setData and swapData leave the pixels outside of the view untouched
+	view->setData(std::vector<uint8_t>(view->getDataSize(), 7));
+	REQUIRE(atlasPixels->readColor4ub(8, 3) == Color4ub(7, 7, 7, 7));
+	REQUIRE(atlasPixels->readColor4ub(9, 3) == Color4ub(9, 3, 0, 255));
+	std::vector<uint8_t> data(view->getDataSize(), 5);
+	view->swapData(data);
+	REQUIRE(view->data() == atlas->data() + 2 * 64 + 4 * 4);
+	REQUIRE(data[0] == 7);
+	REQUIRE(atlasPixels->readColor4ub(4, 3) == Color4ub(5, 5, 5, 5));
+	REQUIRE(atlasPixels->readColor4ub(3, 3) == Color4ub(3, 3, 0, 255));
+
+	// the view keeps its parent alive
+	atlasPixels = nullptr;
+	atlas = nullptr;
+	REQUIRE(PixelAccessor::create(subView)->readColor4ub(0, 0) == Color4ub(5, 5, 5, 5));
+
+	// the view keeps the pixel data alive when its parent replaces the data
+	std::vector<uint8_t> external(4 * 4 * 4, 3);
+	uint32_t released = 0;
+	Reference<Bitmap> source = Bitmap::createFromData(4, 4, PixelFormat::RGBA, external.data(), 0, [&](uint8_t*) { ++released; });
+	Reference<Bitmap> corner = source->createView(2, 2, 2, 2);
+	std::vector<uint8_t> replacement(source->getDataSize(), 5);
+	source->swapData(replacement); // copied, as the view refers to the data
+	REQUIRE(corner->data() == source->data() + 2 * 16 + 2 * 4);
+	REQUIRE(replacement[0] == 3);
+	REQUIRE(external[0] == 5);
+	Reference<Bitmap> other = new Bitmap(1, 1, PixelFormat::RGBA);
+	source->swap(*other.get());
+	other = nullptr; // owned the external data after the swap
+	REQUIRE(released == 0);
+	REQUIRE(PixelAccessor::create(corner)->readColor4ub(1, 1) == Color4ub(5, 5, 5, 5));
+	corner = nullptr;
+	REQUIRE(released == 1);
+}
+
+TEST_CASE("BitmapUtilsTest_testMipmaps", "[BitmapUtilsTest]") {
+	using namespace Util;
+	using BitmapUtils::MipmapFilter;
+	REQUIRE_THROWS_AS(BitmapUtils::generateMipmaps(Bitmap(4, 4, static_cast<size_t>(64))), std::invalid_argument);
+	REQUIRE_THROWS_AS(BitmapUtils::generateMipmaps(Bitmap(4, 4, AttributeFormat({"color"}, TypeConstant::BOOL, 4, false))), std::invalid_argument);
+
+	// level sizes and the contiguous storage
+	Reference<Bitmap> source = new Bitmap(10, 6, PixelFormat::RGBA);
+	Reference<PixelAccessor> sourcePixels = PixelAccessor::create(source);
+	for(uint32_t y=0; y<6; ++y)
+		for(uint32_t x=0; x<10; ++x)
+			sourcePixels->writeColor(x, y, Color4ub(static_cast<uint8_t>(x * 20), static_cast<uint8_t>(y * 40), static_cast<uint8_t>((x + y) % 2 * 255), 255));
+	auto levels = BitmapUtils::generateMipmaps(*source.get());
+	const std::vector<std::pair<uint32_t, uint32_t>> sizes = {{10, 6}, {5, 3}, {2, 1}, {1, 1}};
+	REQUIRE(levels.size() == sizes.size());
+	for(size_t l=0; l<levels.size(); ++l) {
+		REQUIRE(levels[l]->getWidth() == sizes[l].first);
+		REQUIRE(levels[l]->getHeight() == sizes[l].second);
+		REQUIRE(levels[l]->getPixelFormat() == PixelFormat::RGBA);
+		REQUIRE(reinterpret_cast<uintptr_t>(levels[l]->data()) % Bitmap::DATA_ALIGNMENT == 0);
+		if(l > 0)
+			REQUIRE(levels[l]->data() == levels[l - 1]->data() + (levels[l - 1]->getDataSize() + 63) / 64 * 64);
+	}
+	REQUIRE(std::equal(levels[0]->data(), levels[0]->data() + levels[0]->getDataSize(), source->data()));
+
+	// views are filtered like packed bitmaps
+	Reference<Bitmap> atlas = new Bitmap(14, 9, PixelFormat::RGBA);
+	Reference<Bitmap> view = atlas->createView(3, 2, 10, 6);
+	Reference<PixelAccessor> viewPixels = PixelAccessor::create(view);
+	for(uint32_t y=0; y<6; ++y)
+		for(uint32_t x=0; x<10; ++x)
+			viewPixels->writeColor(x, y, sourcePixels->readColor4ub(x, y));
+	auto viewLevels = BitmapUtils::generateMipmaps(*view.get(), MipmapFilter::LANCZOS);
+	auto packedLevels = BitmapUtils::generateMipmaps(*source.get(), MipmapFilter::LANCZOS);
+	for(size_t l=0; l<levels.size(); ++l)
+		REQUIRE(std::equal(viewLevels[l]->data(), viewLevels[l]->data() + viewLevels[l]->getDataSize(), packedLevels[l]->data()));
+
+	// the box filter averages 2x2 pixels for even sizes
+	Reference<PixelAccessor> level1 = PixelAccessor::create(levels[1]);
+	for(uint32_t y=0; y<3; ++y) {
+		for(uint32_t x=0; x<5; ++x) {
+			Color4f sum(0, 0, 0, 0);
+			for(uint32_t i=0; i<4; ++i)
+				sum = sum + sourcePixels->readColor4f(2 * x + i % 2, 2 * y + i / 2) * 0.25f;
+			const Color4f actual = level1->readColor4f(x, y);
+			REQUIRE(actual.r() == Approx(sum.r()).margin(0.5 / 255.0));
+			REQUIRE(actual.g() == Approx(sum.g()).margin(0.5 / 255.0));
+			REQUIRE(actual.b() == Approx(sum.b()).margin(0.5 / 255.0));
+			REQUIRE(actual.a() == Approx(sum.a()).margin(0.5 / 255.0));
+		}
+	}
+
+	// constant images stay constant with all filters and formats; the results do not depend on the number of threads
+	for(const auto & format : {PixelFormat::MONO, PixelFormat::RGB, PixelFormat::RGBA, PixelFormat::BGRA, PixelFormat::RGBA_FLOAT, PixelFormat::MONO_FLOAT}) {
+		Reference<Bitmap> constant = new Bitmap(67, 45, format);
+		Reference<PixelAccessor> constantPixels = PixelAccessor::create(constant);
+		constantPixels->fill(0, 0, 67, 45, Color4ub(200, 100, 50, 255));
+		for(auto filter : {MipmapFilter::BOX, MipmapFilter::TRIANGLE, MipmapFilter::KAISER, MipmapFilter::LANCZOS}) {
+			auto chain = BitmapUtils::generateMipmaps(*constant.get(), filter, true, 0.0f, 4);
+			auto singleThreaded = BitmapUtils::generateMipmaps(*constant.get(), filter, true, 0.0f, 1);
+			REQUIRE(chain.size() == 7);
+			for(size_t l=0; l<chain.size(); ++l)
+				REQUIRE(std::equal(chain[l]->data(), chain[l]->data() + chain[l]->getDataSize(), singleThreaded[l]->data()));
+			for(const auto & level : chain) {
+				Reference<PixelAccessor> pixels = PixelAccessor::create(level);
+				const Color4f color = pixels->readColor4f(level->getWidth() / 2, level->getHeight() - 1);
+				const Color4f expected = constantPixels->readColor4f(0, 0);
+				REQUIRE(color.r() == Approx(expected.r()).margin(0.005));
+				REQUIRE(color.g() == Approx(expected.g()).margin(0.005));
+				REQUIRE(color.b() == Approx(expected.b()).margin(0.005));
+				REQUIRE(color.a() == Approx(expected.a()).margin(0.005));
+			}
+		}
+	}
+
+	// sRGB: black and white average to 50% intensity in linear space (the conversion to bytes truncates)
+	Reference<Bitmap> checker = new Bitmap(2, 2, PixelFormat::RGBA);
+	Reference<PixelAccessor> checkerPixels = PixelAccessor::create(checker);
+	checkerPixels->writeColor(0, 0, Color4ub(255, 255, 255, 255));
+	checkerPixels->writeColor(1, 1, Color4ub(255, 255, 255, 255));
+	REQUIRE(PixelAccessor::create(BitmapUtils::generateMipmaps(*checker.get())[1])->readColor4ub(0, 0) == Color4ub(127, 127, 127, 127));
+	REQUIRE(PixelAccessor::create(BitmapUtils::generateMipmaps(*checker.get(), MipmapFilter::BOX, true)[1])->readColor4ub(0, 0) == Color4ub(187, 187, 187, 127));
+
+	// alpha coverage
+	const uint32_t size = 64;
+	Reference<Bitmap> foliage = new Bitmap(size, size, PixelFormat::RGBA);
+	Reference<PixelAccessor> foliagePixels = PixelAccessor::create(foliage);
+	for(uint32_t y=0; y<size; ++y)
+		for(uint32_t x=0; x<size; ++x)
+			foliagePixels->writeColor(x, y, Color4ub(0, 255, 0, ((x * 7919u + y * 104729u) ^ (x * y * 31u)) % 5 < 2 ? 255 : 0));
+	const auto getCoverage = [](const Reference<Bitmap> & bitmap) {
+		Reference<PixelAccessor> pixels = PixelAccessor::create(bitmap);
+		uint32_t covered = 0;
+		for(uint32_t y=0; y<bitmap->getHeight(); ++y)
+			for(uint32_t x=0; x<bitmap->getWidth(); ++x)
+				covered += pixels->readColor4f(x, y).a() > 0.5f ? 1 : 0;
+		return static_cast<float>(covered) / (bitmap->getWidth() * bitmap->getHeight());
+	};
+	const float coverage = getCoverage(foliage);
+	auto plain = BitmapUtils::generateMipmaps(*foliage.get(), MipmapFilter::TRIANGLE);
+	auto preserved = BitmapUtils::generateMipmaps(*foliage.get(), MipmapFilter::TRIANGLE, false, 0.5f);
+	REQUIRE(std::abs(getCoverage(plain[2]) - coverage) > 0.1f);
+	for(uint32_t l=1; l<5; ++l)
+		REQUIRE(std::abs(getCoverage(preserved[l]) - coverage) < 0.05f);
+	REQUIRE(PixelAccessor::create(preserved[3])->readColor4ub(3, 3).getG() == 255);
+
+	// packed formats are filtered per value, not per component
+	Reference<Bitmap> packed = new Bitmap(2, 2, PixelFormat::R11G11B10_FLOAT);
+	PixelAccessor::create(packed)->fill(0, 0, 2, 2, Color4f(0.5f, 0.25f, 0.75f, 1.0f));
+	const Color4f packedColor = PixelAccessor::create(BitmapUtils::generateMipmaps(*packed.get())[1])->readColor4f(0, 0);
+	REQUIRE(packedColor.getR() == Approx(0.5f));
+	REQUIRE(packedColor.getG() == Approx(0.25f));
+	REQUIRE(packedColor.getB() == Approx(0.75f));
+}
+
+//! Bilinear interpolation of each target pixel through the PixelAccessor (reference for resizeBitmap).
+static Util::Reference<Util::Bitmap> resizeBilinearPerPixel(const Util::Reference<Util::Bitmap>& source, uint32_t width, uint32_t height) {
+	using namespace Util;
+	Reference<Bitmap> target = new Bitmap(width, height, source->getPixelFormat());
+	Reference<PixelAccessor> sourcePixels = PixelAccessor::create(source);
+	Reference<PixelAccessor> targetPixels = PixelAccessor::create(target);
+	const float scaleX = static_cast<float>(source->getWidth()) / width;
+	const float scaleY = static_cast<float>(source->getHeight()) / height;
+	for(uint32_t y=0; y<height; ++y) {
+		const float sy = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+		const uint32_t y0 = std::min(static_cast<uint32_t>(sy), source->getHeight() - 1);
+		const uint32_t y1 = std::min(y0 + 1, source->getHeight() - 1);
+		for(uint32_t x=0; x<width; ++x) {
+			const float sx = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+			const uint32_t x0 = std::min(static_cast<uint32_t>(sx), source->getWidth() - 1);
+			const uint32_t x1 = std::min(x0 + 1, source->getWidth() - 1);
+			const float fx = sx - x0;
+			const float fy = sy - y0;
+			const Color4f top = sourcePixels->readColor4f(x0, y0) * (1.0f - fx) + sourcePixels->readColor4f(x1, y0) * fx;
+			const Color4f bottom = sourcePixels->readColor4f(x0, y1) * (1.0f - fx) + sourcePixels->readColor4f(x1, y1) * fx;
+			targetPixels->writeColor(x, y, top * (1.0f - fy) + bottom * fy);
+		}
+	}
+	return target;
+}
+
+static Util::Reference<Util::Bitmap> createTestImage(uint32_t width, uint32_t height, const Util::AttributeFormat& format) {
+	using namespace Util;
+	Reference<Bitmap> bitmap = new Bitmap(width, height, format);
+	Reference<PixelAccessor> pixels = PixelAccessor::create(bitmap);
+	for(uint32_t y=0; y<height; ++y)
+		for(uint32_t x=0; x<width; ++x)
+			pixels->writeColor(x, y, Color4ub(static_cast<uint8_t>(x * 7), static_cast<uint8_t>(y * 3), static_cast<uint8_t>((x * y) % 251), static_cast<uint8_t>(255 - x)));
+	return bitmap;
+}
+
+TEST_CASE("BitmapUtilsTest_testResize", "[BitmapUtilsTest]") {
+	using namespace Util;
+	using BitmapUtils::ResizeFilter;
+	REQUIRE_THROWS_AS(BitmapUtils::resizeBitmap(Bitmap(4, 4, static_cast<size_t>(64)), 2, 2), std::invalid_argument);
+	REQUIRE_THROWS_AS(BitmapUtils::resizeBitmap(Bitmap(4, 4, AttributeFormat({"color"}, TypeConstant::BOOL, 4, false)), 2, 2), std::invalid_argument);
+	REQUIRE_THROWS_AS(BitmapUtils::resizeBitmap(Bitmap(0, 4, PixelFormat::RGBA), 2, 2), std::invalid_argument);
+	REQUIRE(BitmapUtils::resizeBitmap(Bitmap(4, 4, PixelFormat::RGBA), 0, 3)->getHeight() == 3);
+	const auto equal = [](const Reference<Bitmap>& a, const Reference<Bitmap>& b) {
+		return a->getDataSize() == b->getDataSize() && std::equal(a->data(), a->data() + a->getDataSize(), b->data());
+	};
+	const auto maxDifference = [](const Reference<Bitmap>& a, const Reference<Bitmap>& b) {
+		Reference<PixelAccessor> pixelsA = PixelAccessor::create(a);
+		Reference<PixelAccessor> pixelsB = PixelAccessor::create(b);
+		float difference = 0.0f;
+		for(uint32_t y=0; y<a->getHeight(); ++y) {
+			for(uint32_t x=0; x<a->getWidth(); ++x) {
+				const Color4f ca = pixelsA->readColor4f(x, y);
+				const Color4f cb = pixelsB->readColor4f(x, y);
+				difference = std::max({difference, std::abs(ca.r() - cb.r()), std::abs(ca.g() - cb.g()), std::abs(ca.b() - cb.b()), std::abs(ca.a() - cb.a())});
+			}
+		}
+		return difference;
+	};
+
+	// nearest pixel
+	Reference<Bitmap> source = createTestImage(36, 20, PixelFormat::RGBA);
+	Reference<PixelAccessor> sourcePixels = PixelAccessor::create(source);
+	Reference<PixelAccessor> smaller = PixelAccessor::create(BitmapUtils::resizeBitmap(*source.get(), 18, 5, ResizeFilter::NEAREST));
+	Reference<PixelAccessor> larger = PixelAccessor::create(BitmapUtils::resizeBitmap(*source.get(), 72, 40, ResizeFilter::NEAREST));
+	for(uint32_t y=0; y<5; ++y)
+		for(uint32_t x=0; x<18; ++x)
+			REQUIRE(smaller->readColor4ub(x, y) == sourcePixels->readColor4ub(2 * x + 1, 4 * y + 2));
+	for(uint32_t y=0; y<40; ++y)
+		for(uint32_t x=0; x<72; ++x)
+			REQUIRE(larger->readColor4ub(x, y) == sourcePixels->readColor4ub(x / 2, y / 2));
+
+	// the same size keeps the pixels
+	Reference<Bitmap> floatSource = createTestImage(36, 20, PixelFormat::RGBA_FLOAT);
+	for(auto filter : {ResizeFilter::NEAREST, ResizeFilter::BILINEAR, ResizeFilter::BICUBIC, ResizeFilter::LANCZOS}) {
+		REQUIRE(equal(BitmapUtils::resizeBitmap(*floatSource.get(), 36, 20, filter), floatSource));
+		REQUIRE(maxDifference(BitmapUtils::resizeBitmap(*source.get(), 36, 20, filter), source) <= 1.0f / 255.0f);
+	}
+
+	// bilinear upsampling matches the interpolation of the neighboring pixels (the float image holds values up to 255)
+	REQUIRE(maxDifference(BitmapUtils::resizeBitmap(*floatSource.get(), 83, 47), resizeBilinearPerPixel(floatSource, 83, 47)) < 255.0f * 1.0e-5f);
+	REQUIRE(maxDifference(BitmapUtils::resizeBitmap(*source.get(), 83, 47), resizeBilinearPerPixel(source, 83, 47)) <= 1.0f / 255.0f);
+
+	// constant images stay constant; the results do not depend on the number of threads or the pitch of the source
+	for(const auto & format : {PixelFormat::MONO, PixelFormat::RGB, PixelFormat::BGRA, PixelFormat::RGB_HALF, PixelFormat::RGBA_FLOAT, PixelFormat::MONO_FLOAT}) {
+		Reference<Bitmap> atlas = new Bitmap(80, 60, format);
+		Reference<Bitmap> constant = atlas->createView(7, 9, 67, 45);
+		Reference<PixelAccessor> constantPixels = PixelAccessor::create(constant);
+		constantPixels->fill(0, 0, 67, 45, Color4ub(200, 100, 50, 255));
+		const Color4f expected = constantPixels->readColor4f(0, 0);
+		for(auto filter : {ResizeFilter::NEAREST, ResizeFilter::BILINEAR, ResizeFilter::BICUBIC, ResizeFilter::LANCZOS}) {
+			for(const auto & size : std::vector<std::pair<uint32_t, uint32_t>>{{23, 91}, {300, 7}, {1, 1}}) {
+				auto resized = BitmapUtils::resizeBitmap(*constant.get(), size.first, size.second, filter, 4);
+				REQUIRE(resized->getPixelFormat() == format);
+				REQUIRE(equal(resized, BitmapUtils::resizeBitmap(*Reference<Bitmap>(new Bitmap(*constant.get())).get(), size.first, size.second, filter, 1)));
+				Reference<PixelAccessor> pixels = PixelAccessor::create(resized);
+				const Color4f color = pixels->readColor4f(size.first - 1, size.second / 2);
+				REQUIRE(color.r() == Approx(expected.r()).margin(0.005));
+				REQUIRE(color.g() == Approx(expected.g()).margin(0.005));
+				REQUIRE(color.b() == Approx(expected.b()).margin(0.005));
+				REQUIRE(color.a() == Approx(expected.a()).margin(0.005));
+			}
+		}
+	}
+
+	// packed formats are filtered per value, not per component
+	Reference<Bitmap> packed = new Bitmap(4, 4, PixelFormat::R11G11B10_FLOAT);
+	PixelAccessor::create(packed)->fill(0, 0, 4, 4, Color4f(0.5f, 0.25f, 0.75f, 1.0f));
+	const Color4f packedColor = PixelAccessor::create(BitmapUtils::resizeBitmap(*packed.get(), 2, 2, ResizeFilter::BILINEAR))->readColor4f(1, 1);
+	REQUIRE(packedColor.getR() == Approx(0.5f));
+	REQUIRE(packedColor.getG() == Approx(0.25f));
+	REQUIRE(packedColor.getB() == Approx(0.75f));
+}
+
+TEST_CASE("BitmapUtilsTest_benchmarkResize", "[.][benchmark]") {
+	using namespace Util;
+	for(const auto & format : {PixelFormat::RGBA, PixelFormat::RGBA_FLOAT}) {
+		Reference<Bitmap> source = createTestImage(1024, 1024, format);
+		for(const auto & size : std::vector<std::pair<uint32_t, uint32_t>>{{1920, 1080}, {256, 256}}) {
+			Timer timer;
+			auto perPixel = resizeBilinearPerPixel(source, size.first, size.second);
+			const double perPixelTime = timer.getMilliseconds();
+			timer.reset();
+			auto resized = BitmapUtils::resizeBitmap(*source.get(), size.first, size.second, BitmapUtils::ResizeFilter::BILINEAR, 1);
+			const double resizeTime = timer.getMilliseconds();
+			timer.reset();
+			BitmapUtils::resizeBitmap(*source.get(), size.first, size.second, BitmapUtils::ResizeFilter::BILINEAR);
+			const double parallelTime = timer.getMilliseconds();
+			std::cout << format.toString() << " 1024x1024 -> " << size.first << "x" << size.second << ": PixelAccessor " << perPixelTime
+					  << " ms, resizeBitmap " << resizeTime << " ms (1 thread), " << parallelTime << " ms (default threads)" << std::endl;
+			REQUIRE(resized->getWidth() == perPixel->getWidth());
+		}
+	}
+}
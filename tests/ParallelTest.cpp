@@ -0,0 +1,47 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "Parallel.h"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ParallelTest_testParallelFor", "[ParallelTest]") {
+	using namespace Util;
+	// every index is visited exactly once
+	std::vector<std::atomic<uint32_t>> visits(10000);
+	for(auto& v : visits)
+		v = 0;
+	parallelFor(0, visits.size(), 1, [&](uint64_t begin, uint64_t end) {
+		for(uint64_t i = begin; i < end; ++i)
+			++visits[i];
+	}, 4);
+	for(auto& v : visits)
+		REQUIRE(v == 1);
+
+	// nested calls run on the same pool without deadlocking
+	std::atomic<uint64_t> sum(0);
+	for(uint32_t run = 0; run < 100; ++run) {
+		parallelFor(0, 8, 1, [&](uint64_t begin, uint64_t end) {
+			for(uint64_t i = begin; i < end; ++i) {
+				parallelFor(0, 100, 1, [&](uint64_t innerBegin, uint64_t innerEnd) {
+					sum += innerEnd - innerBegin;
+				}, 4);
+			}
+		}, 4);
+	}
+	REQUIRE(sum == 100 * 8 * 100);
+
+	// exceptions are rethrown on the calling thread
+	REQUIRE_THROWS_AS(parallelFor(0, 100, 1, [&](uint64_t begin, uint64_t) {
+		if(begin > 0)
+			throw std::runtime_error("error");
+	}, 4), std::runtime_error);
+}
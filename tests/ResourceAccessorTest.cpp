@@ -0,0 +1,459 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "Graphics/Bitmap.h"
+#include "Graphics/BitmapUtils.h"
+#include "Graphics/PixelAccessor.h"
+#include "Graphics/PixelFormat.h"
+#include "Resources/AttributeAccessor.h"
+#include "Resources/AttributeConversion.h"
+#include "Resources/ResourceAccessor.h"
+#include "Resources/ResourceConverter.h"
+#include "Resources/ResourceFormat.h"
+#include "Resources/ResourceLayoutConverter.h"
+#include "Resources/TypedAttributeView.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const Util::StringIdentifier POSITION("position");
+static const Util::StringIdentifier NORMAL("normal");
+static const Util::StringIdentifier COLOR("color");
+
+static Util::ResourceFormat createTestFormat() {
+	Util::ResourceFormat format;
+	format.appendFloat(POSITION, 3);
+	format.appendAttribute(NORMAL, Util::TypeConstant::INT8, 4, true);
+	format.appendAttribute(COLOR, Util::TypeConstant::UINT8, 4, true);
+	return format;
+}
+
+TEST_CASE("ResourceAccessorTest_testRange", "[ResourceAccessorTest]") {
+	const auto format = createTestFormat();
+	const uint64_t count = 100;
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto acc = Util::ResourceAccessor::create(data.data(), data.size(), format);
+
+	std::vector<float> positions(count * 3);
+	for(uint32_t i=0; i<positions.size(); ++i)
+		positions[i] = static_cast<float>(i) * 0.5f;
+	acc->writeRange(0, POSITION, count, positions.data());
+
+	// compare with per element access
+	for(uint64_t i=0; i<count; ++i) {
+		auto values = acc->readValues<float>(i, POSITION, 3);
+		REQUIRE(values[0] == positions[i*3+0]);
+		REQUIRE(values[1] == positions[i*3+1]);
+		REQUIRE(values[2] == positions[i*3+2]);
+	}
+
+	// strided read into a 4 component array with conversion
+	std::vector<double> strided(count * 4, -1.0);
+	acc->readRange(10, POSITION, 20, strided.data(), 4);
+	for(uint64_t i=0; i<20; ++i) {
+		REQUIRE(strided[i*4+0] == positions[(i+10)*3+0]);
+		REQUIRE(strided[i*4+2] == positions[(i+10)*3+2]);
+		REQUIRE(strided[i*4+3] == -1.0);
+	}
+
+	// normalized attributes
+	std::vector<float> colors(count * 4);
+	for(uint32_t i=0; i<colors.size(); ++i)
+		colors[i] = static_cast<float>(i % 256) / 255.0f;
+	acc->writeRange(0, acc->getAttributeLocation(COLOR), count, colors.data());
+	std::vector<float> colorsOut(count * 4);
+	acc->readRange(0, COLOR, count, colorsOut.data());
+	for(uint64_t i=0; i<count; ++i) {
+		std::vector<float> values(4);
+		acc->readValues(i, COLOR, values.data(), 4);
+		for(uint32_t c=0; c<4; ++c)
+			REQUIRE(values[c] == colorsOut[i*4+c]);
+	}
+
+	std::vector<float> normals(count * 4, -1.0f);
+	acc->writeRange(0, NORMAL, count, normals.data());
+	REQUIRE(acc->readValue<int8_t>(count-1, NORMAL) == -127);
+
+	// range checks
+	REQUIRE_THROWS_AS(acc->readRange(90, POSITION, 11, positions.data()), std::range_error);
+	REQUIRE_THROWS_AS(acc->writeRange(count, POSITION, 1, positions.data()), std::range_error);
+	REQUIRE_NOTHROW(acc->readRange(count, POSITION, 0, positions.data()));
+	// the end of the range must not wrap around
+	const uint64_t maxIndex = std::numeric_limits<uint64_t>::max();
+	REQUIRE_THROWS_AS(acc->readRange(maxIndex, POSITION, 2, positions.data()), std::range_error);
+	std::vector<uint8_t> raw(format.getSize() * 2);
+	REQUIRE_THROWS_AS(acc->readRaw(maxIndex, raw.data(), 2), std::range_error);
+	REQUIRE_THROWS_AS(acc->writeRaw(maxIndex, raw.data(), 2), std::range_error);
+	auto attrAcc = Util::AttributeAccessor::create(data.data(), data.size(), format, POSITION);
+	REQUIRE_THROWS_AS(attrAcc->readRange(maxIndex, 2, positions.data()), std::range_error);
+	REQUIRE_THROWS_AS(attrAcc->writeRange(maxIndex, 2, positions.data()), std::range_error);
+	REQUIRE_NOTHROW(attrAcc->readRange(count - 1, 1, positions.data()));
+}
+
+TEST_CASE("ResourceAccessorTest_testTypedAttributeView", "[ResourceAccessorTest]") {
+	const auto format = createTestFormat();
+	const uint64_t count = 50;
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto acc = Util::ResourceAccessor::create(data.data(), data.size(), format);
+
+	Util::TypedAttributeView<float,3> positions(acc, POSITION);
+	REQUIRE(positions.size() == count);
+	REQUIRE(positions.getStride() == format.getSize());
+	REQUIRE(!positions.isContiguous());
+
+	uint32_t i = 0;
+	for(float* p : positions) {
+		p[0] = static_cast<float>(i);
+		p[1] = static_cast<float>(i) * 2.0f;
+		p[2] = static_cast<float>(i) * 3.0f;
+		++i;
+	}
+	REQUIRE(i == count);
+	for(i=0; i<count; ++i) {
+		REQUIRE(acc->readValue<float>(i, POSITION) == static_cast<float>(i));
+		REQUIRE(positions[i][1] == static_cast<float>(i) * 2.0f);
+		REQUIRE(positions.read(i)[2] == static_cast<float>(i) * 3.0f);
+	}
+
+	auto sub = positions.subview(10, 5);
+	REQUIRE(sub.size() == 5);
+	REQUIRE(sub[0][0] == 10.0f);
+	REQUIRE(sub.end() - sub.begin() == 5);
+	REQUIRE_THROWS_AS(sub.at(5), std::range_error);
+	REQUIRE_THROWS_AS(positions.subview(45, 6), std::range_error);
+
+	// format mismatches
+	REQUIRE_THROWS_AS((Util::TypedAttributeView<float,4>(acc, POSITION)), std::invalid_argument);
+	REQUIRE_THROWS_AS((Util::TypedAttributeView<int8_t,4>(acc, NORMAL)), std::invalid_argument);
+	REQUIRE_THROWS_AS((Util::TypedAttributeView<float,3>(acc, Util::StringIdentifier("unknown"))), std::invalid_argument);
+}
+
+TEST_CASE("ResourceAccessorTest_testLayoutCache", "[ResourceAccessorTest]") {
+	const auto format = createTestFormat();
+	std::vector<uint8_t> data(format.getSize() * 10);
+	auto acc1 = Util::ResourceAccessor::create(data.data(), data.size(), format);
+	auto acc2 = Util::ResourceAccessor::create(data.data(), data.size(), createTestFormat());
+	REQUIRE(acc1->getLayout() == acc2->getLayout());
+	REQUIRE(acc1->getAttributeLocation(NORMAL) == 1);
+	REQUIRE(acc1->getAttributeLocation(Util::StringIdentifier("unknown")) == format.getNumAttributes());
+
+	Util::ResourceFormat otherFormat;
+	otherFormat.appendFloat(POSITION, 2);
+	auto acc3 = Util::ResourceAccessor::create(data.data(), data.size(), otherFormat);
+	REQUIRE(acc1->getLayout() != acc3->getLayout());
+	const size_t cacheSize = Util::ResourceLayout::getCacheSize();
+	acc3 = nullptr;
+	Util::ResourceLayout::trimCache();
+	REQUIRE(Util::ResourceLayout::getCacheSize() < cacheSize);
+	REQUIRE(Util::ResourceLayout::get(format) == acc1->getLayout());
+
+	// layouts remembered by other threads stay unique across trimming
+	Util::ResourceFormat threadFormat;
+	threadFormat.appendFloat(Util::StringIdentifier("thread"), 3);
+	std::mutex mutex;
+	std::condition_variable condition;
+	int step = 0;
+	const Util::ResourceLayout* before = nullptr;
+	const Util::ResourceLayout* after = nullptr;
+	std::thread worker([&] {
+		before = Util::ResourceLayout::get(threadFormat).get(); // only referenced as the last layout of this thread
+		std::unique_lock<std::mutex> lock(mutex);
+		step = 1;
+		condition.notify_all();
+		condition.wait(lock, [&] { return step == 2; });
+		after = Util::ResourceLayout::get(threadFormat).get();
+	});
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [&] { return step == 1; });
+		Util::ResourceLayout::trimCache();
+		CHECK(Util::ResourceLayout::get(threadFormat).get() == before);
+		step = 2;
+		condition.notify_all();
+	}
+	worker.join();
+	REQUIRE(after == before);
+
+	// formats with more attributes than the inline accessor slots
+	Util::ResourceFormat wideFormat;
+	for(uint32_t i=0; i<12; ++i)
+		wideFormat.appendUInt(Util::StringIdentifier("attr" + std::to_string(i)), 1);
+	std::vector<uint8_t> wideData(wideFormat.getSize() * 3);
+	auto wide = Util::ResourceAccessor::create(wideData.data(), wideData.size(), wideFormat);
+	for(uint32_t i=0; i<12; ++i)
+		wide->writeValue(2, i, i * 10);
+	auto wide2 = Util::ResourceAccessor::create(wideData.data(), wideData.size(), wideFormat);
+	for(uint32_t i=0; i<12; ++i)
+		REQUIRE(wide2->readValue<uint32_t>(2, Util::StringIdentifier("attr" + std::to_string(i))) == i * 10);
+}
+
+TEST_CASE("ResourceAccessorTest_testLayoutConverter", "[ResourceAccessorTest]") {
+	const auto format = createTestFormat();
+	const uint64_t count = 100000;
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto acc = Util::ResourceAccessor::create(data.data(), data.size(), format);
+	for(uint32_t i=0; i<count; ++i) {
+		acc->writeValues(i, POSITION, std::vector<float>{static_cast<float>(i), 1.0f, -static_cast<float>(i)});
+		acc->writeValues(i, NORMAL, std::vector<int8_t>{static_cast<int8_t>(i % 128), 0, -1, 127});
+		acc->writeValues(i, COLOR, std::vector<uint8_t>{static_cast<uint8_t>(i % 256), 1, 2, 255});
+	}
+
+	// interleaved -> planar
+	const auto planar = Util::ResourceLayoutConverter::createPlanarFormats(format);
+	REQUIRE(planar.size() == 3);
+	Util::ResourceLayoutConverter toPlanar({format}, planar);
+	REQUIRE(toPlanar.isCopyOnly());
+	std::vector<uint8_t> planarData(Util::ResourceLayoutConverter::getDataSize(planar, count));
+	REQUIRE(planarData.size() == data.size());
+	toPlanar.convert(data.data(), planarData.data(), count);
+	const float* positions = reinterpret_cast<const float*>(planarData.data());
+	const uint8_t* colors = planarData.data() + Util::ResourceLayoutConverter::getStreamOffset(planar, 2, count);
+	for(uint32_t i=0; i<count; i+=997) {
+		REQUIRE(positions[i*3+0] == static_cast<float>(i));
+		REQUIRE(positions[i*3+2] == -static_cast<float>(i));
+		REQUIRE(colors[i*4+0] == static_cast<uint8_t>(i % 256));
+		REQUIRE(colors[i*4+3] == 255);
+	}
+
+	// planar -> interleaved roundtrip
+	std::vector<uint8_t> interleaved(data.size());
+	Util::ResourceLayoutConverter(planar, {format}).convert(planarData.data(), interleaved.data(), count, 4);
+	REQUIRE(interleaved == data);
+
+	// type conversion (float3 -> double4, normalized int8 -> float)
+	Util::ResourceFormat tgtFormat;
+	tgtFormat.appendAttribute(POSITION, Util::TypeConstant::DOUBLE, 4);
+	tgtFormat.appendFloat(NORMAL, 4);
+	tgtFormat.appendFloat(Util::StringIdentifier("unknown"), 1);
+	Util::ResourceLayoutConverter converter(format, tgtFormat);
+	REQUIRE(!converter.isCopyOnly());
+	std::vector<uint8_t> converted(tgtFormat.getSize() * count);
+	converter.convert(data.data(), converted.data(), count);
+	auto tgtAcc = Util::ResourceAccessor::create(converted.data(), converted.size(), tgtFormat);
+	for(uint32_t i=0; i<count; i+=997) {
+		const auto position = tgtAcc->readValues<double>(i, POSITION, 4);
+		REQUIRE(position[0] == static_cast<double>(i));
+		REQUIRE(position[2] == -static_cast<double>(i));
+		REQUIRE(position[3] == 1.0);
+		REQUIRE(tgtAcc->readValues<float>(i, NORMAL, 4) == acc->readValues<float>(i, NORMAL, 4));
+	}
+
+	// the fast paths of ResourceConverter are used for streams as well (normalized uint8 -> float stream)
+	Util::ResourceFormat floatColors;
+	floatColors.appendFloat(COLOR, 4);
+	Util::ResourceLayoutConverter toFloatColors({format}, {floatColors});
+	std::vector<float> colorValues(4 * count);
+	toFloatColors.convert({data.data()}, {reinterpret_cast<uint8_t*>(colorValues.data())}, count);
+	for(uint32_t i=0; i<count; i+=997)
+		REQUIRE(std::vector<float>(colorValues.begin() + i*4, colorValues.begin() + i*4 + 4) == acc->readValues<float>(i, COLOR, 4));
+}
+
+TEST_CASE("ResourceAccessorTest_testOptimizedFormat", "[ResourceAccessorTest]") {
+	using namespace Util;
+	// formats of independent modules: the merged format contains the padding of the parts
+	ResourceFormat colorFormat;
+	colorFormat.appendAttribute(COLOR, TypeConstant::UINT16, 4, true);
+	colorFormat.setSize(16);
+	ResourceFormat format;
+	format.appendAttribute(NORMAL, TypeConstant::INT8, 3, true);
+	format.merge(colorFormat);
+	format.appendAttribute(POSITION, TypeConstant::DOUBLE, 3);
+	REQUIRE(format.getSize() == 3 + 16 + 24);
+
+	auto layout = format.optimized();
+	const auto& optimized = layout.format;
+	REQUIRE(optimized.getSize() == 24 + 8 + 3);
+	REQUIRE(layout.locations == std::vector<uint32_t>{2, 1, 0});
+	for(uint32_t location=0; location<format.getNumAttributes(); ++location) {
+		const auto& attr = optimized.getAttribute(layout.locations[location]);
+		REQUIRE(attr.getNameId() == format.getAttribute(location).getNameId());
+		REQUIRE(attr.getDataType() == format.getAttribute(location).getDataType());
+		REQUIRE(attr.getOffset() % getNumBytes(attr.getDataType()) == 0);
+	}
+
+	// alignment is kept
+	ResourceFormat alignedFormat(4);
+	alignedFormat.appendAttribute(NORMAL, TypeConstant::INT8, 3, true);
+	alignedFormat.appendAttribute(COLOR, TypeConstant::UINT16, 4, true);
+	alignedFormat.appendAttribute(POSITION, TypeConstant::DOUBLE, 3);
+	REQUIRE(alignedFormat.optimized().format.getSize() == 24 + 8 + 4);
+	REQUIRE(alignedFormat.optimized().format.getAlignment() == 4);
+
+	// narrowing
+	layout = format.optimized(ResourceFormat::NARROW_DOUBLE_TO_FLOAT | ResourceFormat::NARROW_NORMALIZED_TO_8BIT);
+	REQUIRE(layout.format.getSize() == 12 + 4 + 3);
+	REQUIRE(layout.format.getAttribute(POSITION).getDataType() == TypeConstant::FLOAT);
+	REQUIRE(layout.format.getAttribute(COLOR).getDataType() == TypeConstant::UINT8);
+	REQUIRE(format.optimized(ResourceFormat::NARROW_DOUBLE_TO_FLOAT | ResourceFormat::NARROW_FLOAT_TO_HALF).format.getAttribute(POSITION).getDataType() == TypeConstant::HALF);
+
+	// convert data with the layout converter
+	const uint64_t count = 1000;
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto acc = ResourceAccessor::create(data.data(), data.size(), format);
+	for(uint32_t i=0; i<count; ++i) {
+		acc->writeValues(i, POSITION, std::vector<double>{static_cast<double>(i), 0.5, -1.0});
+		acc->writeValues(i, COLOR, std::vector<float>{1.0f, 0.0f, 1.0f, 0.0f});
+	}
+	std::vector<uint8_t> converted(layout.format.getSize() * count);
+	ResourceLayoutConverter(format, layout.format).convert(data.data(), converted.data(), count);
+	auto tgtAcc = ResourceAccessor::create(converted.data(), converted.size(), layout.format);
+	for(uint32_t i=0; i<count; i+=97) {
+		REQUIRE(tgtAcc->readValues<float>(i, POSITION, 3) == std::vector<float>{static_cast<float>(i), 0.5f, -1.0f});
+		REQUIRE(tgtAcc->readValues<uint8_t>(i, COLOR, 4) == std::vector<uint8_t>{255, 0, 255, 0});
+	}
+}
+
+TEST_CASE("ResourceAccessorTest_testResourceConverter", "[ResourceAccessorTest]") {
+	const auto format = createTestFormat();
+	const uint64_t count = 1000;
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto acc = Util::ResourceAccessor::create(data.data(), data.size(), format);
+	for(uint32_t i=0; i<count; ++i) {
+		acc->writeValues(i, POSITION, std::vector<float>{static_cast<float>(i), 1.0f, 2.0f});
+		acc->writeValues(i, NORMAL, std::vector<float>{0.0f, -1.0f, 1.0f, 0.0f});
+		acc->writeValues(i, COLOR, std::vector<uint8_t>{static_cast<uint8_t>(i % 256), 1, 2, 3});
+	}
+
+	// packed target format with reordered attributes
+	Util::ResourceFormat tgtFormat;
+	tgtFormat.appendAttribute(COLOR, Util::TypeConstant::UINT8, 4, true);
+	tgtFormat.appendFloat(POSITION, 3);
+	tgtFormat.appendAttribute(NORMAL, Util::TypeConstant::INT16, 3, true);
+	auto converter = Util::ResourceConverter::compile(format, tgtFormat);
+	REQUIRE(converter == Util::ResourceConverter::compile(format, tgtFormat));
+	REQUIRE(!converter->isCopyOnly());
+	std::vector<uint8_t> converted(tgtFormat.getSize() * count);
+	converter->convert(data.data(), converted.data(), count);
+	auto tgtAcc = Util::ResourceAccessor::create(converted.data(), converted.size(), tgtFormat);
+	for(uint32_t i=0; i<count; ++i) {
+		REQUIRE(tgtAcc->readValues<float>(i, POSITION, 3) == acc->readValues<float>(i, POSITION, 3));
+		REQUIRE(tgtAcc->readValues<uint8_t>(i, COLOR, 4) == acc->readValues<uint8_t>(i, COLOR, 4));
+		REQUIRE(tgtAcc->readValues<int16_t>(i, NORMAL, 3) == std::vector<int16_t>{0, -32767, 32767});
+	}
+	REQUIRE(Util::ResourceConverter::compile(format, format)->isCopyOnly());
+
+	// pixel formats (swizzle and conversion)
+	Util::Reference<Util::Bitmap> bitmap = new Util::Bitmap(16, 8, Util::PixelFormat::BGRA);
+	Util::Reference<Util::PixelAccessor> pixels = Util::PixelAccessor::create(bitmap);
+	for(uint32_t y=0; y<8; ++y)
+		for(uint32_t x=0; x<16; ++x)
+			pixels->writeColor(x, y, Util::Color4ub(static_cast<uint8_t>(x), static_cast<uint8_t>(y), 100, 200));
+	for(const auto& pixelFormat : {Util::PixelFormat::RGBA, Util::PixelFormat::RGB_FLOAT, Util::PixelFormat::BGR}) {
+		auto converted = Util::BitmapUtils::convertBitmap(*bitmap.get(), pixelFormat);
+		Util::Reference<Util::PixelAccessor> convertedPixels = Util::PixelAccessor::create(converted);
+		for(uint32_t y=0; y<8; ++y) {
+			for(uint32_t x=0; x<16; ++x) {
+				const auto color = convertedPixels->readColor4f(x, y);
+				REQUIRE(color.r() == Approx(x / 255.0f));
+				REQUIRE(color.g() == Approx(y / 255.0f));
+				REQUIRE(color.b() == Approx(100 / 255.0f));
+				REQUIRE(color.a() == Approx(pixelFormat.getComponentCount() == 4 ? 200 / 255.0f : 1.0f));
+			}
+		}
+	}
+	REQUIRE(Util::ResourceConverter::compile(Util::PixelFormat::RGB, Util::PixelFormat::BGR_FLOAT)->isCopyOnly() == false);
+}
+
+TEST_CASE("ResourceAccessorTest_testPixelConversion", "[ResourceAccessorTest]") {
+	using namespace Util;
+	// the fast paths (shuffle, normalize) have to match the generic conversion through the accessors
+	const std::vector<AttributeFormat> formats{PixelFormat::RGBA, PixelFormat::BGRA, PixelFormat::RGB, PixelFormat::BGR, PixelFormat::RG,
+		PixelFormat::MONO, PixelFormat::RGBA_FLOAT, PixelFormat::BGRA_FLOAT, PixelFormat::RGB_FLOAT, PixelFormat::MONO_FLOAT};
+	const uint32_t width = 37, height = 5;
+	const uint64_t count = width * height;
+	for(const auto& srcFormat : formats) {
+		Reference<Bitmap> source = new Bitmap(width, height, srcFormat);
+		Reference<PixelAccessor> pixels = PixelAccessor::create(source);
+		for(uint32_t y=0; y<height; ++y)
+			for(uint32_t x=0; x<width; ++x)
+				pixels->writeColor(x, y, Color4f((x * 7 % 256) / 255.0f, y / 4.0f, x * 1.3f - 0.2f, (x % 3) * 0.5f));
+		for(const auto& tgtFormat : formats) {
+			INFO(srcFormat.toString() << " -> " << tgtFormat.toString());
+			auto converted = BitmapUtils::convertBitmap(*source.get(), tgtFormat);
+
+			std::vector<uint8_t> expected(converted->getDataSize());
+			auto srcAcc = AttributeAccessor::create(source->data(), source->getDataSize(), srcFormat, srcFormat.getDataSize());
+			auto tgtAcc = AttributeAccessor::create(expected.data(), expected.size(), tgtFormat, tgtFormat.getDataSize());
+			std::vector<uint64_t> buffer;
+			AttributeConversion::convertRange(*srcAcc.get(), *tgtAcc.get(), 0, count, AttributeConversion::getIntermediateType(srcFormat, tgtFormat), buffer);
+			REQUIRE(std::vector<uint8_t>(converted->data(), converted->data() + converted->getDataSize()) == expected);
+		}
+	}
+}
+
+TEST_CASE("ResourceAccessorTest_testReductions", "[ResourceAccessorTest]") {
+	const auto format = createTestFormat();
+	const uint64_t count = 300003; // large enough to be split across threads; not a multiple of the block size
+	std::vector<uint8_t> data(format.getSize() * count);
+	auto acc = Util::ResourceAccessor::create(data.data(), data.size(), format);
+
+	std::vector<float> positions(count * 3);
+	for(uint64_t i=0; i<count; ++i) {
+		positions[i*3+0] = static_cast<float>(i % 1000) - 500.0f;
+		positions[i*3+1] = static_cast<float>(i % 7);
+		positions[i*3+2] = -static_cast<float>(i % 13) * 0.5f;
+	}
+	positions[12345*3+1] = std::numeric_limits<float>::quiet_NaN(); // ignored by the bounds
+	acc->writeRange(0, POSITION, count, positions.data());
+
+	for(uint32_t threads : {1u, 4u}) {
+		const auto bounds = acc->computeBounds(POSITION, threads);
+		REQUIRE(bounds.min == std::vector<double>{-500.0, 0.0, -6.0});
+		REQUIRE(bounds.max == std::vector<double>{499.0, 6.0, 0.0});
+
+		const auto range = acc->minMax(POSITION, 2, threads);
+		REQUIRE(range.first == -6.0);
+		REQUIRE(range.second == 0.0);
+
+		const auto sums = acc->sum(POSITION, threads);
+		double expected = 0;
+		for(uint64_t i=0; i<count; ++i)
+			expected += positions[i*3+2];
+		REQUIRE(sums.size() == 3);
+		REQUIRE(sums[2] == Approx(expected));
+		REQUIRE(std::isnan(sums[1]));
+
+		const auto bins = acc->histogram(POSITION, 7, 0.0, 7.0, 1, threads);
+		REQUIRE(bins.size() == 7);
+		uint64_t total = 0;
+		for(uint32_t b=0; b<7; ++b) {
+			const uint64_t expectedCount = count / 7 + (b < count % 7 ? 1 : 0) - (b == 12345 % 7 ? 1 : 0);
+			REQUIRE(bins[b] == expectedCount);
+			total += bins[b];
+		}
+		REQUIRE(total == count - 1);
+		std::vector<uint64_t> expectedBins(2, 0); // z in [-6,0]
+		for(uint64_t i=0; i<count; ++i)
+			++expectedBins[positions[i*3+2] < -3.0f ? 0 : 1];
+		REQUIRE(acc->histogramAuto(acc->getAttributeLocation(POSITION), 2, 2, threads) == expectedBins);
+		REQUIRE(acc->histogramAuto(POSITION, 2, 2, threads) == expectedBins);
+		REQUIRE(acc->histogram(acc->getAttributeLocation(POSITION), 2, -6, 0, 2) == expectedBins);
+
+		// generic reduction: number of elements with a negative x coordinate
+		const uint64_t negative = acc->reduce(acc->getAttributeLocation(POSITION), uint64_t(0), [](uint64_t& result, const double* values, uint64_t n) {
+			for(uint64_t i=0; i<n; ++i)
+				result += values[i*3] < 0 ? 1 : 0;
+		}, [](uint64_t& result, uint64_t partial) { result += partial; }, threads);
+		REQUIRE(negative == (count / 1000) * 500 + std::min<uint64_t>(count % 1000, 500));
+	}
+
+	// normalized attributes are reduced in their converted range
+	acc->writeValues(5, NORMAL, std::vector<float>{-1.0f, 1.0f, 0.0f, 0.5f});
+	const auto normalBounds = acc->computeBounds(NORMAL);
+	REQUIRE(normalBounds.min[0] == -1.0);
+	REQUIRE(normalBounds.max[1] == 1.0);
+	REQUIRE_THROWS_AS(acc->minMax(NORMAL, 4), std::range_error);
+}
@@ -0,0 +1,98 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "Resources/BuddyResourceAllocator.h"
+#include "Resources/LinearResourceAllocator.h"
+#include "Resources/PoolResourceAllocator.h"
+#include "Resources/ResourceFormat.h"
+#include <cstdint>
+#include <vector>
+
+using Allocation = Util::ResourceAllocator::Allocation;
+
+TEST_CASE("ResourceAllocatorTest_testLinear", "[ResourceAllocatorTest]") {
+	Util::LinearResourceAllocator allocator(1024);
+	auto a1 = allocator.allocate(100);
+	auto a2 = allocator.allocate(100, 64);
+	REQUIRE(a1.isValid());
+	REQUIRE(a2.isValid());
+	REQUIRE(a1.offset == 0);
+	REQUIRE(a2.offset == 128);
+	REQUIRE(!allocator.allocate(1000).isValid());
+	auto stats = allocator.getStatistics();
+	REQUIRE(stats.allocationCount == 2);
+	REQUIRE(stats.usedSize == 228);
+	REQUIRE(stats.requestedSize == 200);
+	REQUIRE(stats.largestFreeBlock == 1024 - 228);
+
+	// freeing all allocations resets the allocator
+	allocator.free(std::move(a1));
+	allocator.free(std::move(a2));
+	REQUIRE(allocator.getStatistics().usedSize == 0);
+	REQUIRE(allocator.getStatistics().peakUsedSize == 228);
+	REQUIRE(allocator.allocate(1000).offset == 0);
+}
+
+TEST_CASE("ResourceAllocatorTest_testPool", "[ResourceAllocatorTest]") {
+	Util::ResourceFormat format;
+	format.appendFloat(Util::StringIdentifier("position"), 3);
+	Util::PoolResourceAllocator allocator(format, 10, 4);
+	REQUIRE(allocator.getBlockSize() == format.getSize() * 10);
+	REQUIRE(allocator.getCapacity() == format.getSize() * 40);
+
+	std::vector<Allocation> allocations;
+	for(uint32_t i=0; i<4; ++i) {
+		allocations.emplace_back(allocator.allocate(format, 5));
+		REQUIRE(allocations.back().isValid());
+		REQUIRE(allocations.back().offset == i * allocator.getBlockSize());
+	}
+	REQUIRE(!allocator.allocate(format, 1).isValid());
+	REQUIRE(!allocator.allocate(format, 11).isValid());
+	REQUIRE(allocator.getStatistics().getInternalFragmentation() == Approx(0.5));
+
+	const uint64_t offset = allocations[2].offset;
+	allocator.free(std::move(allocations[2]));
+	auto a = allocator.allocate(1);
+	REQUIRE(a.offset == offset);
+	REQUIRE(allocator.getStatistics().allocationCount == 4);
+}
+
+TEST_CASE("ResourceAllocatorTest_testBuddy", "[ResourceAllocatorTest]") {
+	Util::BuddyResourceAllocator allocator(4096, 256);
+	auto a1 = allocator.allocate(300); // 512
+	auto a2 = allocator.allocate(100); // 256
+	auto a3 = allocator.allocate(1024);
+	REQUIRE(a1.isValid());
+	REQUIRE(a2.isValid());
+	REQUIRE(a3.isValid());
+	REQUIRE(a1.offset % 512 == 0);
+	REQUIRE(a3.offset % 1024 == 0);
+	REQUIRE(allocator.getStatistics().usedSize == 512 + 256 + 1024);
+	REQUIRE(!allocator.allocate(4096).isValid());
+
+	// non power of two alignment
+	auto a4 = allocator.allocate(100, 12);
+	REQUIRE(a4.isValid());
+	REQUIRE(a4.offset % 12 == 0);
+
+	// all blocks are merged again after freeing everything
+	allocator.free(std::move(a2));
+	allocator.free(std::move(a4));
+	allocator.free(std::move(a1));
+	allocator.free(std::move(a3));
+	auto stats = allocator.getStatistics();
+	REQUIRE(stats.usedSize == 0);
+	REQUIRE(stats.freeBlockCount == 1);
+	REQUIRE(stats.largestFreeBlock == 4096);
+	REQUIRE(stats.getExternalFragmentation() == 0.0);
+
+	// capacity is rounded down
+	Util::BuddyResourceAllocator allocator2(5000, 256);
+	REQUIRE(allocator2.getCapacity() == 4096);
+}
@@ -0,0 +1,281 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "IO/FileName.h"
+#include "IO/FileUtils.h"
+#include "IO/TemporaryDirectory.h"
+#include "Resources/MappedFileResource.h"
+#include "Resources/ResourceAccessor.h"
+#include "Resources/ResourceFormat.h"
+#include "Resources/ResourcePool.h"
+#include "Resources/ResourceView.h"
+#include <cstdint>
+#include <vector>
+
+static const Util::StringIdentifier POSITION("position");
+static const Util::StringIdentifier INDEX("index");
+
+//! Simple resource in main memory.
+class TestResource : public Util::Resource {
+public:
+	TestResource(const Util::ResourceFormat& format, uint64_t count) : Util::Resource(format), data(format.getSize() * count) { dataSize = data.size(); }
+	uint8_t* map() override { return data.data(); }
+	std::vector<uint8_t> data;
+};
+
+TEST_CASE("ResourceTest_testMappedFile", "[ResourceTest]") {
+	using Util::MappedFileResource;
+	Util::TemporaryDirectory tempDir("ResourceTest");
+	const Util::FileName file(tempDir.getPath().toString() + "data.bin");
+	Util::ResourceFormat format;
+	format.appendFloat(POSITION, 3);
+	format.appendUInt(INDEX, 1);
+	const uint64_t count = 10000;
+
+	{	// create and fill a new file
+		auto resource = MappedFileResource::create(file, format, count);
+		REQUIRE(resource);
+		REQUIRE(resource->getElementCount() == count);
+		resource->advise(MappedFileResource::AccessHint::Sequential);
+		auto acc = Util::ResourceAccessor::create(resource.get());
+		for(uint32_t i=0; i<count; ++i) {
+			acc->writeValues(i, POSITION, std::vector<float>{static_cast<float>(i), 0.0f, 1.0f});
+			acc->writeValue(i, INDEX, i);
+		}
+		resource->flush();
+	}
+	REQUIRE(Util::FileUtils::fileSize(file) == format.getSize() * count);
+
+	{	// map a sub region with an unaligned offset
+		const uint64_t first = 1000;
+		auto resource = MappedFileResource::open(file, format, MappedFileResource::AccessMode::ReadOnly, first * format.getSize(), 10 * format.getSize());
+		REQUIRE(resource);
+		REQUIRE(resource->getElementCount() == 10);
+		auto acc = Util::ResourceAccessor::create(resource.get());
+		for(uint32_t i=0; i<10; ++i) {
+			REQUIRE(acc->readValue<float>(i, POSITION) == static_cast<float>(first + i));
+			REQUIRE(acc->readValue<uint32_t>(i, INDEX) == first + i);
+		}
+		auto values = resource->download<uint32_t>(4);
+		REQUIRE(values[3] == first); // index attribute of the first element
+	}
+
+	{	// copy on write does not change the file
+		auto resource = MappedFileResource::open(file, format, MappedFileResource::AccessMode::CopyOnWrite);
+		REQUIRE(resource);
+		auto acc = Util::ResourceAccessor::create(resource.get());
+		acc->writeValue(0, INDEX, 42u);
+		REQUIRE(acc->readValue<uint32_t>(0, INDEX) == 42);
+	}
+	{
+		auto resource = MappedFileResource::open(file, format, MappedFileResource::AccessMode::ReadWrite);
+		REQUIRE(resource);
+		auto acc = Util::ResourceAccessor::create(resource.get());
+		REQUIRE(acc->readValue<uint32_t>(0, INDEX) == 0);
+		REQUIRE(acc->readValue<uint32_t>(count-1, INDEX) == count-1);
+		// uploads only write back the uploaded range
+		resource->upload(std::vector<uint32_t>{42}, 5 * format.getSize() + format.getAttribute(INDEX).getOffset());
+		resource->flush();
+	}
+	{
+		auto resource = MappedFileResource::open(file, format, MappedFileResource::AccessMode::ReadOnly);
+		REQUIRE(resource);
+		auto acc = Util::ResourceAccessor::create(resource.get());
+		REQUIRE(acc->readValue<uint32_t>(5, INDEX) == 42);
+		REQUIRE(acc->readValue<uint32_t>(6, INDEX) == 6);
+	}
+
+	// invalid regions
+	REQUIRE(!MappedFileResource::open(file, format, MappedFileResource::AccessMode::ReadOnly, format.getSize() * count, 1));
+	REQUIRE(!MappedFileResource::open(Util::FileName(tempDir.getPath().toString() + "missing.bin"), format));
+}
+
+TEST_CASE("ResourceTest_testDirtyRanges", "[ResourceTest]") {
+	using Range = Util::Resource::DirtyRange;
+	Util::ResourceFormat format;
+	format.appendFloat(POSITION, 3);
+	format.appendUInt(INDEX, 1);
+	Util::Reference<TestResource> resource = new TestResource(format, 100);
+	std::vector<uint8_t> bytes(64, 1);
+
+	// no tracking by default
+	resource->upload(bytes.data(), 16, 0);
+	REQUIRE(!resource->hasDirtyRanges());
+
+	resource->setDirtyTracking(true);
+	resource->upload(bytes.data(), 16, 32);
+	resource->upload(bytes.data(), 16, 0);
+	resource->upload(bytes.data(), 16, 16); // adjacent to both ranges
+	resource->upload(bytes.data(), 8, 100);
+	REQUIRE(resource->consumeDirtyRanges() == std::vector<Range>{{0, 48}, {100, 8}});
+	REQUIRE(!resource->hasDirtyRanges());
+
+	// writes through an accessor only mark the written attribute
+	auto acc = Util::ResourceAccessor::create(resource.get());
+	acc->writeValue(2, INDEX, 7u);
+	const std::vector<float> positions(3 * 10, 1.0f);
+	acc->writeRange(10, POSITION, 10, positions.data());
+	REQUIRE(resource->consumeDirtyRanges() == std::vector<Range>{{2*16 + 12, 4}, {10*16, 9*16 + 12}});
+
+	// merge ranges with small gaps
+	resource->setDirtyTracking(true, 8);
+	resource->upload(bytes.data(), 4, 0);
+	resource->upload(bytes.data(), 4, 12);
+	resource->upload(bytes.data(), 4, 40);
+	REQUIRE(resource->consumeDirtyRanges() == std::vector<Range>{{0, 16}, {40, 4}});
+
+	resource->setDirtyTracking(false);
+	resource->upload(bytes.data(), 4, 0);
+	REQUIRE(resource->consumeDirtyRanges().empty());
+
+	// uploads to a mapped file and flushing keep the dirty ranges until they are consumed
+	Util::TemporaryDirectory tempDir("ResourceTest");
+	auto file = Util::MappedFileResource::create(Util::FileName(tempDir.getPath().toString() + "dirty.bin"), format, 100);
+	REQUIRE(file);
+	file->setDirtyTracking(true);
+	file->upload(bytes.data(), 16, 32);
+	file->upload(bytes.data(), 8, 1000);
+	REQUIRE(file->hasDirtyRanges());
+	file->flush();
+	REQUIRE(file->getDirtyRanges() == std::vector<Range>{{32, 16}, {1000, 8}});
+	REQUIRE(file->consumeDirtyRanges() == std::vector<Range>{{32, 16}, {1000, 8}});
+	REQUIRE(!file->hasDirtyRanges());
+}
+
+TEST_CASE("ResourceTest_testResourcePool", "[ResourceTest]") {
+	Util::ResourceFormat format;
+	format.appendFloat(POSITION, 4); // 16 bytes
+	Util::ResourceFormat format2;
+	format2.appendUInt(INDEX, 1);
+
+	REQUIRE(Util::ResourcePool::getCapacityBucket(7) == 7);
+	REQUIRE(Util::ResourcePool::getCapacityBucket(100) == 112);
+	REQUIRE(Util::ResourcePool::getCapacityBucket(1024) == 1024);
+	REQUIRE(Util::ResourcePool::getCapacityBucket(1025) == 1280);
+
+	auto pool = Util::ResourcePool::create(1024 * 16);
+	Util::Resource* first = nullptr;
+	{
+		auto resource = pool->acquire(format, 100);
+		REQUIRE(resource->getSize() == 112 * 16);
+		first = resource.get();
+		REQUIRE(pool->countReferences() == 2);
+	}
+	REQUIRE(pool->countReferences() == 1);
+	auto stats = pool->getStatistics();
+	REQUIRE(stats.misses == 1);
+	REQUIRE(stats.hits == 0);
+	REQUIRE(stats.freeCount == 1);
+	REQUIRE(stats.freeBytes == 112 * 16);
+
+	// same bucket -> recycled
+	auto a = pool->acquire(format, 110);
+	REQUIRE(a.get() == first);
+	// different format or bucket -> new resource
+	auto b = pool->acquire(format2, 110);
+	auto c = pool->acquire(format, 200);
+	REQUIRE(b.get() != first);
+	REQUIRE(c.get() != first);
+	stats = pool->getStatistics();
+	REQUIRE(stats.hits == 1);
+	REQUIRE(stats.misses == 3);
+	REQUIRE(stats.freeCount == 0);
+
+	// budget: the least recently released resource is evicted
+	a = nullptr; // 112*16 bytes
+	b = nullptr; // 112*4 bytes
+	c = nullptr; // 224*16 bytes
+	stats = pool->getStatistics();
+	REQUIRE(stats.freeCount == 3);
+	REQUIRE(stats.freeBytes == (112 + 224) * 16 + 112 * 4);
+	pool->setBudget(224 * 16 + 112 * 4);
+	stats = pool->getStatistics();
+	REQUIRE(stats.evictions == 1);
+	REQUIRE(stats.freeCount == 2);
+	pool->acquire(format, 100);
+	REQUIRE(pool->getStatistics().misses == 4);
+
+	// resources that exceed the budget are not kept
+	pool->acquire(format, 2048);
+	REQUIRE(pool->getStatistics().freeBytes <= pool->getBudget());
+
+	pool->trim();
+	stats = pool->getStatistics();
+	REQUIRE(stats.freeCount == 0);
+	REQUIRE(stats.freeBytes == 0);
+
+	// resources in use keep the pool alive
+	auto d = pool->acquire(format, 10);
+	pool = nullptr;
+	d->upload(std::vector<float>(4, 1.0f));
+	d = nullptr;
+
+	// resources of a factory that allocates more elements than requested are recycled as well
+	auto largerPool = Util::ResourcePool::create(1024 * 16, [](const Util::ResourceFormat& f, uint64_t count) -> Util::Reference<Util::Resource> {
+		return new TestResource(f, count + 3);
+	});
+	Util::Resource* larger = largerPool->acquire(format, 100).get();
+	REQUIRE(largerPool->acquire(format, 100).get() == larger);
+	REQUIRE(largerPool->getStatistics().hits == 1);
+}
+
+TEST_CASE("ResourceTest_testView", "[ResourceTest]") {
+	Util::ResourceFormat format;
+	format.appendFloat(POSITION, 3);
+	format.appendUInt(INDEX, 1);
+	Util::Reference<TestResource> resource = new TestResource(format, 100);
+	auto acc = Util::ResourceAccessor::create(resource.get());
+	for(uint32_t i=0; i<100; ++i)
+		acc->writeValue(i, INDEX, i);
+	acc = nullptr;
+
+	auto view = resource->view(10, 20);
+	REQUIRE(view->getElementCount() == 20);
+	REQUIRE(view->getSize() == 20 * format.getSize());
+	REQUIRE(view->map() == resource->map() + 10 * format.getSize());
+	REQUIRE_THROWS_AS(resource->view(90, 11), std::range_error);
+
+	// views share the storage and keep the parent alive
+	Util::Resource* parent = resource.get();
+	resource = nullptr;
+	REQUIRE(parent->countReferences() == 1);
+	auto viewAcc = Util::ResourceAccessor::create(view);
+	REQUIRE(viewAcc->readValue<uint32_t>(0, INDEX) == 10);
+	viewAcc->writeValue(19, INDEX, 1000u);
+	viewAcc = nullptr;
+
+	// views of views refer to the underlying resource
+	auto subView = view->view(5, 15);
+	REQUIRE(dynamic_cast<Util::ResourceView*>(subView.get())->getParent().get() == parent);
+	REQUIRE(dynamic_cast<Util::ResourceView*>(subView.get())->getByteOffset() == 15 * format.getSize());
+	REQUIRE(Util::ResourceAccessor::create(subView)->readValue<uint32_t>(14, INDEX) == 1000);
+
+	// attribute subset with the same stride
+	auto indexView = view->view({INDEX});
+	REQUIRE(indexView->getFormat().getNumAttributes() == 1);
+	REQUIRE(indexView->getFormat().getSize() == format.getSize());
+	REQUIRE(indexView->getFormat().getAttribute(INDEX).getOffset() == format.getAttribute(INDEX).getOffset());
+	REQUIRE(Util::ResourceAccessor::create(indexView)->readValue<uint32_t>(3, INDEX) == 13);
+	REQUIRE_THROWS_AS(view->view({Util::StringIdentifier("missing")}), std::invalid_argument);
+
+	// dirty ranges are tracked by the parent
+	parent->setDirtyTracking(true);
+	Util::ResourceAccessor::create(indexView)->writeValue(1, INDEX, 7u);
+	std::vector<uint8_t> bytes(4, 0);
+	view->upload(bytes.data(), 4, 0);
+	REQUIRE(parent->consumeDirtyRanges() == std::vector<Util::Resource::DirtyRange>{{10 * 16, 4}, {11 * 16 + 12, 4}});
+
+	// released views are empty
+	view->release();
+	REQUIRE(view->getSize() == 0);
+	REQUIRE(view->map() == nullptr);
+	view->upload(bytes.data(), 0, 0);
+	view->download(bytes.data(), 0, 0);
+	view->flush();
+}
@@ -0,0 +1,224 @@
+/*
+	This file is part of the Util library.
+	Copyright (C) 2020 Sascha Brandt <sascha@brandt.graphics>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include <catch2/catch.hpp>
+#include "IO/AbstractFSProvider.h"
+#include "IO/FileName.h"
+#include "IO/FileUtils.h"
+#include "IO/TemporaryDirectory.h"
+#include "Resources/MappedFileResource.h"
+#include "Resources/MemoryResource.h"
+#include "Resources/ResourceAccessor.h"
+#include "Resources/ResourceFormat.h"
+#include "Resources/ResourceUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+static const Util::StringIdentifier POSITION("position");
+static const Util::StringIdentifier COLOR("color");
+
+TEST_CASE("ResourceUtilsTest_testWeld", "[ResourceUtilsTest]") {
+	using namespace Util;
+	ResourceFormat format;
+	format.appendFloat(POSITION, 3);
+	format.appendUInt(COLOR, 1);
+
+	// 200000 elements built from 1000 distinct positions with 2 colors
+	const uint32_t count = 200000;
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<uint32_t> dist(0, 999);
+	Reference<Resource> resource = MemoryResource::create(format, count).get();
+	auto acc = ResourceAccessor::create(resource);
+	std::vector<uint32_t> ids(count);
+	for(uint32_t i=0; i<count; ++i) {
+		ids[i] = dist(rng);
+		const float p[3] = {static_cast<float>(ids[i]), 0.5f, static_cast<float>(ids[i] % 7)};
+		acc->writeValues(i, POSITION, p, 3);
+		acc->writeValue(i, COLOR, i % 2);
+	}
+
+	for(uint32_t threadCount : {1u, 4u}) {
+		auto result = ResourceUtils::weld(resource, {}, 0, threadCount);
+		REQUIRE(result.indices->getElementCount() == count);
+		auto unique = ResourceAccessor::create(result.resource);
+		auto indices = ResourceAccessor::create(result.indices);
+		REQUIRE(unique->getElementCount() <= 2000);
+		std::vector<bool> used(unique->getElementCount(), false);
+		uint32_t maxIndex = 0;
+		for(uint32_t i=0; i<count; ++i) {
+			const uint32_t index = indices->readValue<uint32_t>(i, ResourceUtils::INDEX);
+			// unique elements are ordered by their first occurrence
+			if(!used[index]) {
+				REQUIRE(index == maxIndex);
+				++maxIndex;
+				used[index] = true;
+			}
+			REQUIRE(unique->readValue<float>(index, POSITION) == static_cast<float>(ids[i]));
+			REQUIRE(unique->readValue<uint32_t>(index, COLOR) == i % 2);
+		}
+		REQUIRE(maxIndex == unique->getElementCount());
+	}
+
+	// only compare the positions
+	auto result = ResourceUtils::weld(resource, {POSITION}, 0, 4);
+	auto unique = ResourceAccessor::create(result.resource);
+	REQUIRE(unique->getElementCount() <= 1000);
+	REQUIRE(unique->readValue<uint32_t>(0, COLOR) == 0);
+
+	// fuzzy matching
+	auto noisy = MemoryResource::create(format, 4);
+	acc = ResourceAccessor::create(noisy.get());
+	const float p[4][3] = {{1.0f, 2.0f, 3.0f}, {1.001f, 2.001f, 3.001f}, {1.2f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f}};
+	for(uint32_t i=0; i<4; ++i)
+		acc->writeValues(i, POSITION, p[i], 3);
+	REQUIRE(ResourceUtils::weld(noisy.get(), {POSITION}).resource->getElementCount() == 3);
+	result = ResourceUtils::weld(noisy.get(), {POSITION}, 0.01);
+	REQUIRE(result.resource->getElementCount() == 2);
+	REQUIRE(result.indices->download<uint32_t>(4) == std::vector<uint32_t>{0, 0, 1, 0});
+
+	REQUIRE_THROWS_AS(ResourceUtils::weld(noisy.get(), {StringIdentifier("missing")}), std::invalid_argument);
+
+	// fuzzy matching of attributes with more than 16 components; large values are clamped
+	ResourceFormat wideFormat;
+	wideFormat.appendFloat(POSITION, 20);
+	auto wide = MemoryResource::create(wideFormat, 4);
+	acc = ResourceAccessor::create(wide.get());
+	std::vector<float> values(20, 1.0f);
+	acc->writeValues(0, POSITION, values.data(), 20);
+	values[18] = 5.0f;
+	acc->writeValues(1, POSITION, values.data(), 20);
+	values[18] = 1e30f;
+	acc->writeValues(2, POSITION, values.data(), 20);
+	values[18] = -1e30f;
+	acc->writeValues(3, POSITION, values.data(), 20);
+	REQUIRE(ResourceUtils::weld(wide.get(), {POSITION}).resource->getElementCount() == 4);
+	REQUIRE(ResourceUtils::weld(wide.get(), {POSITION}, 0.01).resource->getElementCount() == 4);
+}
+
+TEST_CASE("ResourceUtilsTest_testSortBySpaceFillingCurve", "[ResourceUtilsTest]") {
+	using namespace Util;
+	ResourceFormat format;
+	format.appendAttribute(POSITION, TypeConstant::UINT16, 3); // any type with an accessor
+	format.appendUInt(COLOR, 1);
+
+	// shuffled 32^3 grid; the color stores the grid cell
+	const uint32_t size = 32;
+	const uint32_t count = size * size * size;
+	std::vector<uint32_t> cells(count);
+	for(uint32_t i=0; i<count; ++i)
+		cells[i] = i;
+	std::shuffle(cells.begin(), cells.end(), std::mt19937(7));
+	Reference<Resource> resource = MemoryResource::create(format, count).get();
+	auto acc = ResourceAccessor::create(resource);
+	for(uint32_t i=0; i<count; ++i) {
+		const uint16_t p[3] = {static_cast<uint16_t>(cells[i] % size), static_cast<uint16_t>((cells[i] / size) % size), static_cast<uint16_t>(cells[i] / (size * size))};
+		acc->writeValues(i, POSITION, p, 3);
+		acc->writeValue(i, COLOR, cells[i]);
+	}
+	acc = nullptr;
+
+	const auto averageStep = [&](const Reference<Resource>& r) {
+		auto acc = ResourceAccessor::create(r);
+		double sum = 0;
+		for(uint32_t i=1; i<count; ++i) {
+			const auto a = acc->readValues<float>(i-1, POSITION, 3);
+			const auto b = acc->readValues<float>(i, POSITION, 3);
+			sum += std::abs(a[0]-b[0]) + std::abs(a[1]-b[1]) + std::abs(a[2]-b[2]);
+			// attributes are moved together
+			REQUIRE(acc->readValue<uint32_t>(i, COLOR) == b[0] + b[1] * size + b[2] * size * size);
+		}
+		return sum / (count - 1);
+	};
+	REQUIRE(averageStep(resource) > 10);
+
+	for(auto curve : {ResourceUtils::SpaceFillingCurve::Morton, ResourceUtils::SpaceFillingCurve::Hilbert}) {
+		Reference<Resource> copy = MemoryResource::create(format, count).get();
+		copy->upload(resource->download<uint8_t>(resource->getSize()));
+		std::vector<uint32_t> permutation;
+		ResourceUtils::sortBySpaceFillingCurve(copy, POSITION, curve, &permutation, 4);
+		REQUIRE(permutation.size() == count);
+		auto acc = ResourceAccessor::create(copy);
+		for(uint32_t i=0; i<count; i += 97)
+			REQUIRE(acc->readValue<uint32_t>(i, COLOR) == cells[permutation[i]]);
+		const double step = averageStep(copy);
+		if(curve == ResourceUtils::SpaceFillingCurve::Hilbert)
+			REQUIRE(step == Approx(1.0)); // consecutive cells of a hilbert curve are adjacent
+		else
+			REQUIRE(step < 2.0);
+	}
+	REQUIRE_THROWS_AS(ResourceUtils::sortBySpaceFillingCurve(resource, StringIdentifier("missing")), std::invalid_argument);
+}
+
+//! In-memory file system without streams and memory mapping.
+class MemoryFSProvider : public Util::AbstractFSProvider {
+public:
+	std::map<std::string, std::vector<uint8_t>> files;
+	status_t readFile(const Util::FileName& name, std::vector<uint8_t>& data) override {
+		auto it = files.find(name.getPath());
+		if(it == files.end())
+			return FAILURE;
+		data = it->second;
+		return OK;
+	}
+	status_t writeFile(const Util::FileName& name, const std::vector<uint8_t>& data, bool) override {
+		files[name.getPath()] = data;
+		return OK;
+	}
+};
+
+TEST_CASE("ResourceUtilsTest_testSaveLoad", "[ResourceUtilsTest]") {
+	using namespace Util;
+	ResourceFormat format(4);
+	format.appendFloat(POSITION, 3);
+	format.appendAttribute(COLOR, TypeConstant::UINT8, 4, true);
+	format.appendAttribute(StringIdentifier("packed"), TypeConstant::UINT32, 1, false, 1234);
+	const uint32_t count = 1000;
+	Reference<Resource> resource = MemoryResource::create(format, count).get();
+	auto acc = ResourceAccessor::create(resource);
+	for(uint32_t i=0; i<count; ++i) {
+		acc->writeValue(i, POSITION, static_cast<float>(i));
+		acc->writeValue(i, COLOR, static_cast<uint8_t>(i));
+	}
+	acc = nullptr;
+	const auto bytes = resource->download<uint8_t>(resource->getSize());
+
+	// local files are mapped
+	TemporaryDirectory tempDir("ResourceUtilsTest");
+	const FileName file(tempDir.getPath().toString() + "resource.bin");
+	REQUIRE(ResourceUtils::saveResource(resource, file));
+	REQUIRE(FileUtils::fileSize(file) == 4096 + resource->getSize());
+	auto loaded = ResourceUtils::loadResource(file);
+	REQUIRE(loaded);
+	REQUIRE(dynamic_cast<MappedFileResource*>(loaded.get()) != nullptr);
+	REQUIRE(loaded->getFormat() == format);
+	REQUIRE(loaded->getFormat().getAttribute(StringIdentifier("packed")).getInternalType() == 1234);
+	REQUIRE(loaded->download<uint8_t>(loaded->getSize()) == bytes);
+	loaded = nullptr;
+
+	// other file systems are copied
+	static MemoryFSProvider memoryFS;
+	FileUtils::registerFSProvider("memtest", [] { return &memoryFS; });
+	const FileName memFile("memtest://resource.bin");
+	REQUIRE(ResourceUtils::saveResource(resource, memFile));
+	loaded = ResourceUtils::loadResource(memFile);
+	REQUIRE(loaded);
+	REQUIRE(dynamic_cast<MemoryResource*>(loaded.get()) != nullptr);
+	REQUIRE(loaded->getFormat() == format);
+	REQUIRE(loaded->download<uint8_t>(loaded->getSize()) == bytes);
+
+	// invalid files
+	memoryFS.files["invalid.bin"] = std::vector<uint8_t>(100, 0);
+	REQUIRE(!ResourceUtils::loadResource(FileName("memtest://invalid.bin")));
+	auto& data = memoryFS.files["resource.bin"];
+	data.resize(data.size() - 1);
+	REQUIRE(!ResourceUtils::loadResource(memFile));
+}